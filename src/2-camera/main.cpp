@@ -219,7 +219,7 @@ int main(int argc, char *argv[]) {
   glDeleteBuffers(1, &ebo);
   glDeleteBuffers(1, &vbo);
   glDeleteVertexArrays(1, &vao);
-  glDeleteProgram(shaderProgram);
+  deleteShaderProgram(shaderProgram);
 
   // Terminating window with OpenGL context and GLFW
   terminateWindow(window);
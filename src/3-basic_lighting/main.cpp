@@ -293,25 +293,25 @@ glm::radians(20.0f), glm::radians(18.0f)})     }
 
     // Updating flashlight SceneObject fields
     gFlashlightSceneObjectPtr->getTranslate() = gCameraController.getCamera()->getPosition();
-    // Getting light component pointers
-    std::vector<std::shared_ptr<Component>> flashlightSceneObjectLightPtrs{
-        gFlashlightSceneObjectPtr->getSpecificComponentPtrs(ComponentType::Light)};
-    // For each light component
-    for (size_t i = 0; i < flashlightSceneObjectLightPtrs.size(); ++i) {
-      dynamic_cast<SpotLight *>(flashlightSceneObjectLightPtrs[i].get())
-          ->setDirection(gCameraController.getCamera()->getForward());
-    }
+    // For each spot light component
+    gFlashlightSceneObjectPtr->forEach<SpotLight>([](SpotLight &spotLight) {
+      spotLight.setDirection(gCameraController.getCamera()->getForward());
+    });
+
+    // Recalculating model matrices of changed scene objects (and their children) at once
+    Scene::getDefaultScene().updateTransforms();
 
     // Updating scene objects shader programs uniform values
     SceneObject::updateShadersLights(sceneObjects, glm::vec3{0.1f, 0.1f, 0.1f});
-    SceneObject::updateShadersCamera(sceneObjects, gCamera);
+    SceneObject::updateShadersCamera(gCamera);
 
     // Enabling Z-testing
     glEnable(GL_DEPTH_TEST);
 
-    // Rendering scene objects
+    // Rendering scene objects skipping the ones outside of camera frustum
+    const FrustumPlanes frustumPlanes{gCamera.calculateFrustumPlanes()};
     for (size_t i = 0; i < sceneObjects.size(); ++i) {
-      sceneObjects[i].render();
+      sceneObjects[i].render(frustumPlanes);
     }
 
     // Swapping front and back buffers
@@ -331,8 +331,8 @@ glm::radians(20.0f), glm::radians(18.0f)})     }
   lightShaderWatcherThread.join();
 
   // Deleting OpenGL objects
-  glDeleteProgram(lightSP);
-  glDeleteProgram(blinnPhongSP);
+  deleteShaderProgram(lightSP);
+  deleteShaderProgram(blinnPhongSP);
 
   // Terminating window with OpenGL context and GLFW
   terminateWindow(window);
@@ -466,13 +466,9 @@ void processUserInput(GLFWwindow *window) {
     if (!sPressed) {
       sPressed = true;
 
-      // Getting light component pointers
-      std::vector<std::shared_ptr<Component>> lightPtrs{
-          gFlashlightSceneObjectPtr->getSpecificComponentPtrs(ComponentType::Light)};
       // For each light component
-      for (size_t i = 0; i < lightPtrs.size(); ++i) {
-        dynamic_cast<BaseLight *>(lightPtrs[i].get())->getColor() *= -1.0f;
-      }
+      gFlashlightSceneObjectPtr->forEach<BaseLight>(
+          [](BaseLight &light) { light.getColor() *= -1.0f; });
     }
   }
 
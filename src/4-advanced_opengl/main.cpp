@@ -739,18 +739,19 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
 
     // Updating flashlight SceneObject fields
     gFlashlightSceneObjectPtr->setTranslate(gCameraController.getCamera()->getPosition());
-    // Getting light component pointers
-    std::vector<std::shared_ptr<Component>> flashlightSceneObjectLightPtrs{
-        gFlashlightSceneObjectPtr->getSpecificComponentPtrs(ComponentType::Light)};
-    // For each light component
-    for (size_t i = 0; i < flashlightSceneObjectLightPtrs.size(); ++i) {
-      dynamic_cast<SpotLight *>(flashlightSceneObjectLightPtrs[i].get())
-          ->setDirection(gCameraController.getCamera()->getForward());
-    }
+    // Moving skybox with camera (before transform update, so it is drawn with this frame's one)
+    skyboxSceneObject.setTranslate(gCameraController.getCamera()->getPosition());
+    // For each spot light component
+    gFlashlightSceneObjectPtr->forEach<SpotLight>([](SpotLight &spotLight) {
+      spotLight.setDirection(gCameraController.getCamera()->getForward());
+    });
+
+    // Recalculating model matrices of changed scene objects (and their children) at once
+    Scene::getDefaultScene().updateTransforms();
 
     // Updating scene objects shader programs uniform values
     SceneObject::updateShadersLights(sceneObjects, glm::vec3{0.1f, 0.1f, 0.1f});
-    SceneObject::updateShadersCamera(sceneObjects, gCamera);
+    SceneObject::updateShadersCamera(gCamera);
 
     // If postprocessing is enabled
     if (gEnablePostprocessing) {
@@ -774,13 +775,14 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
     glStencilMask(0x00);
 
-    // Rendering scene objects
+    // Rendering scene objects skipping the ones outside of camera frustum
+    const FrustumPlanes frustumPlanes{gCamera.calculateFrustumPlanes()};
     for (size_t i = 0; i < sceneObjects.size(); ++i) {
       if (i == kOutlineMeshIndex) {
         glStencilMask(0xff);
       }
 
-      sceneObjects[i].render();
+      sceneObjects[i].render(frustumPlanes);
 
       if (i == kOutlineMeshIndex) {
         glStencilMask(0x00);
@@ -788,32 +790,25 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
     }
 
     // Drawing outline
-    // Getting mesh component pointers
-    SceneObject                            &outlineSceneObject = sceneObjects[kOutlineMeshIndex];
-    std::vector<std::shared_ptr<Component>> outlineMeshPtrs{
-        outlineSceneObject.getSpecificComponentPtrs(ComponentType::Mesh)};
+    SceneObject &outlineSceneObject = sceneObjects[kOutlineMeshIndex];
     // Temporary changing scene object shader programs
     std::vector<GLuint> initShaderPrograms{};
     // For each mesh component
-    for (size_t i = 0; i < outlineMeshPtrs.size(); ++i) {
-      Mesh &outlineMesh = *dynamic_cast<Mesh *>(outlineMeshPtrs[i].get());
-
+    outlineSceneObject.forEach<Mesh>([&](Mesh &outlineMesh) {
       initShaderPrograms.push_back(outlineMesh.getShaderProgram());
       outlineMesh.setShaderProgram(outlineSP);
-    }
+    });
     // Rendering outline meshes
     glStencilFunc(GL_NOTEQUAL, 1, 0xff);
     glStencilMask(0x00);
-    SceneObject::updateShadersCamera(std::vector<SceneObject>{outlineSceneObject}, gCamera);
     outlineSceneObject.render();
     glStencilFunc(GL_ALWAYS, 1, 0xff);
     // Reverting shader program changes
     // For each mesh component
-    for (size_t i = 0; i < outlineMeshPtrs.size(); ++i) {
-      Mesh &outlineMesh = *dynamic_cast<Mesh *>(outlineMeshPtrs[i].get());
-
-      outlineMesh.setShaderProgram(initShaderPrograms[i]);
-    }
+    size_t outlineMeshIndex{};
+    outlineSceneObject.forEach<Mesh>([&](Mesh &outlineMesh) {
+      outlineMesh.setShaderProgram(initShaderPrograms[outlineMeshIndex++]);
+    });
 
     // Rendering normals
     if (gEnableNormals) {
@@ -821,23 +816,15 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
       std::vector<GLuint> initShaderPrograms{};
       // For each scene object
       for (size_t i = 0; i < sceneObjects.size(); ++i) {
-        std::vector<std::shared_ptr<Component>> meshPtrs{
-            const_cast<std::vector<SceneObject> &>(sceneObjects)[i].getSpecificComponentPtrs(
-                ComponentType::Mesh)};
-
         // For each mesh component
-        for (size_t i = 0; i < meshPtrs.size(); ++i) {
-          Mesh &mesh = *dynamic_cast<Mesh *>(meshPtrs[i].get());
-
+        sceneObjects[i].forEach<Mesh>([&](Mesh &mesh) {
           // If mesh is complete
           if (mesh.isComplete()) {
             initShaderPrograms.push_back(mesh.getShaderProgram());
             mesh.setShaderProgram(normalSP);
           }
-        }
+        });
       }
-      // Temporary updating shader camera
-      SceneObject::updateShadersCamera(sceneObjects, gCamera);
 
       // Rendering scene object from camera point of view
       // and reverting shader program changes for each scene object
@@ -846,29 +833,20 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
       for (size_t i = 0; i < sceneObjects.size(); ++i) {
         sceneObjects[i].render();
 
-        // Getting mesh component pointers
-        std::vector<std::shared_ptr<Component>> meshPtrs{
-            const_cast<std::vector<SceneObject> &>(sceneObjects)[i].getSpecificComponentPtrs(
-                ComponentType::Mesh)};
-
         // For each mesh component
-        for (size_t i = 0; i < meshPtrs.size(); ++i) {
-          Mesh &mesh = *dynamic_cast<Mesh *>(meshPtrs[i].get());
-
+        sceneObjects[i].forEach<Mesh>([&](Mesh &mesh) {
           // If mesh is complete
           if (mesh.isComplete()) {
             mesh.setShaderProgram(initShaderProgramsReversed.back());
             initShaderProgramsReversed.pop_back();
           }
-        }
+        });
       }
     }
 
     // Drawing skybox
     glDepthFunc(GL_LEQUAL);
     glCullFace(GL_FRONT);
-    skyboxSceneObject.setTranslate(gCameraController.getCamera()->getPosition());
-    SceneObject::updateShadersCamera(std::vector<SceneObject>{skyboxSceneObject}, gCamera);
     skyboxSceneObject.render();
     glCullFace(GL_BACK);
     glDepthFunc(GL_LESS);
@@ -938,17 +916,17 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
 
   // Deleting OpenGL objects
   glDeleteTextures(1, &proceduralTexture);
-  glDeleteProgram(proceduralTextureSP);
-  glDeleteProgram(silhouetteSmoothingSP);
-  glDeleteProgram(dynamicLODQuadSP);
-  glDeleteProgram(lensSP);
-  glDeleteProgram(mirrorSP);
-  glDeleteProgram(skyboxSP);
-  glDeleteProgram(normalSP);
-  glDeleteProgram(screenSP);
-  glDeleteProgram(outlineSP);
-  glDeleteProgram(lightSP);
-  glDeleteProgram(blinnPhongSP);
+  deleteShaderProgram(proceduralTextureSP);
+  deleteShaderProgram(silhouetteSmoothingSP);
+  deleteShaderProgram(dynamicLODQuadSP);
+  deleteShaderProgram(lensSP);
+  deleteShaderProgram(mirrorSP);
+  deleteShaderProgram(skyboxSP);
+  deleteShaderProgram(normalSP);
+  deleteShaderProgram(screenSP);
+  deleteShaderProgram(outlineSP);
+  deleteShaderProgram(lightSP);
+  deleteShaderProgram(blinnPhongSP);
   glDeleteBuffers(1, &screenEBO);
   glDeleteBuffers(1, &screenVBO);
   glDeleteVertexArrays(1, &screenVAO);
@@ -1110,13 +1088,9 @@ void processUserInput(GLFWwindow *window) {
     if (!sPressed) {
       sPressed = true;
 
-      // Getting light component pointers
-      std::vector<std::shared_ptr<Component>> lightPtrs{
-          gFlashlightSceneObjectPtr->getSpecificComponentPtrs(ComponentType::Light)};
       // For each light component
-      for (size_t i = 0; i < lightPtrs.size(); ++i) {
-        dynamic_cast<BaseLight *>(lightPtrs[i].get())->getColor() *= -1.0f;
-      }
+      gFlashlightSceneObjectPtr->forEach<BaseLight>(
+          [](BaseLight &light) { light.getColor() *= -1.0f; });
     }
   }
 
@@ -1,30 +1,41 @@
 #version 460 core
 
 #define MAX_DIRECTIONAL_LIGHT_COUNT 8
-#define MAX_POINT_LIGHT_COUNT       8
-#define MAX_SPOT_LIGHT_COUNT        8
+#define MAX_SHADOW_CASCADE_COUNT    4
 
 const int kParallaxMappingDepthLayerCountMin = 8;
 const int kParallaxMappingDepthLayerCountMax = 32;
 
-uniform vec3 VIEW_POS;
+layout (std140, binding = 0) uniform FrameData {
+  mat4 VIEW;
+  mat4 PROJ;
+  vec3 VIEW_POS;
+};
 
-uniform vec3 AMBIENT_LIGHT_COLOR;
-uniform struct {
+struct DirectionalLight {
   vec3 color;
+  uint cascadeCount;
 
   vec3 dir;
-} DIRECTIONAL_LIGHTS[MAX_DIRECTIONAL_LIGHT_COUNT];
-uniform struct {
-  vec3 worldPos;
+
+  vec4 cascadeSplits;
+  mat4 VPs[MAX_SHADOW_CASCADE_COUNT];
+  vec4 atlasRects[MAX_SHADOW_CASCADE_COUNT];
+};
+struct PointLight {
+  vec3  worldPos;
+  float range;
 
   vec3 color;
 
   float linAttCoef;
   float quadAttCoef;
-} POINT_LIGHTS[MAX_POINT_LIGHT_COUNT];
-uniform struct {
-  vec3 worldPos;
+
+  float farPlane;
+};
+struct SpotLight {
+  vec3  worldPos;
+  float range;
 
   vec3 color;
 
@@ -35,7 +46,30 @@ uniform struct {
 
   float angle;
   float smoothAngle;
-} SPOT_LIGHTS[MAX_SPOT_LIGHT_COUNT];
+
+  mat4 VP;
+  vec4 atlasRect;
+};
+
+layout (std140, binding = 1) uniform Lights {
+  vec3 AMBIENT_LIGHT_COLOR;
+
+  uint DIRECTIONAL_LIGHT_COUNT;
+  uint POINT_LIGHT_COUNT;
+  uint SPOT_LIGHT_COUNT;
+
+  bool SHADOW_FILTERED;
+  uint SHADOWED_POINT_LIGHT_COUNT;
+
+  DirectionalLight DIRECTIONAL_LIGHTS[MAX_DIRECTIONAL_LIGHT_COUNT];
+};
+
+layout (std430, binding = 0) readonly buffer PointLights {
+  PointLight POINT_LIGHTS[];
+};
+layout (std430, binding = 1) readonly buffer SpotLights {
+  SpotLight SPOT_LIGHTS[];
+};
 
 uniform struct {
   sampler2D   albedoMap;
@@ -238,7 +272,7 @@ void main() {
   vec3 N = normalize(i.TBN * (vec3(texture(MATERIAL.normalMap, texCoords)) * 2.0f - 1.0f));
 
   // Adding each directional light contribution
-  for (uint i = 0; i < MAX_DIRECTIONAL_LIGHT_COUNT; ++i) {
+  for (uint i = 0; i < DIRECTIONAL_LIGHT_COUNT; ++i) {
     vec3 deltaDiffuse  = vec3(0.0f);
     vec3 deltaSpecular = vec3(0.0f);
 
@@ -249,7 +283,7 @@ void main() {
   }
 
   // Adding each point light contribution
-  for (uint i = 0; i < MAX_POINT_LIGHT_COUNT; ++i) {
+  for (uint i = 0; i < POINT_LIGHT_COUNT; ++i) {
     vec3 deltaDiffuse  = vec3(0.0f);
     vec3 deltaSpecular = vec3(0.0f);
 
@@ -260,7 +294,7 @@ void main() {
   }
 
   // Adding each spot light contribution
-  for (uint i = 0; i < MAX_SPOT_LIGHT_COUNT; ++i) {
+  for (uint i = 0; i < SPOT_LIGHT_COUNT; ++i) {
     vec3 deltaDiffuse  = vec3(0.0f);
     vec3 deltaSpecular = vec3(0.0f);
 
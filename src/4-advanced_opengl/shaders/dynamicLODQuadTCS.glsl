@@ -6,7 +6,11 @@ const float kTessLevelMax = 16.0f;
 const float KDistanceMin = 1.0f;
 const float KDistanceMax = 20.0f;
 
-uniform mat4 VIEW;
+layout (std140, binding = 0) uniform FrameData {
+  mat4 VIEW;
+  mat4 PROJ;
+  vec3 VIEW_POS;
+};
 
 in Vertex {
   vec3 normal;
@@ -1,6 +1,10 @@
 #version 460 core
 
-uniform vec3 VIEW_POS;
+layout (std140, binding = 0) uniform FrameData {
+  mat4 VIEW;
+  mat4 PROJ;
+  vec3 VIEW_POS;
+};
 
 uniform struct {
   sampler2D   albedoMap;
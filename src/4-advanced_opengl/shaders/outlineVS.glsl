@@ -1,8 +1,12 @@
 #version 460 core
 
+layout (std140, binding = 0) uniform FrameData {
+  mat4 VIEW;
+  mat4 PROJ;
+  vec3 VIEW_POS;
+};
+
 uniform mat4 MODEL;
-uniform mat4 VIEW;
-uniform mat4 PROJ;
 
 layout (location = 0) in vec3 aPos;
 
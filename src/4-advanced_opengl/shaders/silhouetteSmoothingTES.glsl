@@ -2,10 +2,11 @@
 
 const float kSilhouetteSmoothingCoef = 0.5f;
 
-uniform vec3 VIEW_POS;
-
-uniform mat4 VIEW;
-uniform mat4 PROJ;
+layout (std140, binding = 0) uniform FrameData {
+  mat4 VIEW;
+  mat4 PROJ;
+  vec3 VIEW_POS;
+};
 
 uniform struct {
   sampler2D   albedoMap;
@@ -1,11 +1,10 @@
 // STD
-#include <atomic>
+#include <array>
 #include <chrono>
 #include <cstdlib>
 #include <iostream>
 #include <cmath>
 #include <ctime>
-#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -46,6 +45,23 @@ static constexpr unsigned int          kInstanceCount       = 100;
 static constexpr float                 kInstanceMaxDistance = 15.0f;
 static constexpr float                 kInstanceMaxScale    = 5.0f;
 static constexpr float                 kExposure            = 0.2f;
+static constexpr float                 kStatisticsInterval  = 1.0f;
+
+// Render queue passes
+static constexpr unsigned int kScenePass    = 0;
+static constexpr unsigned int kOutlinedPass = 1;
+static constexpr unsigned int kOutlinePass  = 2;
+static constexpr unsigned int kNormalsPass  = 3;
+static constexpr unsigned int kGBufferPass  = 4;
+
+static constexpr std::array<const char *, 5> kRenderPassNames{"scene", "outlined", "outline",
+                                                              "normals", "gbuffer"};
+
+// Uniform handles
+static const UniformHandle kOutputTextureUniform = registerUniform("outputTexture");
+static const UniformHandle kTimeUniform          = registerUniform("time");
+static const UniformHandle kExposureUniform      = registerUniform("EXPOSURE");
+static const UniformHandle kTexture0Uniform      = registerUniform("texture0");
 
 // Global variables
 unsigned int      gWidth{kInitWidth};
@@ -59,12 +75,21 @@ int               gPolygonMode{};
 bool              gEnableSceneObjectsFloating{true};
 bool              gEnablePostprocessing{true};
 bool              gEnableNormals{false};
+bool              gEnableStatistics{false};
+bool              gEnableFilteredShadows{false};
+bool              gEnableLightClustering{true};
+bool              gEnableDeferredShading{false};
 GLuint            gPostprocessingFBO{};
 GLuint            gPostprocessingTexture{};
 GLuint            gPostprocessingRBO{};
 GLuint            gMultisamplingFBO{};
 GLuint            gMultisamplingTexture{};
 GLuint            gMultisamplingRBO{};
+GLuint            gGBufferFBO{};
+GLuint            gGBufferAlbedoTexture{};
+GLuint            gGBufferNormalTexture{};
+GLuint            gGBufferEmissionTexture{};
+GLuint            gGBufferDepthTexture{};
 
 // GLFW callbacks
 void framebufferSizeCallback(GLFWwindow *window, int width, int height);
@@ -76,7 +101,11 @@ void processUserInput(GLFWwindow *window);
 
 // Makes scene objects float
 void floatSceneObjects(std::vector<SceneObject> &sceneObjects, unsigned int startIndex,
-                       unsigned int count);
+                       unsigned int count, JobSystem &jobSystem);
+
+// Prints renderer statistics of the last frame once in a while and resets them
+void printStatistics(const RenderQueue &renderQueue, const TextureLoader &textureLoader,
+                     const JobSystem &jobSystem);
 
 // Main function
 int main(int argc, char *argv[]) {
@@ -168,6 +197,62 @@ int main(int argc, char *argv[]) {
   glBindRenderbuffer(GL_RENDERBUFFER, 0);
   glBindTexture(GL_TEXTURE_2D_MULTISAMPLE, 0);
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  // Creating and binding geometry buffer framebuffer (deferred shading)
+  glGenFramebuffers(1, &gGBufferFBO);
+  glBindFramebuffer(GL_FRAMEBUFFER, gGBufferFBO);
+  // Creating and binding albedo (and ambient occlusion), normal (and gloss) and emission textures
+  // to geometry buffer framebuffer
+  glGenTextures(1, &gGBufferAlbedoTexture);
+  glBindTexture(GL_TEXTURE_2D, gGBufferAlbedoTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, gWidth, gHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+                         gGBufferAlbedoTexture, 0);
+  glGenTextures(1, &gGBufferNormalTexture);
+  glBindTexture(GL_TEXTURE_2D, gGBufferNormalTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, gWidth, gHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D,
+                         gGBufferNormalTexture, 0);
+  glGenTextures(1, &gGBufferEmissionTexture);
+  glBindTexture(GL_TEXTURE_2D, gGBufferEmissionTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, gWidth, gHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, GL_TEXTURE_2D,
+                         gGBufferEmissionTexture, 0);
+  const GLenum gBufferDrawBuffers[] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1,
+                                       GL_COLOR_ATTACHMENT2};
+  glDrawBuffers(3, &gBufferDrawBuffers[0]);
+  // Creating and binding depth texture to geometry buffer framebuffer (it is sampled to
+  // reconstruct world positions, so it is not a renderbuffer; its format matches
+  // postprocessing renderbuffer, so depth and stencil can be blitted there)
+  glGenTextures(1, &gGBufferDepthTexture);
+  glBindTexture(GL_TEXTURE_2D, gGBufferDepthTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, gWidth, gHeight, 0, GL_DEPTH_STENCIL,
+               GL_UNSIGNED_INT_24_8, nullptr);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D,
+                         gGBufferDepthTexture, 0);
+  // Checking if geometry buffer framebuffer is complete and unbinding it
+  if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &gGBufferFBO);
+    glDeleteTextures(1, &gGBufferAlbedoTexture);
+    glDeleteTextures(1, &gGBufferNormalTexture);
+    glDeleteTextures(1, &gGBufferEmissionTexture);
+    glDeleteTextures(1, &gGBufferDepthTexture);
+
+    std::cout << "Geometry buffer framebuffer object is incomplete!" << std::endl;
+
+    return -1;
+  }
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
   // Creating vectors of vectors of types of shaders
   std::vector<std::vector<GLuint>> shaderTypes{
@@ -188,6 +273,14 @@ int main(int argc, char *argv[]) {
       getAbsolutePathRelativeToExecutable("shaders/blinnPhongVS.glsl"),
       getAbsolutePathRelativeToExecutable("shaders/blinnPhongFS.glsl"),
   };
+  std::vector<std::string> gBufferShaderFilenames{
+      getAbsolutePathRelativeToExecutable("shaders/blinnPhongVS.glsl"),
+      getAbsolutePathRelativeToExecutable("shaders/gBufferFS.glsl"),
+  };
+  std::vector<std::string> deferredLightingShaderFilenames{
+      getAbsolutePathRelativeToExecutable("shaders/screenVS.glsl"),
+      getAbsolutePathRelativeToExecutable("shaders/deferredLightingFS.glsl"),
+  };
   std::vector<std::string> lightShaderFilenames{
       getAbsolutePathRelativeToExecutable("shaders/lightVS.glsl"),
       getAbsolutePathRelativeToExecutable("shaders/lightFS.glsl"),
@@ -241,6 +334,16 @@ int main(int argc, char *argv[]) {
       getAbsolutePathRelativeToExecutable("shaders/shadowMapCubeGS.glsl"),
       getAbsolutePathRelativeToExecutable("shaders/shadowMapCubeFS.glsl"),
   };
+  std::vector<std::string> shadowMapFilterShaderFilenames{
+      getAbsolutePathRelativeToExecutable("shaders/shadowMapFilterCS.glsl"),
+  };
+  std::vector<std::string> lightClusteringShaderFilenames{
+      getAbsolutePathRelativeToExecutable("shaders/lightClusteringCS.glsl"),
+  };
+  std::vector<std::string> shadowMapCubeLayeredShaderFilenames{
+      getAbsolutePathRelativeToExecutable("shaders/shadowMapCubeLayeredVS.glsl"),
+      getAbsolutePathRelativeToExecutable("shaders/shadowMapCubeFS.glsl"),
+  };
   // Creating shader programs
   GLuint blinnPhongSP          = glCreateProgram();
   GLuint lightSP               = glCreateProgram();
@@ -255,141 +358,47 @@ int main(int argc, char *argv[]) {
   GLuint proceduralTextureSP   = glCreateProgram();
   GLuint shadowMap2DSP         = glCreateProgram();
   GLuint shadowMapCubeSP       = glCreateProgram();
-  // Running shaderWatcher threads
-  std::mutex        glfwContextMutex{};
-  glfwContextMutex.lock();
-  std::atomic<bool> blinnPhongShaderWatcherIsRunning = true;
-  std::atomic<bool> blinnPhongShadersAreRecompiled   = false;
-  std::thread       blinnPhongShaderWatcherThread{shaderWatcher,
-                                            std::cref(blinnPhongShaderWatcherIsRunning),
-                                            std::ref(blinnPhongShadersAreRecompiled),
-                                            window,
-                                            std::ref(glfwContextMutex),
-                                            blinnPhongSP,
-                                            std::cref(shaderTypes[0]),
-                                            std::cref(blinnPhongShaderFilenames)};
-  std::atomic<bool> lightShaderWatcherIsRunning = true;
-  std::atomic<bool> lightShadersAreRecompiled   = false;
-  std::thread       lightShaderWatcherThread{shaderWatcher,
-                                       std::cref(lightShaderWatcherIsRunning),
-                                       std::ref(lightShadersAreRecompiled),
-                                       window,
-                                       std::ref(glfwContextMutex),
-                                       lightSP,
-                                       std::cref(shaderTypes[0]),
-                                       std::cref(lightShaderFilenames)};
-  std::atomic<bool> outlineShaderWatcherIsRunning = true;
-  std::atomic<bool> outlineShadersAreRecompiled   = false;
-  std::thread       outlineShaderWatcherThread{shaderWatcher,
-                                         std::cref(outlineShaderWatcherIsRunning),
-                                         std::ref(outlineShadersAreRecompiled),
-                                         window,
-                                         std::ref(glfwContextMutex),
-                                         outlineSP,
-                                         std::cref(shaderTypes[0]),
-                                         std::cref(outlineShaderFilenames)};
-  std::atomic<bool> screenShaderWatcherIsRunning = true;
-  std::atomic<bool> screenShadersAreRecompiled   = false;
-  std::thread       screenShaderWatcherThread{shaderWatcher,
-                                        std::cref(screenShaderWatcherIsRunning),
-                                        std::ref(screenShadersAreRecompiled),
-                                        window,
-                                        std::ref(glfwContextMutex),
-                                        screenSP,
-                                        std::cref(shaderTypes[0]),
-                                        std::cref(screenShaderFilenames)};
-  std::atomic<bool> normalShaderWatcherIsRunning = true;
-  std::atomic<bool> normalShadersAreRecompiled   = false;
-  std::thread       normalShaderWatcherThread{shaderWatcher,
-                                        std::cref(normalShaderWatcherIsRunning),
-                                        std::ref(normalShadersAreRecompiled),
-                                        window,
-                                        std::ref(glfwContextMutex),
-                                        normalSP,
-                                        std::cref(shaderTypes[1]),
-                                        std::cref(normalShaderFilenames)};
-  std::atomic<bool> skyboxShaderWatcherIsRunning = true;
-  std::atomic<bool> skyboxShadersAreRecompiled   = false;
-  std::thread       skyboxShaderWatcherThread{shaderWatcher,
-                                        std::cref(skyboxShaderWatcherIsRunning),
-                                        std::ref(skyboxShadersAreRecompiled),
-                                        window,
-                                        std::ref(glfwContextMutex),
-                                        skyboxSP,
-                                        std::cref(shaderTypes[0]),
-                                        std::cref(skyboxShaderFilenames)};
-  std::atomic<bool> mirrorShaderWatcherIsRunning = true;
-  std::atomic<bool> mirrorShadersAreRecompiled   = false;
-  std::thread       mirrorShaderWatcherThread{shaderWatcher,
-                                        std::cref(mirrorShaderWatcherIsRunning),
-                                        std::ref(mirrorShadersAreRecompiled),
-                                        window,
-                                        std::ref(glfwContextMutex),
-                                        mirrorSP,
-                                        std::cref(shaderTypes[0]),
-                                        std::cref(mirrorShaderFilenames)};
-  std::atomic<bool> lensShaderWatcherIsRunning = true;
-  std::atomic<bool> lensShadersAreRecompiled   = false;
-  std::thread       lensShaderWatcherThread{shaderWatcher,
-                                      std::cref(lensShaderWatcherIsRunning),
-                                      std::ref(lensShadersAreRecompiled),
-                                      window,
-                                      std::ref(glfwContextMutex),
-                                      lensSP,
-                                      std::cref(shaderTypes[0]),
-                                      std::cref(lensShaderFilenames)};
-  std::atomic<bool> dynamicLODQuadShaderWatcherIsRunning = true;
-  std::atomic<bool> dynamicLODQuadShadersAreRecompiled   = false;
-  std::thread       dynamicLODQuadShaderWatcherThread{shaderWatcher,
-                                                std::cref(dynamicLODQuadShaderWatcherIsRunning),
-                                                std::ref(dynamicLODQuadShadersAreRecompiled),
-                                                window,
-                                                std::ref(glfwContextMutex),
-                                                dynamicLODQuadSP,
-                                                std::cref(shaderTypes[2]),
-                                                std::cref(dynamicLODQuadShaderFilenames)};
-  std::atomic<bool> silhouetteSmoothingShaderWatcherIsRunning = true;
-  std::atomic<bool> silhouetteSmoothingShadersAreRecompiled   = false;
-  std::thread       silhouetteSmoothingShaderWatcherThread{
-      shaderWatcher,
-      std::cref(silhouetteSmoothingShaderWatcherIsRunning),
-      std::ref(silhouetteSmoothingShadersAreRecompiled),
-      window,
-      std::ref(glfwContextMutex),
-      silhouetteSmoothingSP,
-      std::cref(shaderTypes[2]),
-      std::cref(silhouetteSmoothingShaderFilenames)};
-  std::atomic<bool> proceduralTextureShaderWatcherIsRunning = true;
-  std::atomic<bool> proceduralTextureShadersAreRecompiled   = false;
-  std::thread       proceduralTextureShaderWatcherThread{
-      shaderWatcher,
-      std::cref(proceduralTextureShaderWatcherIsRunning),
-      std::ref(proceduralTextureShadersAreRecompiled),
-      window,
-      std::ref(glfwContextMutex),
-      proceduralTextureSP,
-      std::cref(shaderTypes[3]),
-      std::cref(proceduralTextureShaderFilenames)};
-  std::atomic<bool> shadowMap2DShaderWatcherIsRunning = true;
-  std::atomic<bool> shadowMap2DShadersAreRecompiled   = false;
-  std::thread       shadowMap2DShaderWatcherThread{shaderWatcher,
-                                             std::cref(shadowMap2DShaderWatcherIsRunning),
-                                             std::ref(shadowMap2DShadersAreRecompiled),
-                                             window,
-                                             std::ref(glfwContextMutex),
-                                             shadowMap2DSP,
-                                             std::cref(shaderTypes[0]),
-                                             std::cref(shadowMap2DShaderFilenames)};
-  std::atomic<bool> shadowMapCubeShaderWatcherIsRunning = true;
-  std::atomic<bool> shadowMapCubeShadersAreRecompiled   = false;
-  std::thread       shadowMapCubeShaderWatcherThread{shaderWatcher,
-                                               std::cref(shadowMapCubeShaderWatcherIsRunning),
-                                               std::ref(shadowMapCubeShadersAreRecompiled),
-                                               window,
-                                               std::ref(glfwContextMutex),
-                                               shadowMapCubeSP,
-                                               std::cref(shaderTypes[1]),
-                                               std::cref(shadowMapCubeShaderFilenames)};
+  GLuint shadowMapFilterSP     = glCreateProgram();
+  GLuint lightClusteringSP     = glCreateProgram();
+  GLuint gBufferSP             = glCreateProgram();
+  GLuint deferredLightingSP    = glCreateProgram();
+
+  // Watching shader files of all the shader programs by a single service
+  ShaderWatcher shaderWatcherService{};
+  shaderWatcherService.addShaderProgram(blinnPhongSP, shaderTypes[0], blinnPhongShaderFilenames);
+  shaderWatcherService.addShaderProgram(lightSP, shaderTypes[0], lightShaderFilenames);
+  shaderWatcherService.addShaderProgram(outlineSP, shaderTypes[0], outlineShaderFilenames);
+  shaderWatcherService.addShaderProgram(screenSP, shaderTypes[0], screenShaderFilenames);
+  shaderWatcherService.addShaderProgram(normalSP, shaderTypes[1], normalShaderFilenames);
+  shaderWatcherService.addShaderProgram(skyboxSP, shaderTypes[0], skyboxShaderFilenames);
+  shaderWatcherService.addShaderProgram(mirrorSP, shaderTypes[0], mirrorShaderFilenames);
+  shaderWatcherService.addShaderProgram(lensSP, shaderTypes[0], lensShaderFilenames);
+  shaderWatcherService.addShaderProgram(dynamicLODQuadSP, shaderTypes[2],
+                                        dynamicLODQuadShaderFilenames);
+  shaderWatcherService.addShaderProgram(silhouetteSmoothingSP, shaderTypes[2],
+                                        silhouetteSmoothingShaderFilenames);
+  shaderWatcherService.addShaderProgram(proceduralTextureSP, shaderTypes[3],
+                                        proceduralTextureShaderFilenames);
+  shaderWatcherService.addShaderProgram(shadowMap2DSP, shaderTypes[0], shadowMap2DShaderFilenames);
+  shaderWatcherService.addShaderProgram(shadowMapFilterSP, shaderTypes[3],
+                                        shadowMapFilterShaderFilenames);
+  shaderWatcherService.addShaderProgram(lightClusteringSP, shaderTypes[3],
+                                        lightClusteringShaderFilenames);
+  shaderWatcherService.addShaderProgram(gBufferSP, shaderTypes[0], gBufferShaderFilenames);
+  shaderWatcherService.addShaderProgram(deferredLightingSP, shaderTypes[0],
+                                        deferredLightingShaderFilenames);
+  // Rendering point light shadow cube map faces one by one with per-face caster culling
+  // if vertex shader can select layer, amplifying triangles by geometry shader otherwise
+  if (glfwExtensionSupported("GL_ARB_shader_viewport_layer_array") == GLFW_TRUE) {
+    shaderWatcherService.addShaderProgram(shadowMapCubeSP, shaderTypes[0],
+                                          shadowMapCubeLayeredShaderFilenames);
+  } else {
+    shaderWatcherService.addShaderProgram(shadowMapCubeSP, shaderTypes[1],
+                                          shadowMapCubeShaderFilenames);
+  }
+  // Compiling shader programs for the first time and starting watching
+  shaderWatcherService.processPendingRecompiles();
+  shaderWatcherService.start();
 
   // Creating texture for procedural generation by compute shader
   constexpr GLsizei kProceduralTextureSize[2]      = {1024, 1024};
@@ -401,25 +410,26 @@ int main(int argc, char *argv[]) {
   glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, kProceduralTextureSize[0], kProceduralTextureSize[1]);
   glBindTexture(GL_TEXTURE_2D, 0);
 
-  // Loading textures
+  // Loading textures (fallback textures synchronously, material textures asynchronously)
   gTextureBlack = loadMap2D("resources/black.png", false);
   gTextureWhite = loadMap2D("resources/white.png", false);
+  TextureLoader textureLoader{};
   std::vector<std::vector<std::shared_ptr<Mesh::Material::Texture>>> texturePtrVectors{
       std::vector<std::shared_ptr<Mesh::Material::Texture>>{ },
       std::vector<std::shared_ptr<Mesh::Material::Texture>>{
-                                                            std::make_shared<Mesh::Material::Texture>(loadMap2D("resources/albedoMap.png", true), 0,
+                                                            std::make_shared<Mesh::Material::Texture>(textureLoader.loadMap2D("resources/albedoMap.png", true), 0,
                                                             false),
-                                                            std::make_shared<Mesh::Material::Texture>(loadMap2D("resources/normalMap.png", false), 1,
+                                                            std::make_shared<Mesh::Material::Texture>(textureLoader.loadMap2D("resources/normalMap.png", false, glm::vec4{0.5f, 0.5f, 1.0f, 1.0f}), 1,
                                                             false),
-                                                            std::make_shared<Mesh::Material::Texture>(loadMap2D("resources/depthMap.png", false), 2,
+                                                            std::make_shared<Mesh::Material::Texture>(textureLoader.loadMap2D("resources/depthMap.png", false, glm::vec4{0.0f, 0.0f, 0.0f, 1.0f}), 2,
                                                             false),
                                                             std::make_shared<Mesh::Material::Texture>(
-              loadMap2D("resources/ambientOcclusionMap.png", false), 3, false),
-                                                            std::make_shared<Mesh::Material::Texture>(loadMap2DHDR("resources/glossinessMap.hdr"), 4,
+              textureLoader.loadMap2D("resources/ambientOcclusionMap.png", false, glm::vec4{1.0f}), 3, false),
+                                                            std::make_shared<Mesh::Material::Texture>(textureLoader.loadMap2DHDR("resources/glossinessMap.hdr"), 4,
                                                             false),
                                                             //std::make_shared<Mesh::Material::Texture>(loadMap2D("resources/emissionMap.png", true), 5, false),
           std::make_shared<Mesh::Material::Texture>(proceduralTexture, 5, false),
-                                                            std::make_shared<Mesh::Material::Texture>(loadMapCube(
+                                                            std::make_shared<Mesh::Material::Texture>(textureLoader.loadMapCube(
                                                         std::vector<std::string>{
                                                             "resources/skyboxXP.png",
                                                             "resources/skyboxXN.png",
@@ -431,7 +441,7 @@ int main(int argc, char *argv[]) {
                                                             6, true),
                                                             },
       std::vector<std::shared_ptr<Mesh::Material::Texture>>{
-                                                            std::make_shared<Mesh::Material::Texture>(loadMap2D("resources/skybox.png", true), 0,
+                                                            std::make_shared<Mesh::Material::Texture>(textureLoader.loadMap2D("resources/skybox.png", true), 0,
                                                             false),
                                                             },
   };
@@ -709,10 +719,6 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
   glEnable(GL_PROGRAM_POINT_SIZE);
   glPointSize(10.0f);
 
-  // Releasing OpenGL context
-  glfwMakeContextCurrent(nullptr);
-  glfwContextMutex.unlock();
-
   // Configuring camera and cameraControllers
   gCamera.setPosition(glm::vec3{0.0f, 1.0f, 2.0f});
   gCamera.setWorldUp(glm::vec3{0.0f, 1.0f, 0.0f});
@@ -728,21 +734,44 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
     camera5DoFControllerPtr->setAngleLimits(0.0f, 0.0f, glm::radians(-85.0f), glm::radians(85.0f));
   }
 
+  // Creating render queue
+  RenderQueue renderQueue{};
+
+  // Creating job system and frame update job graph (scene objects floating and flashlight
+  // updating are independent, while transforms are updated once both of them are done;
+  // OpenGL calls stay on this thread)
+  JobSystem    jobSystem{};
+  JobGraph     frameUpdateGraph{};
+  const size_t floatingJob = frameUpdateGraph.addJob([&]() {
+    // Making scene objects float
+    if (gEnableSceneObjectsFloating) {
+      floatSceneObjects(sceneObjects, 0, sceneObjects.size() - 1, jobSystem);
+    }
+  });
+  const size_t flashlightJob = frameUpdateGraph.addJob([&]() {
+    // Updating flashlight SceneObject fields
+    gFlashlightSceneObjectPtr->setTranslate(gCameraController.getCamera()->getPosition());
+    // Moving skybox with camera (before transform update, so it is drawn with this frame's one)
+    skyboxSceneObject.setTranslate(gCameraController.getCamera()->getPosition());
+    // For each spot light component
+    gFlashlightSceneObjectPtr->forEach<SpotLight>([](SpotLight &spotLight) {
+      spotLight.setDirection(gCameraController.getCamera()->getForward());
+    });
+  });
+  const size_t transformsJob = frameUpdateGraph.addJob([&]() {
+    // Recalculating model matrices of changed scene objects (and their children) at once
+    Scene::getDefaultScene().updateTransforms(&jobSystem);
+  });
+  frameUpdateGraph.addDependency(transformsJob, floatingJob);
+  frameUpdateGraph.addDependency(transformsJob, flashlightJob);
+
   // Starting clock
   gCurrTime = static_cast<float>(glfwGetTime());
 
   // Render cycle
   while (true) {
-    // Capturing mutex and OpenGL context
-    std::unique_lock glfwContextLock{glfwContextMutex};
-    glfwMakeContextCurrent(window);
-
     // If window should close
     if (glfwWindowShouldClose(window)) {
-      // Releasing OpenGL context and mutex
-      glfwMakeContextCurrent(nullptr);
-      glfwContextLock.unlock();
-
       // Breaking render cycle
       break;
     }
@@ -758,10 +787,16 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
     // Processing user input
     processUserInput(window);
 
+    // Recompiling shader programs whose files were modified
+    shaderWatcherService.processPendingRecompiles();
+
+    // Uploading textures decoded by texture loader
+    textureLoader.processUploads();
+
     // Executing compute shader
     glUseProgram(proceduralTextureSP);
-    glUniform1i(glGetUniformLocation(proceduralTextureSP, "outputTexture"), 0);
-    glUniform1f(glGetUniformLocation(proceduralTextureSP, "time"), glfwGetTime());
+    glUniform1i(getUniformLocation(proceduralTextureSP, kOutputTextureUniform), 0);
+    glUniform1f(getUniformLocation(proceduralTextureSP, kTimeUniform), glfwGetTime());
     glBindImageTexture(0, proceduralTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA8);
     glDispatchCompute(kProceduralTextureSize[0] / kComputeShaderWorkGroupSize[0],
                       kProceduralTextureSize[1] / kComputeShaderWorkGroupSize[1], 1);
@@ -770,29 +805,23 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
     // Making sure writing to the texture has finished
     glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
 
-    // Making scene objects float
-    if (gEnableSceneObjectsFloating) {
-      floatSceneObjects(sceneObjects, 0, sceneObjects.size() - 1);
-    }
-
-    // Updating flashlight SceneObject fields
-    gFlashlightSceneObjectPtr->setTranslate(gCameraController.getCamera()->getPosition());
-    // Getting light component pointers
-    std::vector<std::shared_ptr<Component>> flashlightSceneObjectLightPtrs{
-        gFlashlightSceneObjectPtr->getSpecificComponentPtrs(ComponentType::Light)};
-    // For each light component
-    for (size_t i = 0; i < flashlightSceneObjectLightPtrs.size(); ++i) {
-      dynamic_cast<SpotLight *>(flashlightSceneObjectLightPtrs[i].get())
-          ->setDirection(gCameraController.getCamera()->getForward());
-    }
+    // Updating scene objects and their transforms in parallel
+    frameUpdateGraph.run(jobSystem);
 
     // Updating scene objects shader programs uniform values
     SceneObject::updateShadersLights(sceneObjects, glm::vec3{0.1f, 0.1f, 0.1f}, shadowMap2DSP,
-                                     shadowMapCubeSP, shadowMap2DSP, gCamera);
-    SceneObject::updateShadersCamera(sceneObjects, gCamera);
-
+                                     shadowMapCubeSP, shadowMap2DSP, gCamera,
+                                     gEnableFilteredShadows ? shadowMapFilterSP : 0,
+                                     gEnableLightClustering ? lightClusteringSP : 0);
+    SceneObject::updateShadersCamera(gCamera);
+
+    // If shading is deferred
+    if (gEnableDeferredShading) {
+      // Binding geometry buffer framebuffer
+      glBindFramebuffer(GL_FRAMEBUFFER, gGBufferFBO);
+    }
     // If postprocessing is enabled
-    if (gEnablePostprocessing) {
+    else if (gEnablePostprocessing) {
       // Binding multisampling framebuffer
       glBindFramebuffer(GL_FRAMEBUFFER, gMultisamplingFBO);
     }
@@ -813,114 +842,92 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
     glStencilMask(0x00);
 
-    // Rendering scene objects
-    for (size_t i = 0; i < sceneObjects.size(); ++i) {
-      if (i == kOutlineMeshIndex) {
-        glStencilMask(0xff);
-      }
+    // Collecting draw items of scene objects
+    renderQueue.clear();
+    renderQueue.push(sceneObjects, kScenePass, gCamera, 0, &jobSystem);
+    renderQueue.moveToPass(sceneObjects[kOutlineMeshIndex], kScenePass, kOutlinedPass);
+    renderQueue.push(sceneObjects[kOutlineMeshIndex], kOutlinePass, gCamera, outlineSP);
+    if (gEnableNormals) {
+      renderQueue.push(sceneObjects, kNormalsPass, gCamera, normalSP, &jobSystem);
+    }
 
-      sceneObjects[i].render(kExposure);
+    // If shading is deferred
+    if (gEnableDeferredShading) {
+      // Moving Blinn-Phong meshes to geometry buffer pass (the rest stay forward)
+      renderQueue.moveToPass(kScenePass, blinnPhongSP, kGBufferPass, gBufferSP);
 
-      if (i == kOutlineMeshIndex) {
-        glStencilMask(0x00);
-      }
+      // Writing surface attributes of meshes into geometry buffer (without blending,
+      // since alpha channels keep attributes)
+      glDisable(GL_BLEND);
+      renderQueue.submit(kGBufferPass, kExposure);
+      glEnable(GL_BLEND);
+
+      // Copying depth and stencil to postprocessing framebuffer, so forward passes are
+      // tested against meshes of geometry buffer
+      glBindFramebuffer(GL_READ_FRAMEBUFFER, gGBufferFBO);
+      glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gPostprocessingFBO);
+      glBlitFramebuffer(0, 0, gWidth, gHeight, 0, 0, gWidth, gHeight,
+                        GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT, GL_NEAREST);
+      glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+      // Binding postprocessing framebuffer and clearing its color buffer
+      glBindFramebuffer(GL_FRAMEBUFFER, gPostprocessingFBO);
+      glClear(GL_COLOR_BUFFER_BIT);
+
+      // Lighting every pixel of geometry buffer once (lighting cost depends on resolution only)
+      glDisable(GL_DEPTH_TEST);
+      glDisable(GL_BLEND);
+      glBindVertexArray(screenVAO);
+      glActiveTexture(GL_TEXTURE0);
+      glBindTexture(GL_TEXTURE_2D, gGBufferAlbedoTexture);
+      glActiveTexture(GL_TEXTURE1);
+      glBindTexture(GL_TEXTURE_2D, gGBufferNormalTexture);
+      glActiveTexture(GL_TEXTURE2);
+      glBindTexture(GL_TEXTURE_2D, gGBufferEmissionTexture);
+      glActiveTexture(GL_TEXTURE3);
+      glBindTexture(GL_TEXTURE_2D, gGBufferDepthTexture);
+      glUseProgram(deferredLightingSP);
+      glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+      glUseProgram(0);
+      glBindVertexArray(0);
+      glEnable(GL_BLEND);
+      glEnable(GL_DEPTH_TEST);
     }
 
+    // Rendering scene objects (the ones not in geometry buffer if shading is deferred)
+    renderQueue.submit(kScenePass, kExposure);
+
+    // Rendering outlined scene object with stencil writing
+    glStencilMask(0xff);
+    renderQueue.submit(kOutlinedPass, kExposure);
+    glStencilMask(0x00);
+
     // Drawing outline
-    // Getting mesh component pointers
-    SceneObject                            &outlineSceneObject = sceneObjects[kOutlineMeshIndex];
-    std::vector<std::shared_ptr<Component>> outlineMeshPtrs{
-        outlineSceneObject.getSpecificComponentPtrs(ComponentType::Mesh)};
-    // Temporary changing scene object shader programs
-    std::vector<GLuint> initShaderPrograms{};
-    // For each mesh component
-    for (size_t i = 0; i < outlineMeshPtrs.size(); ++i) {
-      Mesh &outlineMesh = *dynamic_cast<Mesh *>(outlineMeshPtrs[i].get());
-
-      initShaderPrograms.push_back(outlineMesh.getShaderProgram());
-      outlineMesh.setShaderProgram(outlineSP);
-    }
-    // Rendering outline meshes
     glStencilFunc(GL_NOTEQUAL, 1, 0xff);
-    glStencilMask(0x00);
-    SceneObject::updateShadersCamera(std::vector<SceneObject>{outlineSceneObject}, gCamera);
-    outlineSceneObject.render(kExposure);
+    renderQueue.submit(kOutlinePass, kExposure);
     glStencilFunc(GL_ALWAYS, 1, 0xff);
-    // Reverting shader program changes
-    // For each mesh component
-    for (size_t i = 0; i < outlineMeshPtrs.size(); ++i) {
-      Mesh &outlineMesh = *dynamic_cast<Mesh *>(outlineMeshPtrs[i].get());
-
-      outlineMesh.setShaderProgram(initShaderPrograms[i]);
-    }
 
     // Rendering normals
-    if (gEnableNormals) {
-      // Temporary changing scene object shader programs
-      std::vector<GLuint> initShaderPrograms{};
-      // For each scene object
-      for (size_t i = 0; i < sceneObjects.size(); ++i) {
-        std::vector<std::shared_ptr<Component>> meshPtrs{
-            const_cast<std::vector<SceneObject> &>(sceneObjects)[i].getSpecificComponentPtrs(
-                ComponentType::Mesh)};
-
-        // For each mesh component
-        for (size_t i = 0; i < meshPtrs.size(); ++i) {
-          Mesh &mesh = *dynamic_cast<Mesh *>(meshPtrs[i].get());
-
-          // If mesh is complete
-          if (mesh.isComplete()) {
-            initShaderPrograms.push_back(mesh.getShaderProgram());
-            mesh.setShaderProgram(normalSP);
-          }
-        }
-      }
-      // Temporary updating shader camera
-      SceneObject::updateShadersCamera(sceneObjects, gCamera);
-
-      // Rendering scene object from camera point of view
-      // and reverting shader program changes for each scene object
-      std::vector<GLuint> initShaderProgramsReversed{initShaderPrograms.crbegin(),
-                                                     initShaderPrograms.crend()};
-      for (size_t i = 0; i < sceneObjects.size(); ++i) {
-        sceneObjects[i].render(kExposure);
-
-        // Getting mesh component pointers
-        std::vector<std::shared_ptr<Component>> meshPtrs{
-            const_cast<std::vector<SceneObject> &>(sceneObjects)[i].getSpecificComponentPtrs(
-                ComponentType::Mesh)};
-
-        // For each mesh component
-        for (size_t i = 0; i < meshPtrs.size(); ++i) {
-          Mesh &mesh = *dynamic_cast<Mesh *>(meshPtrs[i].get());
-
-          // If mesh is complete
-          if (mesh.isComplete()) {
-            mesh.setShaderProgram(initShaderProgramsReversed.back());
-            initShaderProgramsReversed.pop_back();
-          }
-        }
-      }
-    }
+    renderQueue.submit(kNormalsPass, kExposure);
 
     // Drawing skybox
     glDepthFunc(GL_LEQUAL);
     glCullFace(GL_FRONT);
-    skyboxSceneObject.setTranslate(gCameraController.getCamera()->getPosition());
-    SceneObject::updateShadersCamera(std::vector<SceneObject>{skyboxSceneObject}, gCamera);
     skyboxSceneObject.render(kExposure);
     glCullFace(GL_BACK);
     glDepthFunc(GL_LESS);
 
-    // If postprocessing is enabled
-    if (gEnablePostprocessing) {
+    // If postprocessing is enabled or shading is deferred (deferred shading renders
+    // into postprocessing framebuffer directly, so it always takes screen pass)
+    if (gEnablePostprocessing || gEnableDeferredShading) {
       // Converting multisampling FBO data to postprocessing one
-      glBindFramebuffer(GL_READ_FRAMEBUFFER, gMultisamplingFBO);
-      glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gPostprocessingFBO);
-      glBlitFramebuffer(0, 0, gWidth, gHeight, 0, 0, gWidth, gHeight, GL_COLOR_BUFFER_BIT,
-                        GL_NEAREST);
-      glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-      glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+      if (!gEnableDeferredShading) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, gMultisamplingFBO);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, gPostprocessingFBO);
+        glBlitFramebuffer(0, 0, gWidth, gHeight, 0, 0, gWidth, gHeight, GL_COLOR_BUFFER_BIT,
+                          GL_NEAREST);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+      }
       // Binding default framebuffer
       glBindFramebuffer(GL_FRAMEBUFFER, 0);
       // Clearing color buffer
@@ -933,8 +940,8 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
       glActiveTexture(GL_TEXTURE0);
       glBindTexture(GL_TEXTURE_2D, gPostprocessingTexture);
       glUseProgram(screenSP);
-      glUniform1f(glGetUniformLocation(screenSP, "EXPOSURE"), kExposure);
-      glUniform1i(glGetUniformLocation(screenSP, "texture0"), 0);
+      glUniform1f(getUniformLocation(screenSP, kExposureUniform), kExposure);
+      glUniform1i(getUniformLocation(screenSP, kTexture0Uniform), 0);
       glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
       glUseProgram(0);
       glBindTexture(GL_TEXTURE_2D, 0);
@@ -947,56 +954,34 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
     // Swapping front and back buffers
     glfwSwapBuffers(window);
 
-    // Releasing OpenGL context and mutex
-    glfwMakeContextCurrent(nullptr);
-    glfwContextLock.unlock();
+    // Printing renderer statistics
+    printStatistics(renderQueue, textureLoader, jobSystem);
 
     std::this_thread::sleep_for(kRenderCycleInterval);
   }
 
-  // Waiting for shaderWatchers to stop
-  blinnPhongShaderWatcherIsRunning = false;
-  blinnPhongShaderWatcherThread.join();
-  lightShaderWatcherIsRunning = false;
-  lightShaderWatcherThread.join();
-  outlineShaderWatcherIsRunning = false;
-  outlineShaderWatcherThread.join();
-  screenShaderWatcherIsRunning = false;
-  screenShaderWatcherThread.join();
-  normalShaderWatcherIsRunning = false;
-  normalShaderWatcherThread.join();
-  skyboxShaderWatcherIsRunning = false;
-  skyboxShaderWatcherThread.join();
-  mirrorShaderWatcherIsRunning = false;
-  mirrorShaderWatcherThread.join();
-  lensShaderWatcherIsRunning = false;
-  lensShaderWatcherThread.join();
-  dynamicLODQuadShaderWatcherIsRunning = false;
-  dynamicLODQuadShaderWatcherThread.join();
-  silhouetteSmoothingShaderWatcherIsRunning = false;
-  silhouetteSmoothingShaderWatcherThread.join();
-  proceduralTextureShaderWatcherIsRunning = false;
-  proceduralTextureShaderWatcherThread.join();
-  shadowMap2DShaderWatcherIsRunning = false;
-  shadowMap2DShaderWatcherThread.join();
-  shadowMapCubeShaderWatcherIsRunning = false;
-  shadowMapCubeShaderWatcherThread.join();
+  // Stopping shader watcher service
+  shaderWatcherService.stop();
 
   // Deleting OpenGL objects
   glDeleteTextures(1, &proceduralTexture);
-  glDeleteProgram(shadowMapCubeSP);
-  glDeleteProgram(shadowMap2DSP);
-  glDeleteProgram(proceduralTextureSP);
-  glDeleteProgram(silhouetteSmoothingSP);
-  glDeleteProgram(dynamicLODQuadSP);
-  glDeleteProgram(lensSP);
-  glDeleteProgram(mirrorSP);
-  glDeleteProgram(skyboxSP);
-  glDeleteProgram(normalSP);
-  glDeleteProgram(screenSP);
-  glDeleteProgram(outlineSP);
-  glDeleteProgram(lightSP);
-  glDeleteProgram(blinnPhongSP);
+  deleteShaderProgram(deferredLightingSP);
+  deleteShaderProgram(gBufferSP);
+  deleteShaderProgram(lightClusteringSP);
+  deleteShaderProgram(shadowMapFilterSP);
+  deleteShaderProgram(shadowMapCubeSP);
+  deleteShaderProgram(shadowMap2DSP);
+  deleteShaderProgram(proceduralTextureSP);
+  deleteShaderProgram(silhouetteSmoothingSP);
+  deleteShaderProgram(dynamicLODQuadSP);
+  deleteShaderProgram(lensSP);
+  deleteShaderProgram(mirrorSP);
+  deleteShaderProgram(skyboxSP);
+  deleteShaderProgram(normalSP);
+  deleteShaderProgram(screenSP);
+  deleteShaderProgram(outlineSP);
+  deleteShaderProgram(lightSP);
+  deleteShaderProgram(blinnPhongSP);
   glDeleteBuffers(1, &screenEBO);
   glDeleteBuffers(1, &screenVBO);
   glDeleteVertexArrays(1, &screenVAO);
@@ -1007,6 +992,11 @@ new Mesh{generateCube(1.0f, 1, true, skyboxSP, texturePtrVectors[2])})     }
   glDeleteFramebuffers(1, &gMultisamplingFBO);
   glDeleteTextures(1, &gMultisamplingTexture);
   glDeleteRenderbuffers(1, &gMultisamplingRBO);
+  glDeleteFramebuffers(1, &gGBufferFBO);
+  glDeleteTextures(1, &gGBufferAlbedoTexture);
+  glDeleteTextures(1, &gGBufferNormalTexture);
+  glDeleteTextures(1, &gGBufferEmissionTexture);
+  glDeleteTextures(1, &gGBufferDepthTexture);
 
   // Terminating window with OpenGL context and GLFW
   terminateWindow(window);
@@ -1024,7 +1014,7 @@ void framebufferSizeCallback(GLFWwindow *window, int width, int height) {
   gHeight = height;
   // Setting viewport position and size relative to window
   glViewport(0, 0, gWidth, gHeight);
-  // Setting postprocessing and multisampling framebuffers sizes
+  // Setting postprocessing, multisampling and geometry buffer framebuffers sizes
   glBindTexture(GL_TEXTURE_2D, gPostprocessingTexture);
   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, gWidth, gHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
   glBindTexture(GL_TEXTURE_2D, 0);
@@ -1039,6 +1029,16 @@ void framebufferSizeCallback(GLFWwindow *window, int width, int height) {
   glRenderbufferStorageMultisample(GL_RENDERBUFFER, kMSAASampleCount, GL_DEPTH24_STENCIL8, gWidth,
                                    gHeight);
   glBindRenderbuffer(GL_RENDERBUFFER, 0);
+  glBindTexture(GL_TEXTURE_2D, gGBufferAlbedoTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, gWidth, gHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glBindTexture(GL_TEXTURE_2D, gGBufferNormalTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, gWidth, gHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
+  glBindTexture(GL_TEXTURE_2D, gGBufferEmissionTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, gWidth, gHeight, 0, GL_RGBA, GL_FLOAT, nullptr);
+  glBindTexture(GL_TEXTURE_2D, gGBufferDepthTexture);
+  glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH24_STENCIL8, gWidth, gHeight, 0, GL_DEPTH_STENCIL,
+               GL_UNSIGNED_INT_24_8, nullptr);
+  glBindTexture(GL_TEXTURE_2D, 0);
   // Setting camera aspect ratio
   gCamera.setAspectRatio(static_cast<float>(gWidth) / static_cast<float>(gHeight));
 }
@@ -1158,13 +1158,9 @@ void processUserInput(GLFWwindow *window) {
     if (!sPressed) {
       sPressed = true;
 
-      // Getting light component pointers
-      std::vector<std::shared_ptr<Component>> lightPtrs{
-          gFlashlightSceneObjectPtr->getSpecificComponentPtrs(ComponentType::Light)};
       // For each light component
-      for (size_t i = 0; i < lightPtrs.size(); ++i) {
-        dynamic_cast<BaseLight *>(lightPtrs[i].get())->getColor() *= -1.0f;
-      }
+      gFlashlightSceneObjectPtr->forEach<BaseLight>(
+          [](BaseLight &light) { light.getColor() *= -1.0f; });
     }
   }
 
@@ -1213,6 +1209,46 @@ void processUserInput(GLFWwindow *window) {
     }
   }
 
+  // Toggling statistics printing
+  if (glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS) {
+    released = false;
+    if (!sPressed) {
+      sPressed = true;
+
+      gEnableStatistics = !gEnableStatistics;
+    }
+  }
+
+  // Toggling filtered (exponential variance) shadows
+  if (glfwGetKey(window, GLFW_KEY_V) == GLFW_PRESS) {
+    released = false;
+    if (!sPressed) {
+      sPressed = true;
+
+      gEnableFilteredShadows = !gEnableFilteredShadows;
+    }
+  }
+
+  // Toggling deferred shading
+  if (glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS) {
+    released = false;
+    if (!sPressed) {
+      sPressed = true;
+
+      gEnableDeferredShading = !gEnableDeferredShading;
+    }
+  }
+
+  // Toggling clustered light culling
+  if (glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS) {
+    released = false;
+    if (!sPressed) {
+      sPressed = true;
+
+      gEnableLightClustering = !gEnableLightClustering;
+    }
+  }
+
   // Toggling polygon mode for both sides
   if (glfwGetKey(window, GLFW_KEY_G) == GLFW_PRESS) {
     released = false;
@@ -1245,7 +1281,7 @@ void processUserInput(GLFWwindow *window) {
 }
 
 void floatSceneObjects(std::vector<SceneObject> &sceneObjects, unsigned int startIndex,
-                       unsigned int count) {
+                       unsigned int count, JobSystem &jobSystem) {
   static std::vector<SceneObject *> sSceneObjectPtrs{};
   static std::vector<glm::vec3>     sInitialTranslations{};
   static std::vector<float>         sTranslationAmplitudes{};
@@ -1287,19 +1323,114 @@ void floatSceneObjects(std::vector<SceneObject> &sceneObjects, unsigned int star
     }
   }
 
-  // For each scene object
-  for (size_t i = 0; i < sSceneObjectPtrs.size(); ++i) {
-    sSceneObjectPtrs[i]->getTranslate() =
-        sInitialTranslations[i] +
-        glm::vec3(0.0f, 1.0f, 0.0f) * sTranslationAmplitudes[i] *
-            std::sin(static_cast<float>(glfwGetTime()) * sTranslationFrequencies[i]);
-    sSceneObjectPtrs[i]->getRotate() =
-        sInitialRotations[i] +
-        glm::vec3(0.0f, 1.0f, 0.0f) * sRotationAmplitudes[i] *
-            std::sin(static_cast<float>(glfwGetTime()) * sRotationFrequencies[i]);
-    sSceneObjectPtrs[i]->getScale() =
-        sInitialScalings[i] *
-        (1.0f + sCalingAmplitudes[i] *
-                    std::sin(static_cast<float>(glfwGetTime()) * sCalingFrequencies[i]));
+  // For each range of scene objects (setters flag model matrix to be recalculated once
+  // per frame, so scene objects are floated on different threads)
+  const float time = static_cast<float>(glfwGetTime());
+  jobSystem.parallelFor(sSceneObjectPtrs.size(), 64, [time](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      sSceneObjectPtrs[i]->setTranslate(sInitialTranslations[i] +
+                                        glm::vec3(0.0f, 1.0f, 0.0f) * sTranslationAmplitudes[i] *
+                                            std::sin(time * sTranslationFrequencies[i]));
+      sSceneObjectPtrs[i]->setRotate(sInitialRotations[i] +
+                                     glm::vec3(0.0f, 1.0f, 0.0f) * sRotationAmplitudes[i] *
+                                         std::sin(time * sRotationFrequencies[i]));
+      sSceneObjectPtrs[i]->setScale(
+          sInitialScalings[i] *
+          (1.0f + sCalingAmplitudes[i] * std::sin(time * sCalingFrequencies[i])));
+    }
+  });
+}
+
+void printStatistics(const RenderQueue &renderQueue, const TextureLoader &textureLoader,
+                     const JobSystem &jobSystem) {
+  static float  sLastPrintTime{};
+  static size_t sLastAllocationCount{};
+
+  // Counting heap allocations since the previous call (once per frame)
+  const size_t allocationCount      = getAllocationCount();
+  const size_t frameAllocationCount = allocationCount - sLastAllocationCount;
+  sLastAllocationCount              = allocationCount;
+
+  // If statistics printing is enabled and it is time to print
+  if (gEnableStatistics && gCurrTime - sLastPrintTime >= kStatisticsInterval) {
+    sLastPrintTime = gCurrTime;
+
+    const UniformCacheStats       &uniformCacheStats = getUniformCacheStats();
+    const CullingStats            &cullingStats      = SceneObject::getCullingStats();
+    const ShaderProgramCacheStats &programCacheStats = getShaderProgramCacheStats();
+    const TextureLoaderStats      textureLoaderStats = textureLoader.getStats();
+    const ShadowAtlasStats       &shadowAtlasStats   = SceneObject::getShadowAtlasStats();
+    const ShadowCacheStats       &shadowCacheStats   = SceneObject::getShadowCacheStats();
+    const ShadowCubeMapPoolStats &shadowCubeMapStats = SceneObject::getShadowCubeMapPoolStats();
+    const TransformStats         &transformStats     = Scene::getDefaultScene().getTransformStats();
+    const JobSystemStats          jobSystemStats     = jobSystem.getStats();
+    std::cout << "frame statistics:\n"
+              << "  uniform lookups skipped: " << uniformCacheStats.skippedLookupCount << "\n"
+              << "  shader programs reflected: " << uniformCacheStats.reflectedProgramCount
+              << "\n"
+              << "  meshes visible: " << cullingStats.visibleMeshCount << "\n"
+              << "  meshes culled: " << cullingStats.culledMeshCount << "\n"
+              << "  shader program cache: " << programCacheStats.hitCount << " hits ("
+              << programCacheStats.loadMilliseconds << " ms), " << programCacheStats.missCount
+              << " misses (" << programCacheStats.compileMilliseconds << " ms), "
+              << programCacheStats.rejectedCount << " rejected\n"
+              << "  textures: " << textureLoaderStats.pendingTextureCount << " pending, "
+              << textureLoaderStats.uploadedTextureCount << " uploaded, "
+              << textureLoaderStats.failedTextureCount << " failed, "
+              << textureLoaderStats.uploadedByteCount << " bytes uploaded, "
+              << textureLoaderStats.ringUsedByteCount << " bytes in flight, "
+              << textureLoaderStats.cachedTextureCount << " read from BCn cache, "
+              << textureLoaderStats.compressedTextureCount << " written to BCn cache\n"
+              << "  shadow atlas tiles: " << shadowAtlasStats.packedTileCount << " packed, "
+              << shadowAtlasStats.downsizedTileCount << " downsized, "
+              << shadowAtlasStats.rejectedTileCount << " rejected\n"
+              << "  shadow cube maps: " << shadowCubeMapStats.assignedCubeMapCount
+              << " assigned, " << shadowCubeMapStats.downsizedCubeMapCount << " downsized, "
+              << shadowCubeMapStats.rejectedCubeMapCount << " rejected, "
+              << shadowCubeMapStats.allocatedByteCount << " bytes allocated\n"
+              << "  shadow maps: " << shadowCacheStats.staticRenderCount << " static rendered, "
+              << shadowCacheStats.dynamicRenderCount << " dynamic rendered, "
+              << shadowCacheStats.reusedCount << " reused\n"
+              << "  transforms: " << transformStats.localMatrixCount << " local and "
+              << transformStats.worldMatrixCount << " world matrices ("
+              << transformStats.milliseconds << " ms, " << getModelMatrixBatchInstructionSet()
+              << ")\n"
+              << "  jobs: " << jobSystemStats.executedJobCount << " executed, "
+              << jobSystemStats.stolenJobCount << " stolen, " << jobSystem.getWorkerCount()
+              << " workers\n";
+    if (isAllocationCountingEnabled()) {
+      std::cout << "  allocations: " << frameAllocationCount << " in the last frame\n";
+    }
+
+    // For each shadow map (casters drawn and culled by light volume)
+    const std::vector<ShadowCasterStats> &shadowCasterStats = SceneObject::getShadowCasterStats();
+    std::cout << "  shadow casters (drawn/culled):";
+    for (size_t i = 0; i < shadowCasterStats.size(); ++i) {
+      std::cout << (i == 0 ? " " : ", ") << shadowCasterStats[i].casterCount << "/"
+                << shadowCasterStats[i].culledCount;
+    }
+    std::cout << "\n";
+
+    // For each render queue pass
+    for (unsigned int i = 0; i < kRenderPassNames.size(); ++i) {
+      const RenderPassStats &passStats = renderQueue.getPassStats(i);
+      std::cout << "  " << kRenderPassNames[i] << " pass: " << passStats.drawCount << " draws, "
+                << passStats.programSwitchCount << " program switches, "
+                << passStats.textureSwitchCount << " texture switches, "
+                << passStats.vaoSwitchCount << " VAO switches\n";
+    }
+
+    // For each OpenGL object type owned by handles
+    std::cout << "  live OpenGL objects:";
+    for (size_t i = 0; i < static_cast<size_t>(GlObjectType::Count); ++i) {
+      const GlObjectType type = static_cast<GlObjectType>(i);
+      std::cout << (i == 0 ? " " : ", ") << getLiveGlObjectCount(type) << " "
+                << getGlObjectTypeName(type);
+    }
+    std::cout << "\n" << std::flush;
   }
+
+  // Resetting statistics for the next frame
+  resetUniformCacheStats();
+  SceneObject::resetCullingStats();
 }
@@ -1,8 +1,8 @@
 #version 460 core
 
-#define MAX_DIRECTIONAL_LIGHT_COUNT 8
-#define MAX_POINT_LIGHT_COUNT       8
-#define MAX_SPOT_LIGHT_COUNT        8
+#define MAX_DIRECTIONAL_LIGHT_COUNT    8
+#define MAX_SHADOWED_POINT_LIGHT_COUNT 8
+#define MAX_SHADOW_CASCADE_COUNT       4
 
 const float kKernelOffset = 0.001f;
 const vec2 kKernel2DOffsets[9] = {
@@ -45,33 +45,45 @@ const vec3 kKernelCubeOffsets[26] = {
   vec3(kKernelOffset, kKernelOffset, kKernelOffset),
 };
 
+// Exponent of depth warp of filtered shadow maps (must match shadowMapFilterCS.glsl),
+// minimal variance (in depth units) and amount of light bleeding cut off
+const float kShadowExponent    = 40.0f;
+const float kShadowMinVariance = 0.00001f;
+const float kShadowBleedingCut = 0.3f;
+
 const int kParallaxMappingDepthLayerCountMin = 8;
 const int kParallaxMappingDepthLayerCountMax = 32;
 
-uniform vec3 VIEW_POS;
+layout (std140, binding = 0) uniform FrameData {
+  mat4 VIEW;
+  mat4 PROJ;
+  vec3 VIEW_POS;
+};
 
-uniform vec3 AMBIENT_LIGHT_COLOR;
-uniform struct {
+struct DirectionalLight {
   vec3 color;
+  uint cascadeCount;
 
   vec3 dir;
 
-  sampler2D shadowMap;
-  mat4      VP;
-} DIRECTIONAL_LIGHTS[MAX_DIRECTIONAL_LIGHT_COUNT];
-uniform struct {
-  vec3 worldPos;
+  vec4 cascadeSplits;
+  mat4 VPs[MAX_SHADOW_CASCADE_COUNT];
+  vec4 atlasRects[MAX_SHADOW_CASCADE_COUNT];
+};
+struct PointLight {
+  vec3  worldPos;
+  float range;
 
   vec3 color;
 
   float linAttCoef;
   float quadAttCoef;
 
-  samplerCube shadowMap;
-  float       farPlane;
-} POINT_LIGHTS[MAX_POINT_LIGHT_COUNT];
-uniform struct {
-  vec3 worldPos;
+  float farPlane;
+};
+struct SpotLight {
+  vec3  worldPos;
+  float range;
 
   vec3 color;
 
@@ -83,9 +95,50 @@ uniform struct {
   float angle;
   float smoothAngle;
 
-  sampler2D shadowMap;
-  mat4      VP;
-} SPOT_LIGHTS[MAX_SPOT_LIGHT_COUNT];
+  mat4 VP;
+  vec4 atlasRect;
+};
+
+layout (std140, binding = 1) uniform Lights {
+  vec3 AMBIENT_LIGHT_COLOR;
+
+  uint DIRECTIONAL_LIGHT_COUNT;
+  uint POINT_LIGHT_COUNT;
+  uint SPOT_LIGHT_COUNT;
+
+  bool SHADOW_FILTERED;
+  uint SHADOWED_POINT_LIGHT_COUNT;
+
+  DirectionalLight DIRECTIONAL_LIGHTS[MAX_DIRECTIONAL_LIGHT_COUNT];
+};
+
+layout (std140, binding = 2) uniform LightClusterData {
+  mat4  CLUSTER_VIEW;
+  mat4  CLUSTER_INV_PROJ;
+  uvec3 CLUSTER_GRID_SIZE;
+  bool  CLUSTERED;
+  vec2  CLUSTER_SCREEN_SIZE;
+  float CLUSTER_NEAR_PLANE;
+  float CLUSTER_FAR_PLANE;
+};
+
+// Point lights with shadow map come first, the rest are clustered
+layout (std430, binding = 0) readonly buffer PointLights {
+  PointLight POINT_LIGHTS[];
+};
+layout (std430, binding = 1) readonly buffer SpotLights {
+  SpotLight SPOT_LIGHTS[];
+};
+layout (std430, binding = 2) readonly buffer LightClusters {
+  uvec4 LIGHT_CLUSTERS[];  // light index offset, point light count and spot light count
+};
+layout (std430, binding = 3) readonly buffer LightIndices {
+  uint LIGHT_INDEX_COUNT;
+  uint LIGHT_INDICES[];
+};
+
+layout (binding = 7) uniform sampler2D   SHADOW_ATLAS;
+layout (binding = 8) uniform samplerCube POINT_LIGHT_SHADOW_MAPS[MAX_SHADOWED_POINT_LIGHT_COUNT];
 
 uniform struct {
   sampler2D   albedoMap;
@@ -174,47 +227,111 @@ float calcLightAttenuation(vec3 worldPos, float linAttCoef, float quadAttCoef) {
   return 1.0f / (1.0f + linAttCoef * dist + quadAttCoef * dist * dist);
 }
 
-void calcDirectionalLight(out vec3 diffuse, out vec3 specular, vec3 N, uint index, vec2 texCoords) {
-  vec3 L = normalize(-DIRECTIONAL_LIGHTS[index].dir);
+float calcMomentsShadow(vec2 moments, float fragmentDepth) {
+  // If fragment is in front of mean occluder or beyond shadow map
+  float warpedDepth = exp(kShadowExponent * fragmentDepth);
+  if (warpedDepth <= moments.x || fragmentDepth >= 1.0f) return 1.0f;
 
-  float attenuation = 1.0f;
+  // Calculating upper bound of not shadowed fraction (Chebyshev's inequality)
+  float minVariance = kShadowMinVariance * kShadowExponent * kShadowExponent
+                    * warpedDepth * warpedDepth;
+  float variance    = max(moments.y - moments.x * moments.x, minVariance);
+  float delta       = warpedDepth - moments.x;
+  float notInShadow = variance / (variance + delta * delta);
 
-  vec3 color = DIRECTIONAL_LIGHTS[index].color;
+  // Cutting off light bleeding of overlapping occluders
+  return clamp((notInShadow - kShadowBleedingCut) / (1.0f - kShadowBleedingCut), 0.0f, 1.0f);
+}
 
-  // Calculation diffuse and specular light (Blinn-Phong)
-  calcBlinnPhongLight(diffuse, specular, N, L, attenuation, color, texCoords);
+float calcAtlasShadow(mat4 VP, vec4 atlasRect, bool isOutsideInShadow) {
+  // If light has no shadow atlas tile
+  if (atlasRect.z <= 0.0f) return 1.0f;
 
   // Calculating fragment coordinates in light space
-  vec4 lightSpaceFragCoords = DIRECTIONAL_LIGHTS[index].VP * vec4(i.worldPos, 1.0f);
+  vec4 lightSpaceFragCoords = VP * vec4(i.worldPos, 1.0f);
   lightSpaceFragCoords     /= lightSpaceFragCoords.w;
   lightSpaceFragCoords      = lightSpaceFragCoords * 0.5f + vec4(vec3(0.5f), 0.0f);
 
+  // If fragment is outside of light tile (tiles of other lights must not be sampled)
+  if (any(lessThan(lightSpaceFragCoords.xy, vec2(0.0f)))
+      || any(greaterThan(lightSpaceFragCoords.xy, vec2(1.0f)))) {
+    return float(!isOutsideInShadow || lightSpaceFragCoords.z >= 1.0f);
+  }
+
+  // Getting tile bounds inset by half texel so that kernel never reads neighbouring tiles
+  vec2 halfTexel = 0.5f / vec2(textureSize(SHADOW_ATLAS, 0));
+  vec2 tileMin   = atlasRect.xy + halfTexel;
+  vec2 tileMax   = atlasRect.xy + atlasRect.zw - halfTexel;
+
+  // If shadow maps are filtered (atlas holds blurred moments, so one filtered fetch is enough)
+  if (SHADOW_FILTERED) {
+    vec2 atlasCoords = clamp(
+        atlasRect.xy + lightSpaceFragCoords.xy * atlasRect.zw,
+        tileMin,
+        tileMax
+    );
+    return calcMomentsShadow(texture(SHADOW_ATLAS, atlasCoords).rg, lightSpaceFragCoords.z);
+  }
+
   // Calculating shadow coefficient (Percentage-Closer Filtering)
   float notInShadow = 0.0f;
-  for (uint i = 0; i < 9; ++i) {
+  for (uint j = 0; j < 9; ++j) {
     // Calculating fragment and obstacle depth
     float fragmentDepth = lightSpaceFragCoords.z;
-    float obstacleDepth = texture(
-        DIRECTIONAL_LIGHTS[index].shadowMap,
-        lightSpaceFragCoords.xy + kKernel2DOffsets[i]
-    ).r;
+    vec2  atlasCoords   = clamp(
+        atlasRect.xy + (lightSpaceFragCoords.xy + kKernel2DOffsets[j]) * atlasRect.zw,
+        tileMin,
+        tileMax
+    );
+    float obstacleDepth = texture(SHADOW_ATLAS, atlasCoords).r;
 
     // Applying shadow bias
-    float LdotN    = max(dot(L, N), 0.0f);
     float bias     = 0.001f;
     obstacleDepth += bias;
 
     // Calculating if fragment is not in shadow
     notInShadow += float(fragmentDepth <= obstacleDepth || fragmentDepth >= 1.0f);
   }
-  notInShadow /= 9.0f;
+
+  return notInShadow / 9.0f;
+}
+
+void calcDirectionalLight(out vec3 diffuse, out vec3 specular, vec3 N, uint index, vec2 texCoords) {
+  vec3 L = normalize(-DIRECTIONAL_LIGHTS[index].dir);
+
+  float attenuation = 1.0f;
+
+  vec3 color = DIRECTIONAL_LIGHTS[index].color;
+
+  // Calculation diffuse and specular light (Blinn-Phong)
+  calcBlinnPhongLight(diffuse, specular, N, L, attenuation, color, texCoords);
+
+  // Selecting cascade by view depth of fragment (fragments beyond the last cascade are lit)
+  float viewDepth   = -(VIEW * vec4(i.worldPos, 1.0f)).z;
+  float notInShadow = 1.0f;
+  for (uint c = 0; c < DIRECTIONAL_LIGHTS[index].cascadeCount; ++c) {
+    if (viewDepth <= DIRECTIONAL_LIGHTS[index].cascadeSplits[c]) {
+      // Calculating shadow coefficient (fragments outside of shadow map are lit)
+      notInShadow = calcAtlasShadow(
+          DIRECTIONAL_LIGHTS[index].VPs[c],
+          DIRECTIONAL_LIGHTS[index].atlasRects[c],
+          false
+      );
+      break;
+    }
+  }
 
   // Applying shadow
   diffuse  *= notInShadow;
   specular *= notInShadow;
 }
 
-void calcPointLight(out vec3 diffuse, out vec3 specular, vec3 N, uint index, vec2 texCoords) {
+void calcPointLight(out vec3 diffuse,
+                    out vec3 specular,
+                    vec3 N,
+                    uint index,
+                    vec2 texCoords,
+                    bool isShadowed) {
   vec3 L = normalize(POINT_LIGHTS[index].worldPos - i.worldPos);
 
   // Calculating light distance attenuation
@@ -229,18 +346,34 @@ void calcPointLight(out vec3 diffuse, out vec3 specular, vec3 N, uint index, vec
   // Calculation diffuse and specular light (Blinn-Phong)
   calcBlinnPhongLight(diffuse, specular, N, L, attenuation, color, texCoords);
 
+  // If light has no shadow map (index must be dynamically uniform to select shadow map)
+  if (!isShadowed) return;
+
   // Calculating light to fragment vector
   vec3 fragmentToLight = POINT_LIGHTS[index].worldPos - i.worldPos;
   // Fixing negative X-axis
   fragmentToLight.x *= -1.0f;
 
+  // If shadow maps are filtered (cube map holds blurred moments, so one filtered fetch is enough)
+  if (SHADOW_FILTERED) {
+    float notInShadow = calcMomentsShadow(
+        texture(POINT_LIGHT_SHADOW_MAPS[index], fragmentToLight).rg,
+        length(fragmentToLight) / POINT_LIGHTS[index].farPlane
+    );
+
+    // Applying shadow
+    diffuse  *= notInShadow;
+    specular *= notInShadow;
+    return;
+  }
+
   // Calculating shadow coefficient (Percentage-Closer Filtering)
   float notInShadow = 0.0f;
   for (uint i = 0; i < 26; ++i) {
     // Calculating fragment and obstacle depth
     float fragmentDepth = length(fragmentToLight) / POINT_LIGHTS[index].farPlane;
     float obstacleDepth = texture(
-        POINT_LIGHTS[index].shadowMap,
+        POINT_LIGHT_SHADOW_MAPS[index],
         fragmentToLight + kKernelCubeOffsets[i]
     ).r;
 
@@ -280,36 +413,31 @@ void calcSpotLight(out vec3 diffuse, out vec3 specular, vec3 N, uint index, vec2
   // Calculation diffuse and specular light (Blinn-Phong)
   calcBlinnPhongLight(diffuse, specular, N, L, attenuation, color, texCoords);
 
-  // Calculating fragment coordinates in light space
-  vec4 lightSpaceFragCoords = SPOT_LIGHTS[index].VP * vec4(i.worldPos, 1.0f);
-  lightSpaceFragCoords     /= lightSpaceFragCoords.w;
-  lightSpaceFragCoords      = lightSpaceFragCoords * 0.5f + vec4(vec3(0.5f), 0.0f);
-
-  // Calculating shadow coefficient (Percentage-Closer Filtering)
-  float notInShadow = 0.0f;
-  for (uint i = 0; i < 9; ++i) {
-    // Calculating fragment and obstacle depth
-    float fragmentDepth = lightSpaceFragCoords.z;
-    float obstacleDepth = texture(
-        SPOT_LIGHTS[index].shadowMap,
-        lightSpaceFragCoords.xy + kKernel2DOffsets[i]
-    ).r;
-
-    // Applying shadow bias
-    float LdotN    = max(dot(L, N), 0.0f);
-    float bias     = 0.001f;
-    obstacleDepth += bias;
-
-    // Calculating if fragment is not in shadow
-    notInShadow += float(fragmentDepth <= obstacleDepth || fragmentDepth >= 1.0f);
-  }
-  notInShadow /= 9.0f;
+  // Calculating shadow coefficient (fragments outside of spot light cone are in shadow)
+  float notInShadow = calcAtlasShadow(SPOT_LIGHTS[index].VP, SPOT_LIGHTS[index].atlasRect, true);
 
   // Applying shadow
   diffuse  *= notInShadow;
   specular *= notInShadow;
 }
 
+uint calcLightClusterIndex() {
+  // Getting screen tile by fragment window coordinates
+  uvec2 tile = min(
+      uvec2(gl_FragCoord.xy / CLUSTER_SCREEN_SIZE * vec2(CLUSTER_GRID_SIZE.xy)),
+      CLUSTER_GRID_SIZE.xy - 1
+  );
+
+  // Getting exponential depth slice by view depth of fragment
+  float viewDepth  = -(CLUSTER_VIEW * vec4(i.worldPos, 1.0f)).z;
+  float slice      = log(max(viewDepth, CLUSTER_NEAR_PLANE) / CLUSTER_NEAR_PLANE)
+                   / log(CLUSTER_FAR_PLANE / CLUSTER_NEAR_PLANE)
+                   * float(CLUSTER_GRID_SIZE.z);
+  uint  sliceIndex = min(uint(slice), CLUSTER_GRID_SIZE.z - 1);
+
+  return tile.x + CLUSTER_GRID_SIZE.x * (tile.y + CLUSTER_GRID_SIZE.y * sliceIndex);
+}
+
 vec2 calcParallaxCoords() {
   // Calculating parallax mapping depth layer count
   int depthLayerCount = int(mix(
@@ -375,7 +503,7 @@ void main() {
   vec3 N = normalize(i.TBN * (vec3(texture(MATERIAL.normalMap, texCoords)) * 2.0f - 1.0f));
 
   // Adding each directional light contribution
-  for (uint i = 0; i < MAX_DIRECTIONAL_LIGHT_COUNT; ++i) {
+  for (uint i = 0; i < DIRECTIONAL_LIGHT_COUNT; ++i) {
     vec3 deltaDiffuse  = vec3(0.0f);
     vec3 deltaSpecular = vec3(0.0f);
 
@@ -385,23 +513,45 @@ void main() {
     specular += max(deltaSpecular, vec3(0.0f));
   }
 
-  // Adding each point light contribution
-  for (uint i = 0; i < MAX_POINT_LIGHT_COUNT; ++i) {
+  // Adding each shadowed point light contribution
+  for (uint i = 0; i < SHADOWED_POINT_LIGHT_COUNT; ++i) {
+    vec3 deltaDiffuse  = vec3(0.0f);
+    vec3 deltaSpecular = vec3(0.0f);
+
+    calcPointLight(deltaDiffuse, deltaSpecular, N, i, texCoords, true);
+
+    diffuse  += max(deltaDiffuse, vec3(0.0f));
+    specular += max(deltaSpecular, vec3(0.0f));
+  }
+
+  // Getting lights of fragment cluster if lights are clustered (all the lights otherwise)
+  uvec4 lightCluster = uvec4(0, 0, 0, 0);
+  if (CLUSTERED) {
+    lightCluster = LIGHT_CLUSTERS[calcLightClusterIndex()];
+  }
+
+  // Adding each unshadowed point light contribution
+  uint pointLightCount = CLUSTERED ? lightCluster.y
+                                   : POINT_LIGHT_COUNT - SHADOWED_POINT_LIGHT_COUNT;
+  for (uint i = 0; i < pointLightCount; ++i) {
     vec3 deltaDiffuse  = vec3(0.0f);
     vec3 deltaSpecular = vec3(0.0f);
 
-    calcPointLight(deltaDiffuse, deltaSpecular, N, i, texCoords);
+    uint index = CLUSTERED ? LIGHT_INDICES[lightCluster.x + i] : SHADOWED_POINT_LIGHT_COUNT + i;
+    calcPointLight(deltaDiffuse, deltaSpecular, N, index, texCoords, false);
 
     diffuse  += max(deltaDiffuse, vec3(0.0f));
     specular += max(deltaSpecular, vec3(0.0f));
   }
 
   // Adding each spot light contribution
-  for (uint i = 0; i < MAX_SPOT_LIGHT_COUNT; ++i) {
+  uint spotLightCount = CLUSTERED ? lightCluster.z : SPOT_LIGHT_COUNT;
+  for (uint i = 0; i < spotLightCount; ++i) {
     vec3 deltaDiffuse  = vec3(0.0f);
     vec3 deltaSpecular = vec3(0.0f);
 
-    calcSpotLight(deltaDiffuse, deltaSpecular, N, i, texCoords);
+    uint index = CLUSTERED ? LIGHT_INDICES[lightCluster.x + lightCluster.y + i] : i;
+    calcSpotLight(deltaDiffuse, deltaSpecular, N, index, texCoords);
 
     diffuse  += max(deltaDiffuse, vec3(0.0f));
     specular += max(deltaSpecular, vec3(0.0f));
@@ -1,10 +1,12 @@
 #version 460 core
 
-uniform vec3 VIEW_POS;
+layout (std140, binding = 0) uniform FrameData {
+  mat4 VIEW;
+  mat4 PROJ;
+  vec3 VIEW_POS;
+};
 
 uniform mat4 MODEL;
-uniform mat4 VIEW;
-uniform mat4 PROJ;
 
 uniform struct {
   sampler2D   albedoMap;
@@ -0,0 +1,492 @@
+#version 460 core
+
+#define MAX_DIRECTIONAL_LIGHT_COUNT    8
+#define MAX_SHADOWED_POINT_LIGHT_COUNT 8
+#define MAX_SHADOW_CASCADE_COUNT       4
+
+const float kKernelOffset = 0.001f;
+const vec2 kKernel2DOffsets[9] = {
+  vec2(-kKernelOffset, kKernelOffset),
+  vec2(0.0f, kKernelOffset),
+  vec2(kKernelOffset, kKernelOffset),
+  vec2(-kKernelOffset, 0.0f),
+  vec2(0.0f, 0.0f),
+  vec2(kKernelOffset, 0.0f),
+  vec2(-kKernelOffset, -kKernelOffset),
+  vec2(0.0f, -kKernelOffset),
+  vec2(kKernelOffset, -kKernelOffset),
+};
+const vec3 kKernelCubeOffsets[26] = {
+  vec3(-kKernelOffset, -kKernelOffset, -kKernelOffset),
+  vec3(-kKernelOffset, -kKernelOffset, 0.0f),
+  vec3(-kKernelOffset, -kKernelOffset, kKernelOffset),
+  vec3(-kKernelOffset, 0.0f, -kKernelOffset),
+  vec3(-kKernelOffset, 0.0f, 0.0f),
+  vec3(-kKernelOffset, 0.0f, kKernelOffset),
+  vec3(-kKernelOffset, kKernelOffset, -kKernelOffset),
+  vec3(-kKernelOffset, kKernelOffset, 0.0f),
+  vec3(-kKernelOffset, kKernelOffset, kKernelOffset),
+  vec3(0.0f, -kKernelOffset, -kKernelOffset),
+  vec3(0.0f, -kKernelOffset, 0.0f),
+  vec3(0.0f, -kKernelOffset, kKernelOffset),
+  vec3(0.0f, 0.0f, -kKernelOffset),
+  vec3(0.0f, 0.0f, kKernelOffset),
+  vec3(0.0f, kKernelOffset, -kKernelOffset),
+  vec3(0.0f, kKernelOffset, 0.0f),
+  vec3(0.0f, kKernelOffset, kKernelOffset),
+  vec3(kKernelOffset, -kKernelOffset, -kKernelOffset),
+  vec3(kKernelOffset, -kKernelOffset, 0.0f),
+  vec3(kKernelOffset, -kKernelOffset, kKernelOffset),
+  vec3(kKernelOffset, 0.0f, -kKernelOffset),
+  vec3(kKernelOffset, 0.0f, 0.0f),
+  vec3(kKernelOffset, 0.0f, kKernelOffset),
+  vec3(kKernelOffset, kKernelOffset, -kKernelOffset),
+  vec3(kKernelOffset, kKernelOffset, 0.0f),
+  vec3(kKernelOffset, kKernelOffset, kKernelOffset),
+};
+
+// Exponent of depth warp of filtered shadow maps (must match shadowMapFilterCS.glsl),
+// minimal variance (in depth units) and amount of light bleeding cut off
+const float kShadowExponent    = 40.0f;
+const float kShadowMinVariance = 0.00001f;
+const float kShadowBleedingCut = 0.3f;
+
+layout (std140, binding = 0) uniform FrameData {
+  mat4 VIEW;
+  mat4 PROJ;
+  vec3 VIEW_POS;
+  mat4 INV_VIEW_PROJ;
+};
+
+struct DirectionalLight {
+  vec3 color;
+  uint cascadeCount;
+
+  vec3 dir;
+
+  vec4 cascadeSplits;
+  mat4 VPs[MAX_SHADOW_CASCADE_COUNT];
+  vec4 atlasRects[MAX_SHADOW_CASCADE_COUNT];
+};
+struct PointLight {
+  vec3  worldPos;
+  float range;
+
+  vec3 color;
+
+  float linAttCoef;
+  float quadAttCoef;
+
+  float farPlane;
+};
+struct SpotLight {
+  vec3  worldPos;
+  float range;
+
+  vec3 color;
+
+  vec3 dir;
+
+  float linAttCoef;
+  float quadAttCoef;
+
+  float angle;
+  float smoothAngle;
+
+  mat4 VP;
+  vec4 atlasRect;
+};
+
+layout (std140, binding = 1) uniform Lights {
+  vec3 AMBIENT_LIGHT_COLOR;
+
+  uint DIRECTIONAL_LIGHT_COUNT;
+  uint POINT_LIGHT_COUNT;
+  uint SPOT_LIGHT_COUNT;
+
+  bool SHADOW_FILTERED;
+  uint SHADOWED_POINT_LIGHT_COUNT;
+
+  DirectionalLight DIRECTIONAL_LIGHTS[MAX_DIRECTIONAL_LIGHT_COUNT];
+};
+
+layout (std140, binding = 2) uniform LightClusterData {
+  mat4  CLUSTER_VIEW;
+  mat4  CLUSTER_INV_PROJ;
+  uvec3 CLUSTER_GRID_SIZE;
+  bool  CLUSTERED;
+  vec2  CLUSTER_SCREEN_SIZE;
+  float CLUSTER_NEAR_PLANE;
+  float CLUSTER_FAR_PLANE;
+};
+
+// Point lights with shadow map come first, the rest are clustered
+layout (std430, binding = 0) readonly buffer PointLights {
+  PointLight POINT_LIGHTS[];
+};
+layout (std430, binding = 1) readonly buffer SpotLights {
+  SpotLight SPOT_LIGHTS[];
+};
+layout (std430, binding = 2) readonly buffer LightClusters {
+  uvec4 LIGHT_CLUSTERS[];  // light index offset, point light count and spot light count
+};
+layout (std430, binding = 3) readonly buffer LightIndices {
+  uint LIGHT_INDEX_COUNT;
+  uint LIGHT_INDICES[];
+};
+
+layout (binding = 7) uniform sampler2D   SHADOW_ATLAS;
+layout (binding = 8) uniform samplerCube POINT_LIGHT_SHADOW_MAPS[MAX_SHADOWED_POINT_LIGHT_COUNT];
+
+// Geometry buffer written by gBufferFS.glsl
+layout (binding = 0) uniform sampler2D G_ALBEDO;    // albedo and ambient occlusion
+layout (binding = 1) uniform sampler2D G_NORMAL;    // world space normal and gloss
+layout (binding = 2) uniform sampler2D G_EMISSION;  // emission multiplied by its alpha
+layout (binding = 3) uniform sampler2D G_DEPTH;
+
+// Surface attributes of fragment read from geometry buffer
+// (named like interpolators of forward shader, so lighting functions match it)
+struct Surface {
+  vec3  worldPos;
+  float gloss;
+} i;
+
+in vec2 fTexCoords;
+
+out vec4 FragColor;
+
+void calcLambertianLight(out vec3 diffuse,
+                        vec3 N,
+                        vec3 L,
+                        float attenuation,
+                        vec3 color) {
+  float LdotN = max(dot(L, N), 0.0f);
+
+  // Calculating diffuse (Lambertian) light
+  diffuse = color
+          * LdotN
+          * attenuation;
+}
+
+void calcBlinnPhongLight(out vec3 diffuse,
+                         out vec3 specular,
+                         vec3 N,
+                         vec3 L,
+                         float attenuation,
+                         vec3 color) {
+  // Calculating diffuse (Lambertian) light
+  calcLambertianLight(diffuse, N, L, attenuation, color);
+
+  float gloss    = i.gloss;
+  float glossExp = 2.0f * exp2(gloss);
+  vec3  V        = normalize(VIEW_POS - i.worldPos);
+  vec3  H        = normalize(L + V);
+  float HdotN    = max(dot(H, N), 0.0f);
+  float LdotN    = max(dot(L, N), 0.0f);
+
+  // Calculating specular (Blinn-Phong) light
+  specular = color
+           * gloss * pow(HdotN, glossExp) * float(LdotN > 0.0f)
+           * attenuation;
+}
+
+float calcLightAttenuation(vec3 worldPos, float linAttCoef, float quadAttCoef) {
+  float dist = length(worldPos - i.worldPos);
+
+  return 1.0f / (1.0f + linAttCoef * dist + quadAttCoef * dist * dist);
+}
+
+float calcMomentsShadow(vec2 moments, float fragmentDepth) {
+  // If fragment is in front of mean occluder or beyond shadow map
+  float warpedDepth = exp(kShadowExponent * fragmentDepth);
+  if (warpedDepth <= moments.x || fragmentDepth >= 1.0f) return 1.0f;
+
+  // Calculating upper bound of not shadowed fraction (Chebyshev's inequality)
+  float minVariance = kShadowMinVariance * kShadowExponent * kShadowExponent
+                    * warpedDepth * warpedDepth;
+  float variance    = max(moments.y - moments.x * moments.x, minVariance);
+  float delta       = warpedDepth - moments.x;
+  float notInShadow = variance / (variance + delta * delta);
+
+  // Cutting off light bleeding of overlapping occluders
+  return clamp((notInShadow - kShadowBleedingCut) / (1.0f - kShadowBleedingCut), 0.0f, 1.0f);
+}
+
+float calcAtlasShadow(mat4 VP, vec4 atlasRect, bool isOutsideInShadow) {
+  // If light has no shadow atlas tile
+  if (atlasRect.z <= 0.0f) return 1.0f;
+
+  // Calculating fragment coordinates in light space
+  vec4 lightSpaceFragCoords = VP * vec4(i.worldPos, 1.0f);
+  lightSpaceFragCoords     /= lightSpaceFragCoords.w;
+  lightSpaceFragCoords      = lightSpaceFragCoords * 0.5f + vec4(vec3(0.5f), 0.0f);
+
+  // If fragment is outside of light tile (tiles of other lights must not be sampled)
+  if (any(lessThan(lightSpaceFragCoords.xy, vec2(0.0f)))
+      || any(greaterThan(lightSpaceFragCoords.xy, vec2(1.0f)))) {
+    return float(!isOutsideInShadow || lightSpaceFragCoords.z >= 1.0f);
+  }
+
+  // Getting tile bounds inset by half texel so that kernel never reads neighbouring tiles
+  vec2 halfTexel = 0.5f / vec2(textureSize(SHADOW_ATLAS, 0));
+  vec2 tileMin   = atlasRect.xy + halfTexel;
+  vec2 tileMax   = atlasRect.xy + atlasRect.zw - halfTexel;
+
+  // If shadow maps are filtered (atlas holds blurred moments, so one filtered fetch is enough)
+  if (SHADOW_FILTERED) {
+    vec2 atlasCoords = clamp(
+        atlasRect.xy + lightSpaceFragCoords.xy * atlasRect.zw,
+        tileMin,
+        tileMax
+    );
+    return calcMomentsShadow(texture(SHADOW_ATLAS, atlasCoords).rg, lightSpaceFragCoords.z);
+  }
+
+  // Calculating shadow coefficient (Percentage-Closer Filtering)
+  float notInShadow = 0.0f;
+  for (uint j = 0; j < 9; ++j) {
+    // Calculating fragment and obstacle depth
+    float fragmentDepth = lightSpaceFragCoords.z;
+    vec2  atlasCoords   = clamp(
+        atlasRect.xy + (lightSpaceFragCoords.xy + kKernel2DOffsets[j]) * atlasRect.zw,
+        tileMin,
+        tileMax
+    );
+    float obstacleDepth = texture(SHADOW_ATLAS, atlasCoords).r;
+
+    // Applying shadow bias
+    float bias     = 0.001f;
+    obstacleDepth += bias;
+
+    // Calculating if fragment is not in shadow
+    notInShadow += float(fragmentDepth <= obstacleDepth || fragmentDepth >= 1.0f);
+  }
+
+  return notInShadow / 9.0f;
+}
+
+void calcDirectionalLight(out vec3 diffuse, out vec3 specular, vec3 N, uint index) {
+  vec3 L = normalize(-DIRECTIONAL_LIGHTS[index].dir);
+
+  float attenuation = 1.0f;
+
+  vec3 color = DIRECTIONAL_LIGHTS[index].color;
+
+  // Calculation diffuse and specular light (Blinn-Phong)
+  calcBlinnPhongLight(diffuse, specular, N, L, attenuation, color);
+
+  // Selecting cascade by view depth of fragment (fragments beyond the last cascade are lit)
+  float viewDepth   = -(VIEW * vec4(i.worldPos, 1.0f)).z;
+  float notInShadow = 1.0f;
+  for (uint c = 0; c < DIRECTIONAL_LIGHTS[index].cascadeCount; ++c) {
+    if (viewDepth <= DIRECTIONAL_LIGHTS[index].cascadeSplits[c]) {
+      // Calculating shadow coefficient (fragments outside of shadow map are lit)
+      notInShadow = calcAtlasShadow(
+          DIRECTIONAL_LIGHTS[index].VPs[c],
+          DIRECTIONAL_LIGHTS[index].atlasRects[c],
+          false
+      );
+      break;
+    }
+  }
+
+  // Applying shadow
+  diffuse  *= notInShadow;
+  specular *= notInShadow;
+}
+
+void calcPointLight(out vec3 diffuse,
+                    out vec3 specular,
+                    vec3 N,
+                    uint index,
+                    bool isShadowed) {
+  vec3 L = normalize(POINT_LIGHTS[index].worldPos - i.worldPos);
+
+  // Calculating light distance attenuation
+  float attenuation = calcLightAttenuation(
+      POINT_LIGHTS[index].worldPos,
+      POINT_LIGHTS[index].linAttCoef,
+      POINT_LIGHTS[index].quadAttCoef
+  );
+
+  vec3 color = POINT_LIGHTS[index].color;
+
+  // Calculation diffuse and specular light (Blinn-Phong)
+  calcBlinnPhongLight(diffuse, specular, N, L, attenuation, color);
+
+  // If light has no shadow map (index must be dynamically uniform to select shadow map)
+  if (!isShadowed) return;
+
+  // Calculating light to fragment vector
+  vec3 fragmentToLight = POINT_LIGHTS[index].worldPos - i.worldPos;
+  // Fixing negative X-axis
+  fragmentToLight.x *= -1.0f;
+
+  // If shadow maps are filtered (cube map holds blurred moments, so one filtered fetch is enough)
+  if (SHADOW_FILTERED) {
+    float notInShadow = calcMomentsShadow(
+        texture(POINT_LIGHT_SHADOW_MAPS[index], fragmentToLight).rg,
+        length(fragmentToLight) / POINT_LIGHTS[index].farPlane
+    );
+
+    // Applying shadow
+    diffuse  *= notInShadow;
+    specular *= notInShadow;
+    return;
+  }
+
+  // Calculating shadow coefficient (Percentage-Closer Filtering)
+  float notInShadow = 0.0f;
+  for (uint i = 0; i < 26; ++i) {
+    // Calculating fragment and obstacle depth
+    float fragmentDepth = length(fragmentToLight) / POINT_LIGHTS[index].farPlane;
+    float obstacleDepth = texture(
+        POINT_LIGHT_SHADOW_MAPS[index],
+        fragmentToLight + kKernelCubeOffsets[i]
+    ).r;
+
+    // Applying shadow bias
+    float LdotN    = max(dot(L, N), 0.0f);
+    float bias     = 0.001f;
+    obstacleDepth += bias;
+
+    // Calculating if fragment is not in shadow
+    notInShadow += float(fragmentDepth <= obstacleDepth || fragmentDepth >= 1.0f);
+  }
+  notInShadow /= 9.0f;
+
+  // Applying shadow
+  diffuse  *= notInShadow;
+  specular *= notInShadow;
+}
+
+void calcSpotLight(out vec3 diffuse, out vec3 specular, vec3 N, uint index) {
+  vec3 L = normalize(SPOT_LIGHTS[index].worldPos - i.worldPos);
+
+  // Calculating light distance attenuation
+  float attenuation = calcLightAttenuation(
+      SPOT_LIGHTS[index].worldPos,
+      SPOT_LIGHTS[index].linAttCoef,
+      SPOT_LIGHTS[index].quadAttCoef
+  );
+  float angle       = cos(SPOT_LIGHTS[index].angle);
+  vec3  D           = normalize(-SPOT_LIGHTS[index].dir);
+  float LdotD       = dot(L, D);
+  float smoothAngle = cos(SPOT_LIGHTS[index].smoothAngle);
+  //attenuation      *= 1.0f - min((1.0f - LdotD) / (1.0f - angle), 1.0f);
+  attenuation      *= 1.0f - min((smoothAngle - LdotD) / (smoothAngle - angle), 1.0f);
+
+  vec3 color = SPOT_LIGHTS[index].color;
+
+  // Calculation diffuse and specular light (Blinn-Phong)
+  calcBlinnPhongLight(diffuse, specular, N, L, attenuation, color);
+
+  // Calculating shadow coefficient (fragments outside of spot light cone are in shadow)
+  float notInShadow = calcAtlasShadow(SPOT_LIGHTS[index].VP, SPOT_LIGHTS[index].atlasRect, true);
+
+  // Applying shadow
+  diffuse  *= notInShadow;
+  specular *= notInShadow;
+}
+
+uint calcLightClusterIndex() {
+  // Getting screen tile by fragment window coordinates
+  uvec2 tile = min(
+      uvec2(gl_FragCoord.xy / CLUSTER_SCREEN_SIZE * vec2(CLUSTER_GRID_SIZE.xy)),
+      CLUSTER_GRID_SIZE.xy - 1
+  );
+
+  // Getting exponential depth slice by view depth of fragment
+  float viewDepth  = -(CLUSTER_VIEW * vec4(i.worldPos, 1.0f)).z;
+  float slice      = log(max(viewDepth, CLUSTER_NEAR_PLANE) / CLUSTER_NEAR_PLANE)
+                   / log(CLUSTER_FAR_PLANE / CLUSTER_NEAR_PLANE)
+                   * float(CLUSTER_GRID_SIZE.z);
+  uint  sliceIndex = min(uint(slice), CLUSTER_GRID_SIZE.z - 1);
+
+  return tile.x + CLUSTER_GRID_SIZE.x * (tile.y + CLUSTER_GRID_SIZE.y * sliceIndex);
+}
+
+// Fragment shader
+void main() {
+  // Discarding fragment if nothing was drawn into geometry buffer (background stays cleared)
+  float depth = texture(G_DEPTH, fTexCoords).r;
+  if (depth >= 1.0f) discard;
+
+  // Reconstructing world position by depth and reading surface attributes
+  vec4 worldPos = INV_VIEW_PROJ * vec4(vec3(fTexCoords, depth) * 2.0f - 1.0f, 1.0f);
+  vec4 albedo   = texture(G_ALBEDO, fTexCoords);
+  vec4 normal   = texture(G_NORMAL, fTexCoords);
+  i.worldPos    = worldPos.xyz / worldPos.w;
+  i.gloss       = normal.w;
+
+  // Initializing Phong/Blinn-Phong light model components
+  vec3 ambient  = AMBIENT_LIGHT_COLOR
+                * albedo.a;
+  vec3 diffuse  = vec3(0.0f);
+  vec3 specular = vec3(0.0f);
+
+  vec3 N = normalize(normal.xyz);
+
+  // Adding each directional light contribution
+  for (uint i = 0; i < DIRECTIONAL_LIGHT_COUNT; ++i) {
+    vec3 deltaDiffuse  = vec3(0.0f);
+    vec3 deltaSpecular = vec3(0.0f);
+
+    calcDirectionalLight(deltaDiffuse, deltaSpecular, N, i);
+
+    diffuse  += max(deltaDiffuse, vec3(0.0f));
+    specular += max(deltaSpecular, vec3(0.0f));
+  }
+
+  // Adding each shadowed point light contribution
+  for (uint i = 0; i < SHADOWED_POINT_LIGHT_COUNT; ++i) {
+    vec3 deltaDiffuse  = vec3(0.0f);
+    vec3 deltaSpecular = vec3(0.0f);
+
+    calcPointLight(deltaDiffuse, deltaSpecular, N, i, true);
+
+    diffuse  += max(deltaDiffuse, vec3(0.0f));
+    specular += max(deltaSpecular, vec3(0.0f));
+  }
+
+  // Getting lights of fragment cluster if lights are clustered (all the lights otherwise)
+  uvec4 lightCluster = uvec4(0, 0, 0, 0);
+  if (CLUSTERED) {
+    lightCluster = LIGHT_CLUSTERS[calcLightClusterIndex()];
+  }
+
+  // Adding each unshadowed point light contribution
+  uint pointLightCount = CLUSTERED ? lightCluster.y
+                                   : POINT_LIGHT_COUNT - SHADOWED_POINT_LIGHT_COUNT;
+  for (uint i = 0; i < pointLightCount; ++i) {
+    vec3 deltaDiffuse  = vec3(0.0f);
+    vec3 deltaSpecular = vec3(0.0f);
+
+    uint index = CLUSTERED ? LIGHT_INDICES[lightCluster.x + i] : SHADOWED_POINT_LIGHT_COUNT + i;
+    calcPointLight(deltaDiffuse, deltaSpecular, N, index, false);
+
+    diffuse  += max(deltaDiffuse, vec3(0.0f));
+    specular += max(deltaSpecular, vec3(0.0f));
+  }
+
+  // Adding each spot light contribution
+  uint spotLightCount = CLUSTERED ? lightCluster.z : SPOT_LIGHT_COUNT;
+  for (uint i = 0; i < spotLightCount; ++i) {
+    vec3 deltaDiffuse  = vec3(0.0f);
+    vec3 deltaSpecular = vec3(0.0f);
+
+    uint index = CLUSTERED ? LIGHT_INDICES[lightCluster.x + lightCluster.y + i] : i;
+    calcSpotLight(deltaDiffuse, deltaSpecular, N, index);
+
+    diffuse  += max(deltaDiffuse, vec3(0.0f));
+    specular += max(deltaSpecular, vec3(0.0f));
+  }
+
+  // Adding together all the light components
+  vec3 light = ambient + diffuse + specular;
+
+  // Calculating fragment color by albedo, light and also emission
+  vec3 color = albedo.rgb * light + texture(G_EMISSION, fTexCoords).rgb;
+
+  FragColor = vec4(color, 1.0f);
+}
@@ -0,0 +1,89 @@
+#version 460 core
+
+const int kParallaxMappingDepthLayerCountMin = 8;
+const int kParallaxMappingDepthLayerCountMax = 32;
+
+uniform struct {
+  sampler2D   albedoMap;
+  sampler2D   normalMap;
+  sampler2D   depthMap;
+  sampler2D   ambOccMap;
+  sampler2D   glossMap;
+  sampler2D   emissMap;
+  samplerCube envMap;
+
+  float parallaxStrength;
+} MATERIAL;
+
+in Interpolators {
+  vec3 worldPos;
+  vec3 normal;
+  mat3 TBN;
+  vec2 texCoords;
+  vec3 viewDirTangent;
+} i;
+
+// Geometry buffer (world position is reconstructed from depth by lighting pass)
+layout (location = 0) out vec4 GAlbedo;    // albedo and ambient occlusion
+layout (location = 1) out vec4 GNormal;    // world space normal and gloss
+layout (location = 2) out vec4 GEmission;  // emission multiplied by its alpha
+
+vec2 calcParallaxCoords() {
+  // Calculating parallax mapping depth layer count
+  int depthLayerCount = int(mix(
+    kParallaxMappingDepthLayerCountMin,
+    kParallaxMappingDepthLayerCountMax,
+    max(i.viewDirTangent.z, 0.0f)
+  ));
+
+  // Calculating P vector
+  float depth = texture(MATERIAL.depthMap, i.texCoords).r * MATERIAL.parallaxStrength;
+  vec2  P     = i.viewDirTangent.xy * depth;
+
+  // Calculating variables for steep parallax mapping
+  vec2  layerTexStep       = P / depthLayerCount;
+  float layerDepthStep     = 1.0f / depthLayerCount;
+  vec2  currLayerTexCoords = i.texCoords;
+  float currLayerDepth     = 0.0f;
+  float currDepthMapValue  = texture(MATERIAL.depthMap, i.texCoords).r;
+
+  // While current layer depth is less than current depth map value
+  while (currLayerDepth < currDepthMapValue) {
+    currLayerTexCoords -= layerTexStep;
+    currLayerDepth     += layerDepthStep;
+    currDepthMapValue   = texture(MATERIAL.depthMap, currLayerTexCoords).r;
+  }
+
+  // Parallax occlusion mapping
+  vec2  prevLayerTexCoords  = currLayerTexCoords + layerTexStep;
+  float prevLayerDepth      = currLayerDepth - layerDepthStep;
+  float currDeltaDepth      = currDepthMapValue - currLayerDepth;
+  float prevDeltaDepth      = prevLayerDepth - texture(MATERIAL.depthMap, prevLayerTexCoords).r;
+  float interpolationWeight = prevDeltaDepth / (prevDeltaDepth + currDeltaDepth);
+  vec2  texCoords           = mix(prevLayerTexCoords, currLayerTexCoords, interpolationWeight);
+
+  return texCoords;
+}
+
+// Fragment shader
+void main() {
+  // Calculating texel coordinates using parallax mapping
+  vec2 texCoords = calcParallaxCoords();
+
+  // Discarding fragment if texel coordinates are out of bound
+  if (texCoords.x < 0.0f || texCoords.x > 1.0f || texCoords.y < 0.0f || texCoords.y > 1.0f) discard;
+
+  // Using normal map and TBN matrix to get world space normal
+  vec3 N = normalize(i.TBN * (vec3(texture(MATERIAL.normalMap, texCoords)) * 2.0f - 1.0f));
+
+  // Getting material maps texels
+  vec4  albedoTexel   = texture(MATERIAL.albedoMap, texCoords);
+  vec4  emissionTexel = texture(MATERIAL.emissMap, texCoords);
+  float ambOcc        = texture(MATERIAL.ambOccMap, texCoords).r;
+  float gloss         = texture(MATERIAL.glossMap, texCoords).r;
+
+  // Writing surface attributes (lighting is deferred)
+  GAlbedo   = vec4(albedoTexel.rgb, ambOcc);
+  GNormal   = vec4(N, gloss);
+  GEmission = vec4(emissionTexel.rgb * emissionTexel.a, 1.0f);
+}
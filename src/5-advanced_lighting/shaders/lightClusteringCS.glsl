@@ -0,0 +1,156 @@
+#version 460 core
+
+// Lights single cluster can hold (the rest are dropped) and light index list capacity
+// (must match SceneObject.cpp)
+#define MAX_CLUSTER_LIGHT_COUNT 64
+#define MAX_LIGHT_INDEX_COUNT   (16 * 9 * 24 * 32)
+
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+struct PointLight {
+  vec3  worldPos;
+  float range;
+
+  vec3 color;
+
+  float linAttCoef;
+  float quadAttCoef;
+
+  float farPlane;
+};
+struct SpotLight {
+  vec3  worldPos;
+  float range;
+
+  vec3 color;
+
+  vec3 dir;
+
+  float linAttCoef;
+  float quadAttCoef;
+
+  float angle;
+  float smoothAngle;
+
+  mat4 VP;
+  vec4 atlasRect;
+};
+
+// Beginning of Lights uniform block (directional lights are not clustered)
+layout (std140, binding = 1) uniform Lights {
+  vec3 AMBIENT_LIGHT_COLOR;
+
+  uint DIRECTIONAL_LIGHT_COUNT;
+  uint POINT_LIGHT_COUNT;
+  uint SPOT_LIGHT_COUNT;
+
+  bool SHADOW_FILTERED;
+  uint SHADOWED_POINT_LIGHT_COUNT;
+};
+
+layout (std140, binding = 2) uniform LightClusterData {
+  mat4  CLUSTER_VIEW;
+  mat4  CLUSTER_INV_PROJ;
+  uvec3 CLUSTER_GRID_SIZE;
+  bool  CLUSTERED;
+  vec2  CLUSTER_SCREEN_SIZE;
+  float CLUSTER_NEAR_PLANE;
+  float CLUSTER_FAR_PLANE;
+};
+
+layout (std430, binding = 0) readonly buffer PointLights {
+  PointLight POINT_LIGHTS[];
+};
+layout (std430, binding = 1) readonly buffer SpotLights {
+  SpotLight SPOT_LIGHTS[];
+};
+layout (std430, binding = 2) writeonly buffer LightClusters {
+  uvec4 LIGHT_CLUSTERS[];  // light index offset, point light count and spot light count
+};
+layout (std430, binding = 3) buffer LightIndices {
+  uint LIGHT_INDEX_COUNT;
+  uint LIGHT_INDICES[];
+};
+
+// Gets view space point on ray through NDC point of near plane at given view depth
+vec3 calcViewSpacePoint(vec2 ndc, float viewDepth) {
+  vec4 nearPoint = CLUSTER_INV_PROJ * vec4(ndc, -1.0f, 1.0f);
+  nearPoint     /= nearPoint.w;
+  return nearPoint.xyz * (viewDepth / -nearPoint.z);
+}
+
+// Checks if sphere intersects axis-aligned bounding box
+bool isSphereInAABB(vec3 center, float radius, vec3 aabbMin, vec3 aabbMax) {
+  vec3 closestPoint = clamp(center, aabbMin, aabbMax);
+  vec3 delta        = center - closestPoint;
+  return dot(delta, delta) <= radius * radius;
+}
+
+// Compute shader
+void main() {
+  // Getting cluster coordinates (invocations past the last cluster do nothing)
+  uint clusterIndex = gl_GlobalInvocationID.x;
+  uint clusterCount = CLUSTER_GRID_SIZE.x * CLUSTER_GRID_SIZE.y * CLUSTER_GRID_SIZE.z;
+  if (clusterIndex >= clusterCount) return;
+  uvec3 cluster = uvec3(
+      clusterIndex % CLUSTER_GRID_SIZE.x,
+      clusterIndex / CLUSTER_GRID_SIZE.x % CLUSTER_GRID_SIZE.y,
+      clusterIndex / (CLUSTER_GRID_SIZE.x * CLUSTER_GRID_SIZE.y)
+  );
+
+  // Calculating screen tile bounds in NDC and depth slice bounds in view space
+  // (slices are exponential, so clusters stay roughly cubic along the whole view depth)
+  vec2  tileMin    = vec2(cluster.xy) / vec2(CLUSTER_GRID_SIZE.xy) * 2.0f - 1.0f;
+  vec2  tileMax    = vec2(cluster.xy + 1) / vec2(CLUSTER_GRID_SIZE.xy) * 2.0f - 1.0f;
+  float depthRatio = CLUSTER_FAR_PLANE / CLUSTER_NEAR_PLANE;
+  float sliceCount = float(CLUSTER_GRID_SIZE.z);
+  float sliceNear  = CLUSTER_NEAR_PLANE * pow(depthRatio, float(cluster.z) / sliceCount);
+  float sliceFar   = CLUSTER_NEAR_PLANE * pow(depthRatio, float(cluster.z + 1) / sliceCount);
+
+  // Calculating view space axis-aligned bounding box of cluster by its corners
+  vec3 aabbMin = vec3(1e30f);
+  vec3 aabbMax = vec3(-1e30f);
+  for (uint j = 0; j < 8; ++j) {
+    vec2  ndc       = vec2((j & 1) == 0 ? tileMin.x : tileMax.x,
+                           (j & 2) == 0 ? tileMin.y : tileMax.y);
+    float viewDepth = (j & 4) == 0 ? sliceNear : sliceFar;
+    vec3  corner    = calcViewSpacePoint(ndc, viewDepth);
+    aabbMin         = min(aabbMin, corner);
+    aabbMax         = max(aabbMax, corner);
+  }
+
+  // Gathering point lights without shadow map (shadowed ones are not clustered)
+  // and spot lights whose range spheres intersect cluster
+  uint lightIndices[MAX_CLUSTER_LIGHT_COUNT];
+  uint pointLightCount = 0;
+  uint spotLightCount  = 0;
+  for (uint j = SHADOWED_POINT_LIGHT_COUNT;
+       j < POINT_LIGHT_COUNT && pointLightCount < MAX_CLUSTER_LIGHT_COUNT; ++j) {
+    vec3 center = (CLUSTER_VIEW * vec4(POINT_LIGHTS[j].worldPos, 1.0f)).xyz;
+    if (isSphereInAABB(center, POINT_LIGHTS[j].range, aabbMin, aabbMax)) {
+      lightIndices[pointLightCount++] = j;
+    }
+  }
+  for (uint j = 0;
+       j < SPOT_LIGHT_COUNT && pointLightCount + spotLightCount < MAX_CLUSTER_LIGHT_COUNT; ++j) {
+    vec3 center = (CLUSTER_VIEW * vec4(SPOT_LIGHTS[j].worldPos, 1.0f)).xyz;
+    if (isSphereInAABB(center, SPOT_LIGHTS[j].range, aabbMin, aabbMax)) {
+      lightIndices[pointLightCount + spotLightCount++] = j;
+    }
+  }
+
+  // Allocating room in light index list (lights which do not fit are dropped)
+  uint lightCount = pointLightCount + spotLightCount;
+  uint offset     = atomicAdd(LIGHT_INDEX_COUNT, lightCount);
+  if (offset + lightCount > MAX_LIGHT_INDEX_COUNT) {
+    lightCount      = offset < MAX_LIGHT_INDEX_COUNT ? MAX_LIGHT_INDEX_COUNT - offset : 0;
+    pointLightCount = min(pointLightCount, lightCount);
+    spotLightCount  = lightCount - pointLightCount;
+  }
+
+  // Writing cluster light indices (point lights first)
+  for (uint j = 0; j < lightCount; ++j) {
+    LIGHT_INDICES[offset + j] = lightIndices[j];
+  }
+  LIGHT_CLUSTERS[clusterIndex] = uvec4(offset, pointLightCount, spotLightCount, 0);
+}
@@ -2,7 +2,11 @@
 
 uniform float EXPOSURE;
 
-uniform vec3 VIEW_POS;
+layout (std140, binding = 0) uniform FrameData {
+  mat4 VIEW;
+  mat4 PROJ;
+  vec3 VIEW_POS;
+};
 
 uniform struct {
   sampler2D   albedoMap;
@@ -2,9 +2,13 @@
 
 const float kMagnitude = 0.05f;
 
+layout (std140, binding = 0) uniform FrameData {
+  mat4 VIEW;
+  mat4 PROJ;
+  vec3 VIEW_POS;
+};
+
 uniform mat4 MODEL;
-uniform mat4 VIEW;
-uniform mat4 PROJ;
 
 uniform struct {
   sampler2D   albedoMap;
@@ -0,0 +1,26 @@
+#version 460 core
+#extension GL_ARB_shader_viewport_layer_array : require
+
+uniform mat4 MODEL;
+uniform mat4 LIGHT_VP[6];
+uniform int  LIGHT_LAYER;
+
+uniform bool INSTANCED;
+
+layout (location = 0) in vec3 aPos;
+layout (location = 4) in mat4 aModel;
+
+out vec3 vertexWorldPos;
+
+// Vertex shader (depth only into one cube map face at a time, which is selected here
+// instead of amplifying triangles to all the faces by geometry shader)
+void main() {
+  // Getting model matrix
+  mat4 model = float(!INSTANCED) * MODEL + float(INSTANCED) * aModel;
+
+  // Setting vertex position and cube map face
+  vec4 worldPos  = model * vec4(aPos, 1.0f);
+  vertexWorldPos = vec3(worldPos);
+  gl_Position    = LIGHT_VP[LIGHT_LAYER] * worldPos;
+  gl_Layer       = LIGHT_LAYER;
+}
@@ -0,0 +1,81 @@
+#version 460 core
+
+// Exponent of depth warp (must match blinnPhongFS.glsl)
+const float kShadowExponent = 40.0f;
+
+// Separable Gaussian kernel (radius in moments texels, which are 2x2 depth texels)
+const int   kKernelRadius = 2;
+const float kKernelWeights[2 * kKernelRadius + 1] = {0.0625f, 0.25f, 0.375f, 0.25f, 0.0625f};
+
+uniform int   FILTER_PASS;  // 0 to turn depth into moments and blur them horizontally, 1 vertically
+uniform int   FILTER_FACE;  // cube map face of point light or -1 for shadow atlas tile
+uniform ivec4 FILTER_RECT;  // moments texels rectangle (offset and size)
+
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout (binding = 0) uniform sampler2D   DEPTH_MAP;
+layout (binding = 1) uniform samplerCube DEPTH_CUBE_MAP;
+layout (binding = 2) uniform sampler2D   BLUR_MAP;
+
+layout (rg32f, binding = 0) writeonly uniform image2D OUTPUT_IMAGE;
+
+// Gets direction to center of cube map face texel
+vec3 calcCubeMapDirection(int face, ivec2 texel, int size) {
+  vec2 uv = (vec2(texel) + 0.5f) / float(size) * 2.0f - 1.0f;
+
+  switch (face) {
+    case 0: return vec3(1.0f, -uv.y, -uv.x);
+    case 1: return vec3(-1.0f, -uv.y, uv.x);
+    case 2: return vec3(uv.x, 1.0f, uv.y);
+    case 3: return vec3(uv.x, -1.0f, -uv.y);
+    case 4: return vec3(uv.x, -uv.y, 1.0f);
+    default: return vec3(-uv.x, -uv.y, -1.0f);
+  }
+}
+
+// Gets depth moments of moments texel (average of its 2x2 depth texels)
+vec2 calcMoments(ivec2 texel) {
+  vec2 moments = vec2(0.0f);
+
+  // For each depth texel
+  for (int j = 0; j < 4; ++j) {
+    ivec2 depthTexel = (FILTER_RECT.xy + texel) * 2 + ivec2(j & 1, j >> 1);
+    float depth      = 0.0f;
+    if (FILTER_FACE < 0) {
+      depth = texelFetch(DEPTH_MAP, depthTexel, 0).r;
+    } else {
+      int size = textureSize(DEPTH_CUBE_MAP, 0).x;
+      depth    = textureLod(
+          DEPTH_CUBE_MAP,
+          calcCubeMapDirection(FILTER_FACE, depthTexel, size),
+          0.0f
+      ).r;
+    }
+
+    // Warping depth exponentially (reduces light bleeding of variance shadow maps)
+    float warpedDepth  = exp(kShadowExponent * depth);
+    moments           += vec2(warpedDepth, warpedDepth * warpedDepth);
+  }
+
+  return moments / 4.0f;
+}
+
+// Compute shader
+void main() {
+  ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+
+  // If invocation is outside of rectangle
+  if (any(greaterThanEqual(texel, FILTER_RECT.zw))) return;
+
+  // Blurring moments (taps are clamped to rectangle, so neighbouring tiles never leak in)
+  vec2 moments = vec2(0.0f);
+  for (int k = -kKernelRadius; k <= kKernelRadius; ++k) {
+    ivec2 offset   = FILTER_PASS == 0 ? ivec2(k, 0) : ivec2(0, k);
+    ivec2 tapTexel = clamp(texel + offset, ivec2(0), FILTER_RECT.zw - 1);
+    vec2  tap      = FILTER_PASS == 0 ? calcMoments(tapTexel)
+                                      : texelFetch(BLUR_MAP, FILTER_RECT.xy + tapTexel, 0).rg;
+    moments       += kKernelWeights[k + kKernelRadius] * tap;
+  }
+
+  imageStore(OUTPUT_IMAGE, FILTER_RECT.xy + texel, vec4(moments, 0.0f, 0.0f));
+}
@@ -0,0 +1,105 @@
+// Header file
+#include "./GlHandle.hpp"
+
+// STD
+#include <array>
+#include <atomic>
+
+// Global constants
+static constexpr size_t kGlObjectTypeCount = static_cast<size_t>(glengine::GlObjectType::Count);
+
+static constexpr std::array<const char *, kGlObjectTypeCount> kGlObjectTypeNames{
+    "buffer", "vertex array", "texture", "framebuffer", "renderbuffer"};
+
+// Local function headers
+static std::array<std::atomic<size_t>, kGlObjectTypeCount> &getMutableLiveGlObjectCounts();
+
+// Creates OpenGL object of type and counts it as live
+GLuint glengine::createGlObject(GlObjectType type) noexcept {
+  GLuint name{};
+  switch (type) {
+    case GlObjectType::Buffer:
+      glGenBuffers(1, &name);
+      break;
+    case GlObjectType::VertexArray:
+      glGenVertexArrays(1, &name);
+      break;
+    case GlObjectType::Texture:
+      glGenTextures(1, &name);
+      break;
+    case GlObjectType::Framebuffer:
+      glGenFramebuffers(1, &name);
+      break;
+    case GlObjectType::Renderbuffer:
+      glGenRenderbuffers(1, &name);
+      break;
+    default:
+      return 0;
+  }
+
+  if (name != 0) trackGlObject(type);
+
+  return name;
+}
+
+// Deletes OpenGL object of type and stops counting it as live
+void glengine::deleteGlObject(GlObjectType type, GLuint name) noexcept {
+  if (name == 0) return;
+
+  switch (type) {
+    case GlObjectType::Buffer:
+      glDeleteBuffers(1, &name);
+      break;
+    case GlObjectType::VertexArray:
+      glDeleteVertexArrays(1, &name);
+      break;
+    case GlObjectType::Texture:
+      glDeleteTextures(1, &name);
+      break;
+    case GlObjectType::Framebuffer:
+      glDeleteFramebuffers(1, &name);
+      break;
+    case GlObjectType::Renderbuffer:
+      glDeleteRenderbuffers(1, &name);
+      break;
+    default:
+      return;
+  }
+
+  untrackGlObject(type);
+}
+
+// Counts OpenGL object created elsewhere (for example by loadMap2D) as live
+void glengine::trackGlObject(GlObjectType type) noexcept {
+  if (type >= GlObjectType::Count) return;
+
+  ++getMutableLiveGlObjectCounts()[static_cast<size_t>(type)];
+}
+
+// Stops counting OpenGL object as live without deleting it
+void glengine::untrackGlObject(GlObjectType type) noexcept {
+  if (type >= GlObjectType::Count) return;
+
+  --getMutableLiveGlObjectCounts()[static_cast<size_t>(type)];
+}
+
+// Gets count of live OpenGL objects of type owned by handles
+size_t glengine::getLiveGlObjectCount(GlObjectType type) noexcept {
+  if (type >= GlObjectType::Count) return 0;
+
+  return getMutableLiveGlObjectCounts()[static_cast<size_t>(type)];
+}
+
+// Gets name of OpenGL object type
+const char *glengine::getGlObjectTypeName(GlObjectType type) noexcept {
+  if (type >= GlObjectType::Count) return "unknown";
+
+  return kGlObjectTypeNames[static_cast<size_t>(type)];
+}
+
+// Local function definitions
+
+static std::array<std::atomic<size_t>, kGlObjectTypeCount> &getMutableLiveGlObjectCounts() {
+  static std::array<std::atomic<size_t>, kGlObjectTypeCount> sLiveGlObjectCounts{};
+  return sLiveGlObjectCounts;
+}
@@ -0,0 +1,124 @@
+#ifndef GLENGINE_GLHANDLE_HPP
+#define GLENGINE_GLHANDLE_HPP
+
+// STD
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// OpenGL
+#include <glad/glad.h>
+
+namespace glengine {
+
+// OpenGL object type enumeration
+enum class GlObjectType : size_t {
+  Buffer,
+  VertexArray,
+  Texture,
+  Framebuffer,
+  Renderbuffer,
+  Count,
+};
+
+// Creates OpenGL object of type and counts it as live
+GLuint createGlObject(GlObjectType type) noexcept;
+
+// Deletes OpenGL object of type and stops counting it as live
+void deleteGlObject(GlObjectType type, GLuint name) noexcept;
+
+// Counts OpenGL object created elsewhere (for example by loadMap2D) as live
+void trackGlObject(GlObjectType type) noexcept;
+
+// Stops counting OpenGL object as live without deleting it
+void untrackGlObject(GlObjectType type) noexcept;
+
+// Gets count of live OpenGL objects of type owned by handles
+size_t getLiveGlObjectCount(GlObjectType type) noexcept;
+
+// Gets name of OpenGL object type
+const char *getGlObjectTypeName(GlObjectType type) noexcept;
+
+// OpenGL object handle class template (move-only owner of OpenGL object name, which deletes
+// the object on destruction; use SharedGlHandle to share the object without copying it on GPU)
+template <GlObjectType Type>
+class GlHandle {
+ private:
+  GLuint _name{};
+
+ public:
+  // Constructors, assignment operators and destructor
+  GlHandle() noexcept {}
+  explicit GlHandle(GLuint name) noexcept : _name{name} {
+    if (_name != 0) trackGlObject(Type);
+  }
+  GlHandle(const GlHandle &handle)            = delete;
+  GlHandle &operator=(const GlHandle &handle) = delete;
+  GlHandle(GlHandle &&handle) noexcept : _name{std::exchange(handle._name, 0)} {}
+  GlHandle &operator=(GlHandle &&handle) noexcept {
+    std::swap(_name, handle._name);
+
+    return *this;
+  }
+  ~GlHandle() noexcept { reset(); }
+
+  // Getters
+  GLuint get() const noexcept { return _name; }
+
+  // Other member functions
+  explicit operator bool() const noexcept { return _name != 0; }
+
+  // Deletes owned object and takes ownership of the given one
+  void reset(GLuint name = 0) noexcept {
+    if (_name != 0) deleteGlObject(Type, _name);
+    _name = name;
+    if (_name != 0) trackGlObject(Type);
+  }
+
+  // Gives up ownership of object without deleting it
+  GLuint release() noexcept {
+    if (_name != 0) untrackGlObject(Type);
+    return std::exchange(_name, 0);
+  }
+
+  // Other static member functions
+
+  // Creates handle owning a new object
+  static GlHandle create() noexcept {
+    GlHandle handle{};
+    handle._name = createGlObject(Type);
+    return handle;
+  }
+};
+
+// Shared OpenGL object handle (object is deleted when the last owner is destroyed)
+template <GlObjectType Type>
+using SharedGlHandle = std::shared_ptr<const GlHandle<Type>>;
+
+// Turns unique handle into shared one
+template <GlObjectType Type>
+SharedGlHandle<Type> shareGlHandle(GlHandle<Type> &&handle) {
+  return std::make_shared<const GlHandle<Type>>(std::move(handle));
+}
+
+// Gets object name of shared handle (zero if there is no handle)
+template <GlObjectType Type>
+GLuint getGlName(const SharedGlHandle<Type> &handlePtr) noexcept {
+  return handlePtr != nullptr ? handlePtr->get() : 0;
+}
+
+using BufferHandle       = GlHandle<GlObjectType::Buffer>;
+using VertexArrayHandle  = GlHandle<GlObjectType::VertexArray>;
+using TextureHandle      = GlHandle<GlObjectType::Texture>;
+using FramebufferHandle  = GlHandle<GlObjectType::Framebuffer>;
+using RenderbufferHandle = GlHandle<GlObjectType::Renderbuffer>;
+
+using SharedBufferHandle       = SharedGlHandle<GlObjectType::Buffer>;
+using SharedVertexArrayHandle  = SharedGlHandle<GlObjectType::VertexArray>;
+using SharedTextureHandle      = SharedGlHandle<GlObjectType::Texture>;
+using SharedFramebufferHandle  = SharedGlHandle<GlObjectType::Framebuffer>;
+using SharedRenderbufferHandle = SharedGlHandle<GlObjectType::Renderbuffer>;
+
+}  // namespace glengine
+
+#endif
@@ -166,3 +166,45 @@ void BaseCamera::lookAt(const glm::vec3 &lookAt) noexcept {
 
   recalculateViewMatrix();
 }
+
+FrustumPlanes BaseCamera::calculateFrustumPlanes() const noexcept {
+  // Extracting planes from rows of view-projection matrix (Gribb-Hartmann method)
+  const glm::mat4 viewProjMatrix{_projectionMatrix * _viewMatrix};
+  const glm::vec4 row0{viewProjMatrix[0][0], viewProjMatrix[1][0], viewProjMatrix[2][0],
+                       viewProjMatrix[3][0]};
+  const glm::vec4 row1{viewProjMatrix[0][1], viewProjMatrix[1][1], viewProjMatrix[2][1],
+                       viewProjMatrix[3][1]};
+  const glm::vec4 row2{viewProjMatrix[0][2], viewProjMatrix[1][2], viewProjMatrix[2][2],
+                       viewProjMatrix[3][2]};
+  const glm::vec4 row3{viewProjMatrix[0][3], viewProjMatrix[1][3], viewProjMatrix[2][3],
+                       viewProjMatrix[3][3]};
+
+  FrustumPlanes frustumPlanes{row3 + row0, row3 - row0, row3 + row1,
+                              row3 - row1, row3 + row2, row3 - row2};
+
+  // Normalizing planes so that plane equation gives distance
+  for (size_t i = 0; i < frustumPlanes.size(); ++i) {
+    frustumPlanes[i] /= glm::length(glm::vec3{frustumPlanes[i]});
+  }
+
+  return frustumPlanes;
+}
+
+bool BaseCamera::isSphereInFrustum(const glm::vec3 &center, float radius) const noexcept {
+  return isSphereInFrustum(calculateFrustumPlanes(), center, radius);
+}
+
+// Other static member functions
+
+bool BaseCamera::isSphereInFrustum(const FrustumPlanes &frustumPlanes, const glm::vec3 &center,
+                                   float radius) noexcept {
+  // For each frustum plane
+  for (size_t i = 0; i < frustumPlanes.size(); ++i) {
+    // If sphere is completely behind the plane
+    if (glm::dot(glm::vec3{frustumPlanes[i]}, center) + frustumPlanes[i].w < -radius) {
+      return false;
+    }
+  }
+
+  return true;
+}
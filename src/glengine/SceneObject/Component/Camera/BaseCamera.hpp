@@ -1,6 +1,9 @@
 #ifndef GLENGINE_SCENEOBJECT_COMPONENT_CAMERA_BASECAMERA_HPP
 #define GLENGINE_SCENEOBJECT_COMPONENT_CAMERA_BASECAMERA_HPP
 
+// STD
+#include <array>
+
 // GLM
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/glm.hpp>
@@ -10,6 +13,10 @@
 
 namespace glengine {
 
+// Frustum planes (left, right, bottom, top, near, far) as normalized (normal, distance) vectors
+// with normals pointing inside of the frustum
+using FrustumPlanes = std::array<glm::vec4, 6>;
+
 class BaseCamera : public Component {
  private:
   glm::vec3 _position{};
@@ -66,6 +73,13 @@ class BaseCamera : public Component {
 
   void look(const glm::vec3 &look) noexcept;
   void lookAt(const glm::vec3 &lookAt) noexcept;
+
+  FrustumPlanes calculateFrustumPlanes() const noexcept;
+  bool          isSphereInFrustum(const glm::vec3 &center, float radius) const noexcept;
+
+  // Other static member functions
+  static bool isSphereInFrustum(const FrustumPlanes &frustumPlanes, const glm::vec3 &center,
+                                float radius) noexcept;
 };
 
 }  // namespace glengine
@@ -11,7 +11,8 @@ using namespace glengine;
 
 // Local function headers
 
-void createShadowMapFramebuffer(GLuint &shadowMapFBO, GLuint &shadowMapTexture);
+static void createShadowMapFramebuffer(FramebufferHandle &shadowMapFBO,
+                                       TextureHandle     &shadowMapTexture);
 
 // Constructors, assignment operators and destructor
 
@@ -47,8 +48,8 @@ BaseLight &BaseLight::operator=(const BaseLight &light) noexcept {
 BaseLight::BaseLight(BaseLight &&light) noexcept
     : Component{dynamic_cast<Component &&>(light)},
       _color{std::exchange(light._color, glm::vec3{})},
-      _shadowMapFBO{std::exchange(light._shadowMapFBO, 0)},
-      _shadowMapTexture{std::exchange(light._shadowMapTexture, 0)} {}
+      _shadowMapFBO{std::move(light._shadowMapFBO)},
+      _shadowMapTexture{std::move(light._shadowMapTexture)} {}
 
 // Move assignment operator
 BaseLight &BaseLight::operator=(BaseLight &&light) noexcept {
@@ -61,20 +62,17 @@ BaseLight &BaseLight::operator=(BaseLight &&light) noexcept {
   return *this;
 }
 
-// Destructor
-BaseLight::~BaseLight() noexcept {
-  glDeleteTextures(1, &_shadowMapTexture);
-  glDeleteFramebuffers(1, &_shadowMapFBO);
-}
+// Destructor (shadow map FBO and texture are deleted by their handles)
+BaseLight::~BaseLight() noexcept {}
 
 // Setters
 
 void BaseLight::setColor(const glm::vec3 &color) noexcept { _color = color; }
 
-void BaseLight::setShadowMapFBO(GLuint shadowMapFBO) noexcept { _shadowMapFBO = shadowMapFBO; }
+void BaseLight::setShadowMapFBO(GLuint shadowMapFBO) noexcept { _shadowMapFBO.reset(shadowMapFBO); }
 
 void BaseLight::setShadowMapTexture(GLuint shadowMapTexture) noexcept {
-  _shadowMapTexture = shadowMapTexture;
+  _shadowMapTexture.reset(shadowMapTexture);
 }
 
 // Getters
@@ -83,13 +81,9 @@ const glm::vec3 &BaseLight::getColor() const noexcept { return _color; }
 
 glm::vec3 &BaseLight::getColor() noexcept { return _color; }
 
-GLuint BaseLight::getShadowMapFBO() const noexcept { return _shadowMapFBO; }
-
-GLuint &BaseLight::getShadowMapFBO() noexcept { return _shadowMapFBO; }
-
-GLuint BaseLight::getShadowMapTexture() const noexcept { return _shadowMapTexture; }
+GLuint BaseLight::getShadowMapFBO() const noexcept { return _shadowMapFBO.get(); }
 
-GLuint &BaseLight::getShadowMapTexture() noexcept { return _shadowMapTexture; }
+GLuint BaseLight::getShadowMapTexture() const noexcept { return _shadowMapTexture.get(); }
 
 GLsizei BaseLight::getShadowMapTextureResolution() const noexcept {
   return _shadowMapTextureResolution;
@@ -99,8 +93,9 @@ GLsizei &BaseLight::getShadowMapTextureResolution() noexcept { return _shadowMap
 
 // Local function definitions
 
-void createShadowMapFramebuffer(GLuint &shadowMapFBO, GLuint &shadowMapTexture) {
-  // Creating shadow map FBO and depth texture
-  glGenFramebuffers(1, &shadowMapFBO);
-  glGenTextures(1, &shadowMapTexture);
+static void createShadowMapFramebuffer(FramebufferHandle &shadowMapFBO,
+                                       TextureHandle     &shadowMapTexture) {
+  // Creating shadow map FBO and depth texture (replacing the previous ones deletes them)
+  shadowMapFBO     = FramebufferHandle::create();
+  shadowMapTexture = TextureHandle::create();
 }
@@ -9,6 +9,7 @@
 #include <glm/glm.hpp>
 
 // "glengine" internal library
+#include "../../../GlHandle.hpp"
 #include "../Component.hpp"
 
 namespace glengine {
@@ -21,9 +22,11 @@ class BaseLight : public Component {
   glm::vec3 _color{};
 
  protected:
-  GLuint  _shadowMapFBO{};
-  GLuint  _shadowMapTexture{};
-  GLsizei _shadowMapTextureResolution{kInitShadowMapTextureResolution};
+  // Owned by light only (no storage is allocated for them: shadow maps are taken from shadow
+  // atlas and shadow cube map pool, and resolution is the largest one requested from them)
+  FramebufferHandle _shadowMapFBO{};
+  TextureHandle     _shadowMapTexture{};
+  GLsizei           _shadowMapTextureResolution{kInitShadowMapTextureResolution};
 
  protected:
   // Constructors, assignment operators and destructor
@@ -46,9 +49,7 @@ class BaseLight : public Component {
   const glm::vec3 &getColor() const noexcept;
   glm::vec3       &getColor() noexcept;
   GLuint           getShadowMapFBO() const noexcept;
-  GLuint          &getShadowMapFBO() noexcept;
   GLuint           getShadowMapTexture() const noexcept;
-  GLuint          &getShadowMapTexture() noexcept;
   GLsizei          getShadowMapTextureResolution() const noexcept;
   GLsizei         &getShadowMapTextureResolution() noexcept;
 };
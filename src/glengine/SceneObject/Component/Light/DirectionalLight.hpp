@@ -6,10 +6,14 @@
 
 namespace glengine {
 
-// Directional light class
+constexpr unsigned int kInitShadowCascadeCount = 3;
+constexpr unsigned int kMaxShadowCascadeCount  = 4;
+
+// Directional light class (its shadow map is split into cascades along camera view depth)
 class DirectionalLight : virtual public BaseLight {
  private:
-  glm::vec3 _direction{};
+  glm::vec3    _direction{};
+  unsigned int _cascadeCount{kInitShadowCascadeCount};
 
  public:
   // Constructors, assignment operators and destructor
@@ -25,11 +29,13 @@ class DirectionalLight : virtual public BaseLight {
 
   // Setters
   void setDirection(const glm::vec3 &direction) noexcept;
+  void setCascadeCount(unsigned int cascadeCount) noexcept;
   void setShadowMapTextureResolution(GLsizei shadowMapTextureResolution) noexcept override;
 
   // Getters
   const glm::vec3 &getDirection() const noexcept;
   glm::vec3       &getDirection() noexcept;
+  unsigned int     getCascadeCount() const noexcept;
 };
 
 }  // namespace glengine
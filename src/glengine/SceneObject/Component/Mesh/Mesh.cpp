@@ -2,10 +2,26 @@
 #include "./Mesh.hpp"
 
 // STD
+#include <algorithm>
+#include <cmath>
 #include <utility>
 
+// "glengine" internal library
+#include "../../../shader/uniformCache.hpp"
+
 using namespace glengine;
 
+// Uniform handles
+static const UniformHandle kMaterialAlbedoMapUniform = registerUniform("MATERIAL.albedoMap");
+static const UniformHandle kMaterialNormalMapUniform = registerUniform("MATERIAL.normalMap");
+static const UniformHandle kMaterialDepthMapUniform  = registerUniform("MATERIAL.depthMap");
+static const UniformHandle kMaterialAmbOccMapUniform = registerUniform("MATERIAL.ambOccMap");
+static const UniformHandle kMaterialGlossMapUniform  = registerUniform("MATERIAL.glossMap");
+static const UniformHandle kMaterialEmissMapUniform  = registerUniform("MATERIAL.emissMap");
+static const UniformHandle kMaterialEnvMapUniform    = registerUniform("MATERIAL.envMap");
+static const UniformHandle kMaterialParallaxUniform  = registerUniform("MATERIAL.parallaxStrength");
+static const UniformHandle kInstancedUniform         = registerUniform("INSTANCED");
+
 // Constructors, assignment operators and destructor
 
 // Default constructor
@@ -16,9 +32,9 @@ Mesh::Mesh(GLuint vao, GLuint vbo, GLuint ebo, GLsizei indexCount, GLsizei insta
            GLint patchVertices, GLuint shaderProgram,
            const std::shared_ptr<Material> &materialPtr) noexcept
     : Component{ComponentType::Mesh},
-      _vao{vao},
-      _vbo{vbo},
-      _ebo{ebo},
+      _vaoPtr{shareGlHandle(VertexArrayHandle{vao})},
+      _vboPtr{shareGlHandle(BufferHandle{vbo})},
+      _eboPtr{shareGlHandle(BufferHandle{ebo})},
       _indexCount{indexCount},
       _instanceCount{instanceCount},
       _patchVertices{patchVertices},
@@ -36,20 +52,20 @@ Mesh::Mesh(const std::vector<VBOAttribute> &vboAttributes, const std::vector<flo
       _shaderProgram{shaderProgram},
       _materialPtr{materialPtr} {
   // Creating VAO, VBO and EBO
-  glGenVertexArrays(1, &_vao);
-  glGenBuffers(1, &_vbo);
-  glGenBuffers(1, &_ebo);
+  _vaoPtr = shareGlHandle(VertexArrayHandle::create());
+  _vboPtr = shareGlHandle(BufferHandle::create());
+  _eboPtr = shareGlHandle(BufferHandle::create());
 
   // Binding VAO to bind to it vertex attributes and EBO and then configure them
-  glBindVertexArray(_vao);
+  glBindVertexArray(_vaoPtr->get());
 
   // Binding and filling VBO
-  glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+  glBindBuffer(GL_ARRAY_BUFFER, _vboPtr->get());
   glBufferData(GL_ARRAY_BUFFER, vertexBuffer.size() * sizeof(float), &vertexBuffer[0],
                GL_STATIC_DRAW);
 
   // Binding and filling EBO
-  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _eboPtr->get());
   glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), &indices[0],
                GL_STATIC_DRAW);
 
@@ -64,32 +80,74 @@ Mesh::Mesh(const std::vector<VBOAttribute> &vboAttributes, const std::vector<flo
   // Unbinding configured VAO and VBO
   glBindVertexArray(0);
   glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+  // If the first VBO attribute is not a float position there are no bounding volumes
+  if (vboAttributes.empty() || vboAttributes[0].size < 3 || vboAttributes[0].type != GL_FLOAT) {
+    return;
+  }
+
+  // Getting position stride and offset in floats
+  const size_t positionStride = vboAttributes[0].stride > 0
+                                    ? vboAttributes[0].stride / sizeof(float)
+                                    : static_cast<size_t>(vboAttributes[0].size);
+  const size_t positionOffset = reinterpret_cast<size_t>(vboAttributes[0].pointer) / sizeof(float);
+  if (vertexBuffer.size() < positionOffset + 3) return;
+
+  // Calculating AABB of vertex positions
+  glm::vec3 aabbMin{vertexBuffer[positionOffset], vertexBuffer[positionOffset + 1],
+                    vertexBuffer[positionOffset + 2]};
+  glm::vec3 aabbMax{aabbMin};
+  for (size_t i = positionOffset; i + 2 < vertexBuffer.size(); i += positionStride) {
+    const glm::vec3 position{vertexBuffer[i], vertexBuffer[i + 1], vertexBuffer[i + 2]};
+    aabbMin = glm::min(aabbMin, position);
+    aabbMax = glm::max(aabbMax, position);
+  }
+  _aabbMin = aabbMin;
+  _aabbMax = aabbMax;
+
+  // Calculating bounding sphere around AABB center (tighter than the AABB circumsphere)
+  _boundingSphereCenter = (aabbMin + aabbMax) / 2.0f;
+  float maxSquaredDistance{};
+  for (size_t i = positionOffset; i + 2 < vertexBuffer.size(); i += positionStride) {
+    const glm::vec3 position{vertexBuffer[i], vertexBuffer[i + 1], vertexBuffer[i + 2]};
+    const glm::vec3 offset{position - _boundingSphereCenter};
+    maxSquaredDistance = std::max(maxSquaredDistance, glm::dot(offset, offset));
+  }
+  _boundingSphereRadius = std::sqrt(maxSquaredDistance);
 }
 
-// Copy constructor
+// Copy constructor (shares VAO, VBO and EBO)
 Mesh::Mesh(const Mesh &mesh) noexcept
     : Component{dynamic_cast<const Component &>(mesh)},
-      _vao{mesh._vao},
-      _vbo{mesh._vbo},
-      _ebo{mesh._ebo},
+      _vaoPtr{mesh._vaoPtr},
+      _vboPtr{mesh._vboPtr},
+      _eboPtr{mesh._eboPtr},
       _indexCount{mesh._indexCount},
       _instanceCount{mesh._instanceCount},
       _patchVertices{mesh._patchVertices},
       _shaderProgram{mesh._shaderProgram},
-      _materialPtr{mesh._materialPtr} {}
+      _materialPtr{mesh._materialPtr},
+      _aabbMin{mesh._aabbMin},
+      _aabbMax{mesh._aabbMax},
+      _boundingSphereCenter{mesh._boundingSphereCenter},
+      _boundingSphereRadius{mesh._boundingSphereRadius} {}
 
-// Copy assignment operator
+// Copy assignment operator (shares VAO, VBO and EBO)
 Mesh &Mesh::operator=(const Mesh &mesh) noexcept {
   Component::operator=(dynamic_cast<const Component &>(mesh));
 
-  _vao           = mesh._vao;
-  _vbo           = mesh._vbo;
-  _ebo           = mesh._ebo;
-  _indexCount    = mesh._indexCount;
-  _instanceCount = mesh._instanceCount;
-  _patchVertices = mesh._patchVertices;
-  _shaderProgram = mesh._shaderProgram;
-  _materialPtr   = mesh._materialPtr;
+  _vaoPtr               = mesh._vaoPtr;
+  _vboPtr               = mesh._vboPtr;
+  _eboPtr               = mesh._eboPtr;
+  _indexCount           = mesh._indexCount;
+  _instanceCount        = mesh._instanceCount;
+  _patchVertices        = mesh._patchVertices;
+  _shaderProgram        = mesh._shaderProgram;
+  _materialPtr          = mesh._materialPtr;
+  _aabbMin              = mesh._aabbMin;
+  _aabbMax              = mesh._aabbMax;
+  _boundingSphereCenter = mesh._boundingSphereCenter;
+  _boundingSphereRadius = mesh._boundingSphereRadius;
 
   return *this;
 }
@@ -97,45 +155,49 @@ Mesh &Mesh::operator=(const Mesh &mesh) noexcept {
 // Move constructor
 Mesh::Mesh(Mesh &&mesh) noexcept
     : Component{dynamic_cast<Component &&>(mesh)},
-      _vao{std::exchange(mesh._vao, 0)},
-      _vbo{std::exchange(mesh._vbo, 0)},
-      _ebo{std::exchange(mesh._ebo, 0)},
+      _vaoPtr{std::exchange(mesh._vaoPtr, SharedVertexArrayHandle{})},
+      _vboPtr{std::exchange(mesh._vboPtr, SharedBufferHandle{})},
+      _eboPtr{std::exchange(mesh._eboPtr, SharedBufferHandle{})},
       _indexCount{std::exchange(mesh._indexCount, 0)},
       _instanceCount{std::exchange(mesh._instanceCount, 0)},
       _patchVertices{std::exchange(mesh._patchVertices, 0)},
       _shaderProgram{std::exchange(mesh._shaderProgram, 0)},
-      _materialPtr{std::exchange(mesh._materialPtr, std::shared_ptr<Material>{})} {}
+      _materialPtr{std::exchange(mesh._materialPtr, std::shared_ptr<Material>{})},
+      _aabbMin{std::exchange(mesh._aabbMin, glm::vec3{})},
+      _aabbMax{std::exchange(mesh._aabbMax, glm::vec3{})},
+      _boundingSphereCenter{std::exchange(mesh._boundingSphereCenter, glm::vec3{})},
+      _boundingSphereRadius{std::exchange(mesh._boundingSphereRadius, -1.0f)} {}
 
 // Move assignment operator
 Mesh &Mesh::operator=(Mesh &&mesh) noexcept {
   Component::operator=(dynamic_cast<Component &&>(mesh));
 
-  std::swap(_vao, mesh._vao);
-  std::swap(_vbo, mesh._vbo);
-  std::swap(_ebo, mesh._ebo);
+  std::swap(_vaoPtr, mesh._vaoPtr);
+  std::swap(_vboPtr, mesh._vboPtr);
+  std::swap(_eboPtr, mesh._eboPtr);
   std::swap(_indexCount, mesh._indexCount);
   std::swap(_instanceCount, mesh._instanceCount);
   std::swap(_patchVertices, mesh._patchVertices);
   std::swap(_shaderProgram, mesh._shaderProgram);
   std::swap(_materialPtr, mesh._materialPtr);
+  std::swap(_aabbMin, mesh._aabbMin);
+  std::swap(_aabbMax, mesh._aabbMax);
+  std::swap(_boundingSphereCenter, mesh._boundingSphereCenter);
+  std::swap(_boundingSphereRadius, mesh._boundingSphereRadius);
 
   return *this;
 }
 
-// Destructor
-Mesh::~Mesh() noexcept {
-  glDeleteVertexArrays(1, &_vao);
-  glDeleteBuffers(1, &_vbo);
-  glDeleteBuffers(1, &_ebo);
-}
+// Destructor (VAO, VBO and EBO are deleted with the last mesh sharing them)
+Mesh::~Mesh() noexcept {}
 
 // Setters
 
-void Mesh::setVAO(GLuint vao) noexcept { _vao = vao; }
+void Mesh::setVAO(GLuint vao) noexcept { _vaoPtr = shareGlHandle(VertexArrayHandle{vao}); }
 
-void Mesh::setVBO(GLuint vbo) noexcept { _vbo = vbo; }
+void Mesh::setVBO(GLuint vbo) noexcept { _vboPtr = shareGlHandle(BufferHandle{vbo}); }
 
-void Mesh::setEBO(GLuint ebo) noexcept { _ebo = ebo; }
+void Mesh::setEBO(GLuint ebo) noexcept { _eboPtr = shareGlHandle(BufferHandle{ebo}); }
 
 void Mesh::setIndexCount(GLsizei indexCount) noexcept { _indexCount = indexCount; }
 
@@ -149,19 +211,34 @@ void Mesh::setMaterialPtr(const std::shared_ptr<Material> &materialPtr) noexcept
   _materialPtr = materialPtr;
 }
 
+void Mesh::setAABB(const glm::vec3 &aabbMin, const glm::vec3 &aabbMax) noexcept {
+  _aabbMin = aabbMin;
+  _aabbMax = aabbMax;
+
+  // Enclosing AABB with bounding sphere
+  _boundingSphereCenter = (aabbMin + aabbMax) / 2.0f;
+  _boundingSphereRadius = glm::length(aabbMax - aabbMin) / 2.0f;
+}
+
+void Mesh::setBoundingSphere(const glm::vec3 &boundingSphereCenter,
+                             float            boundingSphereRadius) noexcept {
+  _boundingSphereCenter = boundingSphereCenter;
+  _boundingSphereRadius = boundingSphereRadius;
+}
+
 // Getters
 
-GLuint Mesh::getVAO() const noexcept { return _vao; }
+GLuint Mesh::getVAO() const noexcept { return getGlName(_vaoPtr); }
 
-GLuint &Mesh::getVAO() noexcept { return _vao; }
+GLuint Mesh::getVBO() const noexcept { return getGlName(_vboPtr); }
 
-GLuint Mesh::getVBO() const noexcept { return _vbo; }
+GLuint Mesh::getEBO() const noexcept { return getGlName(_eboPtr); }
 
-GLuint &Mesh::getVBO() noexcept { return _vbo; }
+const SharedVertexArrayHandle &Mesh::getVAOPtr() const noexcept { return _vaoPtr; }
 
-GLuint Mesh::getEBO() const noexcept { return _ebo; }
+const SharedBufferHandle &Mesh::getVBOPtr() const noexcept { return _vboPtr; }
 
-GLuint &Mesh::getEBO() noexcept { return _ebo; }
+const SharedBufferHandle &Mesh::getEBOPtr() const noexcept { return _eboPtr; }
 
 GLsizei Mesh::getIndexCount() const noexcept { return _indexCount; }
 
@@ -185,6 +262,14 @@ const std::shared_ptr<Mesh::Material> &Mesh::getMaterialPtr() const noexcept {
 
 std::shared_ptr<Mesh::Material> &Mesh::getMaterialPtr() noexcept { return _materialPtr; }
 
+const glm::vec3 &Mesh::getAABBMin() const noexcept { return _aabbMin; }
+
+const glm::vec3 &Mesh::getAABBMax() const noexcept { return _aabbMax; }
+
+const glm::vec3 &Mesh::getBoundingSphereCenter() const noexcept { return _boundingSphereCenter; }
+
+float Mesh::getBoundingSphereRadius() const noexcept { return _boundingSphereRadius; }
+
 // Other member functions
 
 void Mesh::render() const noexcept {
@@ -193,7 +278,7 @@ void Mesh::render() const noexcept {
   const Mesh::Material &material = *_materialPtr;
 
   // Binding VAO with associated VBO and EBO
-  glBindVertexArray(_vao);
+  glBindVertexArray(getVAO());
 
   // For each texture
   for (size_t i = 0; i < material.getTexturePtrs().size(); ++i) {
@@ -210,37 +295,22 @@ void Mesh::render() const noexcept {
   glUseProgram(_shaderProgram);
 
   // Updating object shader program uniform values
-  glUniform1i(glGetUniformLocation(_shaderProgram, "MATERIAL.albedoMap"), 0);
-  glUniform1i(glGetUniformLocation(_shaderProgram, "MATERIAL.normalMap"), 1);
-  glUniform1i(glGetUniformLocation(_shaderProgram, "MATERIAL.depthMap"), 2);
-  glUniform1i(glGetUniformLocation(_shaderProgram, "MATERIAL.ambOccMap"), 3);
-  glUniform1i(glGetUniformLocation(_shaderProgram, "MATERIAL.glossMap"), 4);
-  glUniform1i(glGetUniformLocation(_shaderProgram, "MATERIAL.emissMap"), 5);
-  glUniform1i(glGetUniformLocation(_shaderProgram, "MATERIAL.envMap"), 6);
-  glUniform1f(glGetUniformLocation(_shaderProgram, "MATERIAL.parallaxStrength"),
+  glUniform1i(getUniformLocation(_shaderProgram, kMaterialAlbedoMapUniform), 0);
+  glUniform1i(getUniformLocation(_shaderProgram, kMaterialNormalMapUniform), 1);
+  glUniform1i(getUniformLocation(_shaderProgram, kMaterialDepthMapUniform), 2);
+  glUniform1i(getUniformLocation(_shaderProgram, kMaterialAmbOccMapUniform), 3);
+  glUniform1i(getUniformLocation(_shaderProgram, kMaterialGlossMapUniform), 4);
+  glUniform1i(getUniformLocation(_shaderProgram, kMaterialEmissMapUniform), 5);
+  glUniform1i(getUniformLocation(_shaderProgram, kMaterialEnvMapUniform), 6);
+  glUniform1f(getUniformLocation(_shaderProgram, kMaterialParallaxUniform),
               _materialPtr->getParallaxStrength());
 
   // If instanced
-  glUniform1i(glGetUniformLocation(_shaderProgram, "INSTANCED"),
+  glUniform1i(getUniformLocation(_shaderProgram, kInstancedUniform),
               static_cast<int>(_instanceCount > 1));
 
   // Drawing mesh
-  // If tessellation is required
-  if (_patchVertices > 0) {
-    glPatchParameteri(GL_PATCH_VERTICES, _patchVertices);
-    // If patch is triangle
-    if (_patchVertices == 3) {
-      glDrawElementsInstanced(GL_PATCHES, _indexCount, GL_UNSIGNED_INT, nullptr, _instanceCount);
-    }
-    // If patch is quad or anything else
-    else {
-      glDrawArraysInstanced(GL_PATCHES, 0, _indexCount / 6 * _patchVertices, _instanceCount);
-    }
-  }
-  // If tessellation is not required
-  else {
-    glDrawElementsInstanced(GL_TRIANGLES, _indexCount, GL_UNSIGNED_INT, nullptr, _instanceCount);
-  }
+  draw();
 
   // Unbinding shader program
   glUseProgram(0);
@@ -260,8 +330,31 @@ void Mesh::render() const noexcept {
   glBindVertexArray(0);
 }
 
+void Mesh::draw() const noexcept {
+  if (!isComplete()) return;
+
+  // If tessellation is required
+  if (_patchVertices > 0) {
+    glPatchParameteri(GL_PATCH_VERTICES, _patchVertices);
+    // If patch is triangle
+    if (_patchVertices == 3) {
+      glDrawElementsInstanced(GL_PATCHES, _indexCount, GL_UNSIGNED_INT, nullptr, _instanceCount);
+    }
+    // If patch is quad or anything else
+    else {
+      glDrawArraysInstanced(GL_PATCHES, 0, _indexCount / 6 * _patchVertices, _instanceCount);
+    }
+  }
+  // If tessellation is not required
+  else {
+    glDrawElementsInstanced(GL_TRIANGLES, _indexCount, GL_UNSIGNED_INT, nullptr, _instanceCount);
+  }
+}
+
 bool Mesh::isComplete() const noexcept {
-  return _vao > 0 && _vbo > 0 && _ebo > 0 && _indexCount > 0 && _instanceCount > 0 &&
+  return getVAO() > 0 && getVBO() > 0 && getEBO() > 0 && _indexCount > 0 && _instanceCount > 0 &&
          _shaderProgram > 0 && _materialPtr != nullptr &&
          (_patchVertices == 0 || _patchVertices == 3 || _patchVertices == 4);
 }
+
+bool Mesh::hasBoundingVolume() const noexcept { return _boundingSphereRadius >= 0.0f; }
@@ -15,6 +15,7 @@
 #include <glm/glm.hpp>
 
 // "glengine" internal library
+#include "../../../GlHandle.hpp"
 #include "../Component.hpp"
 
 namespace glengine {
@@ -42,9 +43,9 @@ class Mesh : public Component {
     // Texture class
     class Texture {
      private:
-      GLuint _name{};
-      int    _unit{};
-      bool   _isCubemap{};
+      SharedTextureHandle _handlePtr{};
+      int                 _unit{};
+      bool                _isCubemap{};
 
      public:
       // Constructors, assignment operators and destructor
@@ -58,16 +59,17 @@ class Mesh : public Component {
 
       // Setters
       void setName(GLuint name) noexcept;
+      void setHandlePtr(const SharedTextureHandle &handlePtr) noexcept;
       void setUnit(int unit) noexcept;
       void setIsCubemap(bool isCubemap) noexcept;
 
       // Getters
-      GLuint  getName() const noexcept;
-      GLuint &getName() noexcept;
-      int     getUnit() const noexcept;
-      int    &getUnit() noexcept;
-      bool    getIsCubemap() const noexcept;
-      bool   &getIsCubemap() noexcept;
+      GLuint                     getName() const noexcept;
+      const SharedTextureHandle &getHandlePtr() const noexcept;
+      int                        getUnit() const noexcept;
+      int                       &getUnit() noexcept;
+      bool                       getIsCubemap() const noexcept;
+      bool                      &getIsCubemap() noexcept;
     };
 
    private:
@@ -98,10 +100,11 @@ class Mesh : public Component {
   };
 
  private:
-  GLuint  _vao{};
-  GLuint  _vbo{};
-  GLuint  _ebo{};
-  GLsizei _indexCount{};
+  // Shared between copies of mesh (deleted with the last copy)
+  SharedVertexArrayHandle _vaoPtr{};
+  SharedBufferHandle      _vboPtr{};
+  SharedBufferHandle      _eboPtr{};
+  GLsizei                 _indexCount{};
 
   GLsizei _instanceCount{};
 
@@ -111,6 +114,12 @@ class Mesh : public Component {
 
   std::shared_ptr<Material> _materialPtr{};
 
+  // Model space bounding volumes (meshes with negative bounding sphere radius are never culled)
+  glm::vec3 _aabbMin{};
+  glm::vec3 _aabbMax{};
+  glm::vec3 _boundingSphereCenter{};
+  float     _boundingSphereRadius{-1.0f};
+
  public:
   // Constructors, assignment operators and destructor
   Mesh() noexcept;
@@ -135,14 +144,17 @@ class Mesh : public Component {
   void setPatchVertices(GLint patchVertices) noexcept;
   void setShaderProgram(GLuint shaderProgram) noexcept;
   void setMaterialPtr(const std::shared_ptr<Material> &materialPtr) noexcept;
+  void setAABB(const glm::vec3 &aabbMin, const glm::vec3 &aabbMax) noexcept;
+  void setBoundingSphere(const glm::vec3 &boundingSphereCenter,
+                         float            boundingSphereRadius) noexcept;
 
   // Getters
   GLuint                           getVAO() const noexcept;
-  GLuint                          &getVAO() noexcept;
   GLuint                           getVBO() const noexcept;
-  GLuint                          &getVBO() noexcept;
   GLuint                           getEBO() const noexcept;
-  GLuint                          &getEBO() noexcept;
+  const SharedVertexArrayHandle   &getVAOPtr() const noexcept;
+  const SharedBufferHandle        &getVBOPtr() const noexcept;
+  const SharedBufferHandle        &getEBOPtr() const noexcept;
   GLsizei                          getIndexCount() const noexcept;
   GLsizei                         &getIndexCount() noexcept;
   GLsizei                          getInstanceCount() const noexcept;
@@ -153,11 +165,17 @@ class Mesh : public Component {
   GLuint                          &getShaderProgram() noexcept;
   const std::shared_ptr<Material> &getMaterialPtr() const noexcept;
   std::shared_ptr<Material>       &getMaterialPtr() noexcept;
+  const glm::vec3                 &getAABBMin() const noexcept;
+  const glm::vec3                 &getAABBMax() const noexcept;
+  const glm::vec3                 &getBoundingSphereCenter() const noexcept;
+  float                            getBoundingSphereRadius() const noexcept;
 
   // Other member functions
   void render() const noexcept;
+  void draw() const noexcept;
 
   bool isComplete() const noexcept;
+  bool hasBoundingVolume() const noexcept;
 };
 
 // Generates vertex buffer based on vertices, normals, tangents and uvs
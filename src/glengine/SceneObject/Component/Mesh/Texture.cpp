@@ -11,17 +11,17 @@ using namespace glengine;
 // Default constructor
 Mesh::Material::Texture::Texture() noexcept {}
 
-// Parameterized constructor
+// Parameterized constructor (takes ownership of texture name)
 Mesh::Material::Texture::Texture(GLuint name, int unit, bool isCubemap) noexcept
-    : _name{name}, _unit{unit}, _isCubemap{isCubemap} {}
+    : _handlePtr{shareGlHandle(TextureHandle{name})}, _unit{unit}, _isCubemap{isCubemap} {}
 
-// Copy constructor
+// Copy constructor (shares texture name)
 Mesh::Material::Texture::Texture(const Texture &texture) noexcept
-    : _name{texture._name}, _unit{texture._unit}, _isCubemap{texture._isCubemap} {}
+    : _handlePtr{texture._handlePtr}, _unit{texture._unit}, _isCubemap{texture._isCubemap} {}
 
-// Copy assignment operator
+// Copy assignment operator (shares texture name)
 Mesh::Material::Texture &Mesh::Material::Texture::operator=(const Texture &texture) noexcept {
-  _name      = texture._name;
+  _handlePtr = texture._handlePtr;
   _unit      = texture._unit;
   _isCubemap = texture._isCubemap;
 
@@ -30,25 +30,31 @@ Mesh::Material::Texture &Mesh::Material::Texture::operator=(const Texture &textu
 
 // Move constructor
 Mesh::Material::Texture::Texture(Texture &&texture) noexcept
-    : _name{std::exchange(texture._name, 0)},
+    : _handlePtr{std::exchange(texture._handlePtr, SharedTextureHandle{})},
       _unit{std::exchange(texture._unit, 0)},
       _isCubemap{std::exchange(texture._isCubemap, false)} {}
 
 // Move assignment operator
 Mesh::Material::Texture &Mesh::Material::Texture::operator=(Texture &&texture) noexcept {
-  std::swap(_name, texture._name);
+  std::swap(_handlePtr, texture._handlePtr);
   std::swap(_unit, texture._unit);
   std::swap(_isCubemap, texture._isCubemap);
 
   return *this;
 }
 
-// Destructor
-Mesh::Material::Texture::~Texture() noexcept { glDeleteTextures(1, &_name); }
+// Destructor (texture name is deleted with the last texture sharing it)
+Mesh::Material::Texture::~Texture() noexcept {}
 
 // Setters
 
-void Mesh::Material::Texture::setName(GLuint name) noexcept { _name = name; }
+void Mesh::Material::Texture::setName(GLuint name) noexcept {
+  _handlePtr = shareGlHandle(TextureHandle{name});
+}
+
+void Mesh::Material::Texture::setHandlePtr(const SharedTextureHandle &handlePtr) noexcept {
+  _handlePtr = handlePtr;
+}
 
 void Mesh::Material::Texture::setUnit(int unit) noexcept { _unit = unit; }
 
@@ -56,9 +62,11 @@ void Mesh::Material::Texture::setIsCubemap(bool isCubemap) noexcept { _isCubemap
 
 // Getters
 
-GLuint Mesh::Material::Texture::getName() const noexcept { return _name; }
+GLuint Mesh::Material::Texture::getName() const noexcept { return getGlName(_handlePtr); }
 
-GLuint &Mesh::Material::Texture::getName() noexcept { return _name; }
+const SharedTextureHandle &Mesh::Material::Texture::getHandlePtr() const noexcept {
+  return _handlePtr;
+}
 
 int Mesh::Material::Texture::getUnit() const noexcept { return _unit; }
 
@@ -0,0 +1,481 @@
+// Header file
+#include "./RenderQueue.hpp"
+
+// STD
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <utility>
+
+// GLM
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtc/type_ptr.hpp>
+
+// "glengine" internal library
+#include "../jobs/JobSystem.hpp"
+#include "../shader/uniformCache.hpp"
+
+using namespace glengine;
+
+// Global constants
+
+// Sort key layout (from the most significant bits): pass, program, material, VAO, depth
+static constexpr unsigned int kPassKeyBits      = 4;
+static constexpr unsigned int kProgramKeyBits   = 12;
+static constexpr unsigned int kMaterialKeyBits  = 12;
+static constexpr unsigned int kVAOKeyBits       = 12;
+static constexpr unsigned int kDepthKeyBits     = 24;
+static constexpr unsigned int kDepthKeyShift    = 0;
+static constexpr unsigned int kVAOKeyShift      = kDepthKeyShift + kDepthKeyBits;
+static constexpr unsigned int kMaterialKeyShift = kVAOKeyShift + kVAOKeyBits;
+static constexpr unsigned int kProgramKeyShift  = kMaterialKeyShift + kMaterialKeyBits;
+static constexpr unsigned int kPassKeyShift     = kProgramKeyShift + kProgramKeyBits;
+
+static_assert(kPassKeyShift + kPassKeyBits == 64, "Sort key must occupy exactly 64 bits");
+static_assert(RenderQueue::kMaxPassCount == 1u << kPassKeyBits,
+              "Maximal pass count must match pass key bits");
+
+// Scene objects culled by a single job
+static constexpr size_t kPushGrainSize = 64;
+
+// Texture units used by materials (shadow maps and other textures follow them)
+static constexpr unsigned int kMaterialTextureUnitCount = 7;
+
+// Uniform handles
+static const UniformHandle kModelUniform             = registerUniform("MODEL");
+static const UniformHandle kLightColorUniform        = registerUniform("LIGHT_COLOR");
+static const UniformHandle kExposureUniform          = registerUniform("EXPOSURE");
+static const UniformHandle kMaterialAlbedoMapUniform = registerUniform("MATERIAL.albedoMap");
+static const UniformHandle kMaterialNormalMapUniform = registerUniform("MATERIAL.normalMap");
+static const UniformHandle kMaterialDepthMapUniform  = registerUniform("MATERIAL.depthMap");
+static const UniformHandle kMaterialAmbOccMapUniform = registerUniform("MATERIAL.ambOccMap");
+static const UniformHandle kMaterialGlossMapUniform  = registerUniform("MATERIAL.glossMap");
+static const UniformHandle kMaterialEmissMapUniform  = registerUniform("MATERIAL.emissMap");
+static const UniformHandle kMaterialEnvMapUniform    = registerUniform("MATERIAL.envMap");
+static const UniformHandle kMaterialParallaxUniform  = registerUniform("MATERIAL.parallaxStrength");
+static const UniformHandle kInstancedUniform         = registerUniform("INSTANCED");
+
+// Local function headers
+template <typename T>
+static uint64_t getSortId(std::unordered_map<T, uint64_t> &sortIds, const T &object);
+static uint64_t calculateDepthKey(const SceneObject &sceneObject, const BaseCamera &camera);
+static void     collectDrawItems(const SceneObject &sceneObject, unsigned int pass,
+                                 const BaseCamera &camera, const FrustumPlanes &frustumPlanes,
+                                 GLuint                              shaderProgramOverride,
+                                 std::vector<RenderQueue::DrawItem> &drawItems,
+                                 CullingStats                       &cullingStats);
+
+// Constructors, assignment operators and destructor
+
+// Default constructor
+RenderQueue::RenderQueue() noexcept {}
+
+// Copy constructor
+RenderQueue::RenderQueue(const RenderQueue &renderQueue) noexcept
+    : _drawItems{renderQueue._drawItems},
+      _isSorted{renderQueue._isSorted},
+      _programIds{renderQueue._programIds},
+      _materialIds{renderQueue._materialIds},
+      _vaoIds{renderQueue._vaoIds},
+      _passStats{renderQueue._passStats} {}
+
+// Copy assignment operator
+RenderQueue &RenderQueue::operator=(const RenderQueue &renderQueue) noexcept {
+  _drawItems   = renderQueue._drawItems;
+  _isSorted    = renderQueue._isSorted;
+  _programIds  = renderQueue._programIds;
+  _materialIds = renderQueue._materialIds;
+  _vaoIds      = renderQueue._vaoIds;
+  _passStats   = renderQueue._passStats;
+
+  return *this;
+}
+
+// Move constructor
+RenderQueue::RenderQueue(RenderQueue &&renderQueue) noexcept
+    : _drawItems{std::move(renderQueue._drawItems)},
+      _isSorted{std::exchange(renderQueue._isSorted, true)},
+      _programIds{std::move(renderQueue._programIds)},
+      _materialIds{std::move(renderQueue._materialIds)},
+      _vaoIds{std::move(renderQueue._vaoIds)},
+      _passStats{renderQueue._passStats} {}
+
+// Move assignment operator
+RenderQueue &RenderQueue::operator=(RenderQueue &&renderQueue) noexcept {
+  std::swap(_drawItems, renderQueue._drawItems);
+  std::swap(_isSorted, renderQueue._isSorted);
+  std::swap(_programIds, renderQueue._programIds);
+  std::swap(_materialIds, renderQueue._materialIds);
+  std::swap(_vaoIds, renderQueue._vaoIds);
+  std::swap(_passStats, renderQueue._passStats);
+
+  return *this;
+}
+
+// Destructor
+RenderQueue::~RenderQueue() noexcept {}
+
+// Getters
+
+const std::vector<RenderQueue::DrawItem> &RenderQueue::getDrawItems() const noexcept {
+  return _drawItems;
+}
+
+const RenderPassStats &RenderQueue::getPassStats(unsigned int pass) const noexcept {
+  return _passStats[pass % kMaxPassCount];
+}
+
+// Other member functions
+
+void RenderQueue::push(const SceneObject &sceneObject, unsigned int pass,
+                       const BaseCamera &camera, GLuint shaderProgramOverride) noexcept {
+  _pushedDrawItems.clear();
+
+  // Culling meshes of scene object and collecting their draw items
+  CullingStats cullingStats{};
+  collectDrawItems(sceneObject, pass, camera, camera.calculateFrustumPlanes(),
+                   shaderProgramOverride, _pushedDrawItems, cullingStats);
+  SceneObject::addCullingStats(cullingStats);
+
+  // For each draw item
+  for (size_t i = 0; i < _pushedDrawItems.size(); ++i) {
+    pushDrawItem(_pushedDrawItems[i]);
+  }
+}
+
+// Pushes draw items of scene objects (chunks of scene objects are culled in parallel if job
+// system is given, while sort identifiers are assigned on the calling thread afterwards
+// in order of scene objects, so sort keys match the ones of pushing scene objects one by one)
+void RenderQueue::push(const std::vector<SceneObject> &sceneObjects, unsigned int pass,
+                       const BaseCamera &camera, GLuint shaderProgramOverride,
+                       JobSystem *jobSystemPtr) noexcept {
+  const FrustumPlanes frustumPlanes{camera.calculateFrustumPlanes()};
+  const size_t        chunkCount = (sceneObjects.size() + kPushGrainSize - 1) / kPushGrainSize;
+  if (_chunkDrawItems.size() < chunkCount) _chunkDrawItems.resize(chunkCount);
+  _chunkCullingStats.assign(chunkCount, CullingStats{});
+
+  // Sorting changed components into typed arrays on this thread beforehand, since chunks
+  // query them from different threads
+  for (size_t i = 0; i < sceneObjects.size(); ++i) {
+    sceneObjects[i].getScenePtr()->updateComponentArrays();
+  }
+
+  // Culling meshes of each chunk of scene objects and collecting their draw items
+  const auto collectChunks = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      _chunkDrawItems[i].clear();
+      const size_t lastIndex = std::min((i + 1) * kPushGrainSize, sceneObjects.size());
+      for (size_t j = i * kPushGrainSize; j < lastIndex; ++j) {
+        collectDrawItems(sceneObjects[j], pass, camera, frustumPlanes, shaderProgramOverride,
+                         _chunkDrawItems[i], _chunkCullingStats[i]);
+      }
+    }
+  };
+  if (jobSystemPtr != nullptr) {
+    jobSystemPtr->parallelFor(chunkCount, 1, collectChunks);
+  } else {
+    collectChunks(0, chunkCount);
+  }
+
+  // For each draw item of each chunk
+  for (size_t i = 0; i < chunkCount; ++i) {
+    SceneObject::addCullingStats(_chunkCullingStats[i]);
+    for (size_t j = 0; j < _chunkDrawItems[i].size(); ++j) {
+      pushDrawItem(_chunkDrawItems[i][j]);
+    }
+  }
+}
+
+// Moves draw items of pass drawn by shader program to another pass and shader program
+// (e.g. meshes lit in forward pass to geometry buffer pass of deferred shading)
+void RenderQueue::moveToPass(unsigned int pass, GLuint shaderProgram, unsigned int newPass,
+                             GLuint newShaderProgram) noexcept {
+  pass    %= kMaxPassCount;
+  newPass %= kMaxPassCount;
+
+  // Pass and program occupy the highest bits of the sort key, so the rest is kept
+  const uint64_t keepMask   = (1ull << kProgramKeyShift) - 1;
+  const uint64_t newPassKey = static_cast<uint64_t>(newPass);
+  const uint64_t newProgramKey =
+      getSortId(_programIds, newShaderProgram) & ((1ull << kProgramKeyBits) - 1);
+
+  // For each draw item of the pass drawn by shader program
+  for (size_t i = 0; i < _drawItems.size(); ++i) {
+    DrawItem &drawItem = _drawItems[i];
+    if ((drawItem.key >> kPassKeyShift) != pass || drawItem.shaderProgram != shaderProgram) {
+      continue;
+    }
+
+    drawItem.key = (newPassKey << kPassKeyShift) | (newProgramKey << kProgramKeyShift) |
+                   (drawItem.key & keepMask);
+    drawItem.shaderProgram = newShaderProgram;
+    _isSorted              = false;
+  }
+}
+
+// Moves draw items of scene object in pass to another pass (e.g. scene object pushed
+// with the rest of scene objects, but drawn in a pass of its own)
+void RenderQueue::moveToPass(const SceneObject &sceneObject, unsigned int pass,
+                             unsigned int newPass) noexcept {
+  pass    %= kMaxPassCount;
+  newPass %= kMaxPassCount;
+
+  // Pass occupies the highest bits of the sort key, so the rest is kept
+  const uint64_t keepMask   = (1ull << kPassKeyShift) - 1;
+  const uint64_t newPassKey = static_cast<uint64_t>(newPass);
+
+  // For each draw item of scene object in the pass
+  for (size_t i = 0; i < _drawItems.size(); ++i) {
+    DrawItem &drawItem = _drawItems[i];
+    if ((drawItem.key >> kPassKeyShift) != pass || drawItem.sceneObjectPtr != &sceneObject) {
+      continue;
+    }
+
+    drawItem.key = (newPassKey << kPassKeyShift) | (drawItem.key & keepMask);
+    _isSorted    = false;
+  }
+}
+
+void RenderQueue::sort() noexcept {
+  // Sorting indices of draw items, so ties are broken by submission order (as with stable sort,
+  // which would allocate its temporary buffer)
+  _sortOrder.resize(_drawItems.size());
+  std::iota(_sortOrder.begin(), _sortOrder.end(), 0);
+  std::sort(_sortOrder.begin(), _sortOrder.end(), [this](size_t a, size_t b) {
+    return _drawItems[a].key != _drawItems[b].key ? _drawItems[a].key < _drawItems[b].key
+                                                  : a < b;
+  });
+
+  // Reordering draw items by sorted indices
+  _sortedDrawItems.clear();
+  for (size_t i = 0; i < _sortOrder.size(); ++i) {
+    _sortedDrawItems.push_back(_drawItems[_sortOrder[i]]);
+  }
+  std::swap(_drawItems, _sortedDrawItems);
+
+  _isSorted = true;
+}
+
+void RenderQueue::submit(unsigned int pass, float exposure) noexcept {
+  if (!_isSorted) sort();
+
+  pass %= kMaxPassCount;
+  RenderPassStats &passStats = _passStats[pass];
+
+  // Finding draw items of the pass (they are contiguous after sorting)
+  const uint64_t passKeyBegin = static_cast<uint64_t>(pass) << kPassKeyShift;
+  auto           drawItemIter = std::lower_bound(
+      _drawItems.begin(), _drawItems.end(), passKeyBegin,
+      [](const DrawItem &drawItem, uint64_t key) { return drawItem.key < key; });
+
+  // Currently bound state (binds made outside of the queue are not tracked, so material
+  // texture units are expected to be unbound before the pass and are unbound after it)
+  GLuint                                        currentShaderProgram{};
+  GLuint                                        currentVAO{};
+  std::array<GLuint, kMaterialTextureUnitCount> currentTextures{};
+  std::array<GLenum, kMaterialTextureUnitCount> currentTextureTargets{};
+
+  // For each draw item of the pass
+  for (; drawItemIter != _drawItems.end() && (drawItemIter->key >> kPassKeyShift) == pass;
+       ++drawItemIter) {
+    const DrawItem       &drawItem      = *drawItemIter;
+    const Mesh           &mesh          = *drawItem.meshPtr;
+    const Mesh::Material &material      = *mesh.getMaterialPtr();
+    const GLuint          shaderProgram = drawItem.shaderProgram;
+
+    // If shader program changed
+    if (shaderProgram != currentShaderProgram) {
+      glUseProgram(shaderProgram);
+      currentShaderProgram = shaderProgram;
+      ++passStats.programSwitchCount;
+
+      // Updating per-program uniform values (samplers and exposure are the same for all draws)
+      glUniform1i(getUniformLocation(shaderProgram, kMaterialAlbedoMapUniform), 0);
+      glUniform1i(getUniformLocation(shaderProgram, kMaterialNormalMapUniform), 1);
+      glUniform1i(getUniformLocation(shaderProgram, kMaterialDepthMapUniform), 2);
+      glUniform1i(getUniformLocation(shaderProgram, kMaterialAmbOccMapUniform), 3);
+      glUniform1i(getUniformLocation(shaderProgram, kMaterialGlossMapUniform), 4);
+      glUniform1i(getUniformLocation(shaderProgram, kMaterialEmissMapUniform), 5);
+      glUniform1i(getUniformLocation(shaderProgram, kMaterialEnvMapUniform), 6);
+      glUniform1f(getUniformLocation(shaderProgram, kExposureUniform), exposure);
+    }
+
+    // If VAO changed
+    if (mesh.getVAO() != currentVAO) {
+      glBindVertexArray(mesh.getVAO());
+      currentVAO = mesh.getVAO();
+      ++passStats.vaoSwitchCount;
+    }
+
+    // Getting textures of material by texture unit (units material does not provide get 0,
+    // so shaders sample black from them as if every map was unbound after previous draw)
+    std::array<GLuint, kMaterialTextureUnitCount> textures{};
+    std::array<GLenum, kMaterialTextureUnitCount> textureTargets{};
+    for (size_t i = 0; i < material.getTexturePtrs().size(); ++i) {
+      const Mesh::Material::Texture &texture = *material.getTexturePtrs()[i];
+      const int                      unit    = texture.getUnit();
+
+      const GLenum target = texture.getIsCubemap() ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+
+      // If texture unit is not a material one (binding it untracked)
+      if (unit < 0 || unit >= static_cast<int>(kMaterialTextureUnitCount)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, texture.getName());
+        ++passStats.textureSwitchCount;
+        continue;
+      }
+
+      textures[unit]       = texture.getName();
+      textureTargets[unit] = target;
+    }
+
+    // For each material texture unit
+    for (size_t unit = 0; unit < kMaterialTextureUnitCount; ++unit) {
+      // If the same texture is already bound to texture unit
+      if (textures[unit] == currentTextures[unit] &&
+          (textures[unit] == 0 || textureTargets[unit] == currentTextureTargets[unit])) {
+        continue;
+      }
+
+      // Unbinding previous texture if it is not replaced on the same target
+      glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(unit));
+      if (currentTextures[unit] != 0 &&
+          (textures[unit] == 0 || textureTargets[unit] != currentTextureTargets[unit])) {
+        glBindTexture(currentTextureTargets[unit], 0);
+      }
+      // Binding texture to texture unit
+      if (textures[unit] != 0) glBindTexture(textureTargets[unit], textures[unit]);
+
+      currentTextures[unit]       = textures[unit];
+      currentTextureTargets[unit] = textureTargets[unit];
+      ++passStats.textureSwitchCount;
+    }
+
+    // Updating per-draw uniform values
+    glUniformMatrix4fv(getUniformLocation(shaderProgram, kModelUniform), 1, GL_FALSE,
+                       glm::value_ptr(drawItem.sceneObjectPtr->getModelMatrix()));
+    if (drawItem.lightPtr != nullptr) {
+      glUniform3fv(getUniformLocation(shaderProgram, kLightColorUniform), 1,
+                   glm::value_ptr(drawItem.lightPtr->getColor()));
+    }
+    glUniform1f(getUniformLocation(shaderProgram, kMaterialParallaxUniform),
+                material.getParallaxStrength());
+    glUniform1i(getUniformLocation(shaderProgram, kInstancedUniform),
+                static_cast<int>(mesh.getInstanceCount() > 1));
+
+    // Drawing mesh
+    mesh.draw();
+    ++passStats.drawCount;
+  }
+
+  // Unbinding shader program, VAO and textures once per pass instead of once per draw
+  glUseProgram(0);
+  glBindVertexArray(0);
+  for (size_t unit = 0; unit < kMaterialTextureUnitCount; ++unit) {
+    if (currentTextures[unit] == 0) continue;
+
+    glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(unit));
+    glBindTexture(currentTextureTargets[unit], 0);
+    currentTextures[unit] = 0;
+  }
+  glActiveTexture(GL_TEXTURE0);
+}
+
+void RenderQueue::clear() noexcept {
+  _drawItems.clear();
+  _isSorted = true;
+
+  // Sort identifiers are kept between frames, so no map node is allocated once every object
+  // was seen; they are reassigned only once identifiers of deleted objects piled up and no
+  // longer fit their key bits (objects reusing a name or an address just share identifier)
+  if (_programIds.size() >= (1ull << kProgramKeyBits) ||
+      _materialIds.size() >= (1ull << kMaterialKeyBits) ||
+      _vaoIds.size() >= (1ull << kVAOKeyBits)) {
+    _programIds.clear();
+    _materialIds.clear();
+    _vaoIds.clear();
+  }
+
+  // Resetting statistics for the next frame
+  _passStats = std::array<RenderPassStats, kMaxPassCount>{};
+}
+
+// Adds program, material and VAO sort identifiers to sort key of collected draw item
+// and pushes it
+void RenderQueue::pushDrawItem(const DrawItem &drawItem) noexcept {
+  const Mesh::Material *materialPtr = drawItem.meshPtr->getMaterialPtr().get();
+
+  const uint64_t programKey =
+      getSortId(_programIds, drawItem.shaderProgram) & ((1ull << kProgramKeyBits) - 1);
+  const uint64_t materialKey =
+      getSortId(_materialIds, materialPtr) & ((1ull << kMaterialKeyBits) - 1);
+  const uint64_t vaoKey =
+      getSortId(_vaoIds, drawItem.meshPtr->getVAO()) & ((1ull << kVAOKeyBits) - 1);
+
+  _drawItems.push_back(drawItem);
+  _drawItems.back().key |= (programKey << kProgramKeyShift) |
+                           (materialKey << kMaterialKeyShift) | (vaoKey << kVAOKeyShift);
+  _isSorted = false;
+}
+
+// Local function definitions
+
+template <typename T>
+uint64_t getSortId(std::unordered_map<T, uint64_t> &sortIds, const T &object) {
+  // Assigning next identifier to object seen for the first time
+  auto sortIdIter = sortIds.find(object);
+  if (sortIdIter == sortIds.end()) {
+    sortIdIter = sortIds.emplace(object, static_cast<uint64_t>(sortIds.size())).first;
+  }
+
+  return sortIdIter->second;
+}
+
+uint64_t calculateDepthKey(const SceneObject &sceneObject, const BaseCamera &camera) {
+  // Getting view space depth of scene object world position (objects behind camera are treated
+  // as the nearest)
+  const glm::vec3 worldPos{sceneObject.getModelMatrix()[3]};
+  const float     depth =
+      std::max(glm::dot(worldPos - camera.getPosition(), camera.getForward()), 0.0f);
+
+  // Bits of non-negative float grow with its value so the highest bits are used as depth key
+  uint32_t depthBits{};
+  std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+  return static_cast<uint64_t>(depthBits >> (32 - kDepthKeyBits));
+}
+
+// Culls meshes of scene object and collects their draw items with pass and depth sort keys
+// (touches nothing shared, so scene objects may be collected on different threads)
+void collectDrawItems(const SceneObject &sceneObject, unsigned int pass, const BaseCamera &camera,
+                      const FrustumPlanes &frustumPlanes, GLuint shaderProgramOverride,
+                      std::vector<RenderQueue::DrawItem> &drawItems,
+                      CullingStats                       &cullingStats) {
+  // Using the first light component if scene object has at least one
+  const BaseLight *lightPtr = sceneObject.getComponentPtr<BaseLight>();
+
+  // Depth is the same for all the meshes of scene object
+  const uint64_t passKey  = static_cast<uint64_t>(pass % RenderQueue::kMaxPassCount);
+  const uint64_t depthKey = calculateDepthKey(sceneObject, camera);
+
+  // For each mesh component
+  for (const SceneComponent<Mesh> &meshComponent : sceneObject.getComponents<Mesh>()) {
+    const Mesh *meshPtr = meshComponent.componentPtr;
+
+    // If mesh is not complete or outside of camera frustum
+    if (!meshPtr->isComplete() ||
+        !sceneObject.isMeshVisible(*meshPtr, frustumPlanes, cullingStats)) {
+      continue;
+    }
+
+    RenderQueue::DrawItem drawItem{};
+    drawItem.key            = (passKey << kPassKeyShift) | (depthKey << kDepthKeyShift);
+    drawItem.sceneObjectPtr = &sceneObject;
+    drawItem.meshPtr        = meshPtr;
+    drawItem.lightPtr       = lightPtr;
+    drawItem.shaderProgram  = shaderProgramOverride > 0 ? shaderProgramOverride
+                                                        : meshPtr->getShaderProgram();
+
+    drawItems.push_back(drawItem);
+  }
+}
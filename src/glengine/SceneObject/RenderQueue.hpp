@@ -0,0 +1,98 @@
+#ifndef GLENGINE_SCENEOBJECT_RENDERQUEUE_HPP
+#define GLENGINE_SCENEOBJECT_RENDERQUEUE_HPP
+
+// STD
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// OpenGL
+#include <glad/glad.h>
+
+// "glengine" internal library
+#include "./SceneObject.hpp"
+
+namespace glengine {
+
+class JobSystem;
+
+// Render pass statistics struct
+struct RenderPassStats {
+  size_t drawCount{};           // draw calls issued
+  size_t programSwitchCount{};  // glUseProgram calls
+  size_t textureSwitchCount{};  // glBindTexture calls
+  size_t vaoSwitchCount{};      // glBindVertexArray calls
+};
+
+// Render queue class (collects draw items of scene objects, sorts them by 64-bit key
+// and issues only the binds that actually change between consecutive draws)
+class RenderQueue {
+ public:
+  // Maximal render pass count (pass index occupies the highest 4 bits of the sort key)
+  static constexpr unsigned int kMaxPassCount = 16;
+
+  // Draw item struct
+  struct DrawItem {
+    uint64_t           key{};
+    const SceneObject *sceneObjectPtr{};
+    const Mesh        *meshPtr{};
+    const BaseLight   *lightPtr{};
+    GLuint             shaderProgram{};
+  };
+
+ private:
+  std::vector<DrawItem> _drawItems{};
+  bool                  _isSorted{true};
+
+  // Sorting arrays (kept, so sorting allocates nothing while draw item count does not grow)
+  std::vector<size_t>   _sortOrder{};
+  std::vector<DrawItem> _sortedDrawItems{};
+
+  // Pushing arrays (kept per queue, so queues may be filled at once from different threads)
+  std::vector<DrawItem>              _pushedDrawItems{};
+  std::vector<std::vector<DrawItem>> _chunkDrawItems{};
+  std::vector<CullingStats>          _chunkCullingStats{};
+
+  // Dense sort identifiers of programs, materials and VAOs (assigned in order of appearance
+  // and kept between frames)
+  std::unordered_map<GLuint, uint64_t>                 _programIds{};
+  std::unordered_map<const Mesh::Material *, uint64_t> _materialIds{};
+  std::unordered_map<GLuint, uint64_t>                 _vaoIds{};
+
+  std::array<RenderPassStats, kMaxPassCount> _passStats{};
+
+ public:
+  // Constructors, assignment operators and destructor
+  RenderQueue() noexcept;
+  RenderQueue(const RenderQueue &renderQueue) noexcept;
+  RenderQueue &operator=(const RenderQueue &renderQueue) noexcept;
+  RenderQueue(RenderQueue &&renderQueue) noexcept;
+  RenderQueue &operator=(RenderQueue &&renderQueue) noexcept;
+  ~RenderQueue() noexcept;
+
+  // Getters
+  const std::vector<DrawItem> &getDrawItems() const noexcept;
+  const RenderPassStats       &getPassStats(unsigned int pass) const noexcept;
+
+  // Other member functions
+  void push(const SceneObject &sceneObject, unsigned int pass, const BaseCamera &camera,
+            GLuint shaderProgramOverride = 0) noexcept;
+  void push(const std::vector<SceneObject> &sceneObjects, unsigned int pass,
+            const BaseCamera &camera, GLuint shaderProgramOverride = 0,
+            JobSystem *jobSystemPtr = nullptr) noexcept;
+  void moveToPass(unsigned int pass, GLuint shaderProgram, unsigned int newPass,
+                  GLuint newShaderProgram) noexcept;
+  void moveToPass(const SceneObject &sceneObject, unsigned int pass,
+                  unsigned int newPass) noexcept;
+  void sort() noexcept;
+  void submit(unsigned int pass, float exposure = 1.0f) noexcept;
+  void clear() noexcept;
+
+ private:
+  void pushDrawItem(const DrawItem &drawItem) noexcept;
+};
+
+}  // namespace glengine
+
+#endif
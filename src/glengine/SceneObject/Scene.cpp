@@ -0,0 +1,385 @@
+// Header file
+#include "./Scene.hpp"
+
+// STD
+#include <algorithm>
+#include <chrono>
+
+// "glengine" internal library
+#include "../jobs/JobSystem.hpp"
+#include "./modelMatrixBatch.hpp"
+
+using namespace glengine;
+
+// Global constants
+
+// Local matrices composed by a single job
+static constexpr size_t kLocalMatrixGrainSize = 1024;
+
+// Constructors, assignment operators and destructor
+
+// Default constructor
+Scene::Scene() noexcept {}
+
+// Destructor (scene objects must not outlive their scene)
+Scene::~Scene() noexcept {}
+
+// Setters
+
+void Scene::setSceneObjectPtr(size_t entity, SceneObject *sceneObjectPtr) noexcept {
+  _sceneObjectPtrs[entity] = sceneObjectPtr;
+}
+
+// Sets local matrix directly (it is kept until translate, rotate or scale change)
+void Scene::setLocalMatrix(size_t entity, const glm::mat4 &localMatrix) noexcept {
+  _localMatrices[entity]  = localMatrix;
+  _transformFlags[entity] = kWorldMatrixDirty;
+  _hasDirtyTransforms     = true;
+}
+
+// Sets parent of entity (kNoEntity makes it root; returns false if parent is entity itself
+// or its descendant, since hierarchy must stay acyclic)
+bool Scene::setParent(size_t entity, size_t parent) noexcept {
+  // If parent is entity itself or its descendant
+  for (size_t ancestor = parent; ancestor != kNoEntity; ancestor = _parents[ancestor]) {
+    if (ancestor == entity) return false;
+  }
+
+  if (_parents[entity] != kNoEntity) --_childCounts[_parents[entity]];
+  if (parent != kNoEntity) ++_childCounts[parent];
+  _parents[entity] = parent;
+
+  // World matrix of entity follows the new parent, which may come after it in update order
+  _transformFlags[entity] |= kWorldMatrixDirty;
+  _hasDirtyTransforms      = true;
+  _isUpdateOrderDirty      = true;
+
+  return true;
+}
+
+void Scene::setComponentPtrs(
+    size_t entity, const std::vector<std::shared_ptr<Component>> &componentPtrs) noexcept {
+  _componentPtrs[entity]   = componentPtrs;
+  _areComponentArraysDirty = true;
+}
+
+// Getters
+
+size_t Scene::getEntityCount() const noexcept { return _sceneObjectPtrs.size(); }
+
+size_t Scene::getSceneObjectCount() const noexcept {
+  return _sceneObjectPtrs.size() - _freeEntities.size();
+}
+
+SceneObject *Scene::getSceneObjectPtr(size_t entity) const noexcept {
+  return _sceneObjectPtrs[entity];
+}
+
+// Transforms changed through non-const arrays must be followed by markTransformDirty call
+
+const std::vector<glm::vec3> &Scene::getTranslates() const noexcept { return _translates; }
+
+std::vector<glm::vec3> &Scene::getTranslates() noexcept { return _translates; }
+
+const std::vector<glm::vec3> &Scene::getRotates() const noexcept { return _rotates; }
+
+std::vector<glm::vec3> &Scene::getRotates() noexcept { return _rotates; }
+
+const std::vector<glm::vec3> &Scene::getScales() const noexcept { return _scales; }
+
+std::vector<glm::vec3> &Scene::getScales() noexcept { return _scales; }
+
+const std::vector<glm::mat4> &Scene::getLocalMatrices() const noexcept { return _localMatrices; }
+
+const std::vector<glm::mat4> &Scene::getModelMatrices() const noexcept { return _modelMatrices; }
+
+std::vector<glm::mat4> &Scene::getModelMatrices() noexcept { return _modelMatrices; }
+
+const std::vector<size_t> &Scene::getTransformGenerations() const noexcept {
+  return _transformGenerations;
+}
+
+std::vector<size_t> &Scene::getTransformGenerations() noexcept { return _transformGenerations; }
+
+const std::vector<size_t> &Scene::getParents() const noexcept { return _parents; }
+
+const TransformStats &Scene::getTransformStats() const noexcept { return _transformStats; }
+
+const std::vector<std::shared_ptr<Component>> &Scene::getComponentPtrs(
+    size_t entity) const noexcept {
+  return _componentPtrs[entity];
+}
+
+// Components may be changed through returned reference, so typed arrays are sorted again
+std::vector<std::shared_ptr<Component>> &Scene::getComponentPtrs(size_t entity) noexcept {
+  _areComponentArraysDirty = true;
+  return _componentPtrs[entity];
+}
+
+const std::vector<SceneComponent<Mesh>> &Scene::getMeshes() noexcept {
+  if (_areComponentArraysDirty) sortComponents();
+  return _meshes;
+}
+
+const std::vector<SceneComponent<BaseLight>> &Scene::getLights() noexcept {
+  if (_areComponentArraysDirty) sortComponents();
+  return _lights;
+}
+
+const std::vector<SceneComponent<DirectionalLight>> &Scene::getDirectionalLights() noexcept {
+  if (_areComponentArraysDirty) sortComponents();
+  return _directionalLights;
+}
+
+const std::vector<SceneComponent<PointLight>> &Scene::getPointLights() noexcept {
+  if (_areComponentArraysDirty) sortComponents();
+  return _pointLights;
+}
+
+const std::vector<SceneComponent<SpotLight>> &Scene::getSpotLights() noexcept {
+  if (_areComponentArraysDirty) sortComponents();
+  return _spotLights;
+}
+
+// Other member functions
+
+// Creates root entity of scene object (free entities are reused, so arrays do not grow
+// while scene objects are replaced; root entity without children may be anywhere
+// in update order, so it stays valid)
+size_t Scene::createEntity(SceneObject *sceneObjectPtr) noexcept {
+  _hasDirtyTransforms = true;
+
+  // If there is free entity
+  if (!_freeEntities.empty()) {
+    const size_t entity = _freeEntities.back();
+    _freeEntities.pop_back();
+
+    _translates[entity]           = glm::vec3{};
+    _rotates[entity]              = glm::vec3{};
+    _scales[entity]               = glm::vec3{};
+    _localMatrices[entity]        = glm::mat4{1.0f};
+    _modelMatrices[entity]        = glm::mat4{1.0f};
+    _transformGenerations[entity] = 0;
+    _transformFlags[entity]       = kLocalMatrixDirty;
+    _sceneObjectPtrs[entity]      = sceneObjectPtr;
+
+    return entity;
+  }
+
+  const size_t entity = _sceneObjectPtrs.size();
+  _translates.emplace_back();
+  _rotates.emplace_back();
+  _scales.emplace_back();
+  _localMatrices.emplace_back(1.0f);
+  _modelMatrices.emplace_back(1.0f);
+  _transformGenerations.emplace_back();
+  _transformFlags.push_back(kLocalMatrixDirty);
+  _parents.push_back(kNoEntity);
+  _childCounts.emplace_back();
+  _updateOrder.push_back(entity);
+  _componentPtrs.emplace_back();
+  _sceneObjectPtrs.push_back(sceneObjectPtr);
+
+  return entity;
+}
+
+// Destroys entity of scene object (its components are released and its children become roots,
+// keeping world matrices of the last update as local ones)
+void Scene::destroyEntity(size_t entity) noexcept {
+  // If entity had components
+  if (!_componentPtrs[entity].empty()) {
+    _componentPtrs[entity].clear();
+    _areComponentArraysDirty = true;
+  }
+
+  // If entity has children
+  if (_childCounts[entity] > 0) {
+    for (size_t i = 0; i < _parents.size(); ++i) {
+      if (_parents[i] != entity) continue;
+      _parents[i] = kNoEntity;
+
+      // Keeping world transform as local one (along with changes pending for the next update)
+      const uint8_t flags = _transformFlags[i];
+      setLocalMatrix(i, _modelMatrices[i]);
+      _transformFlags[i] |= flags;
+    }
+    _childCounts[entity] = 0;
+  }
+  if (_parents[entity] != kNoEntity) {
+    --_childCounts[_parents[entity]];
+    _parents[entity] = kNoEntity;
+  }
+
+  _transformFlags[entity]  = 0;
+  _sceneObjectPtrs[entity] = nullptr;
+  _freeEntities.push_back(entity);
+}
+
+bool Scene::isEntityAlive(size_t entity) const noexcept {
+  return entity < _sceneObjectPtrs.size() && _sceneObjectPtrs[entity] != nullptr;
+}
+
+// Copies transform and parent of source entity (world matrix is recalculated by the next update,
+// since source one may be out of date)
+void Scene::copyTransform(size_t entity, size_t sourceEntity) noexcept {
+  _translates[entity]    = _translates[sourceEntity];
+  _rotates[entity]       = _rotates[sourceEntity];
+  _scales[entity]        = _scales[sourceEntity];
+  _localMatrices[entity] = _localMatrices[sourceEntity];
+  _modelMatrices[entity] = _modelMatrices[sourceEntity];
+  if (_parents[entity] != _parents[sourceEntity]) setParent(entity, _parents[sourceEntity]);
+
+  _transformFlags[entity] = _transformFlags[sourceEntity] | kWorldMatrixDirty;
+  _hasDirtyTransforms     = true;
+}
+
+// Flags translate, rotate or scale of entity as changed (local matrix is recalculated
+// by the next update)
+void Scene::markTransformDirty(size_t entity) noexcept {
+  _transformFlags[entity] |= kLocalMatrixDirty;
+  _hasDirtyTransforms      = true;
+}
+
+// Recalculates local matrices of flagged entities and world matrices of them and their
+// descendants in a single pass (entities with new world matrix take new transform generation,
+// so shadow caches notice children moved by their parents too; local matrices are composed
+// in parallel if job system is given)
+void Scene::updateTransforms(JobSystem *jobSystemPtr) noexcept {
+  _transformStats = TransformStats{};
+
+  // If nothing changed since the last update
+  if (!_hasDirtyTransforms) return;
+  const auto updateStartTime = std::chrono::steady_clock::now();
+
+  // Sorting entities by hierarchy depth if hierarchy changed (parents are never deeper
+  // than their children)
+  if (_isUpdateOrderDirty) {
+    _depths.assign(_parents.size(), 0);
+    for (size_t i = 0; i < _parents.size(); ++i) {
+      for (size_t ancestor = _parents[i]; ancestor != kNoEntity; ancestor = _parents[ancestor]) {
+        ++_depths[i];
+      }
+    }
+    std::stable_sort(_updateOrder.begin(), _updateOrder.end(),
+                     [this](size_t a, size_t b) { return _depths[a] < _depths[b]; });
+    _isUpdateOrderDirty = false;
+  }
+
+  // Composing local matrices of entities whose translate, rotate or scale changed all at once
+  // (several entities per SIMD instruction, chunks of entities on different threads)
+  _localMatrixEntities.clear();
+  for (size_t i = 0; i < _transformFlags.size(); ++i) {
+    if ((_transformFlags[i] & kLocalMatrixDirty) != 0) _localMatrixEntities.push_back(i);
+  }
+  const auto composeLocalMatrices = [this](size_t begin, size_t end) {
+    composeModelMatrices(_translates.data(), _rotates.data(), _scales.data(),
+                         _localMatrixEntities.data() + begin, end - begin,
+                         _localMatrices.data());
+  };
+  if (jobSystemPtr != nullptr) {
+    jobSystemPtr->parallelFor(_localMatrixEntities.size(), kLocalMatrixGrainSize,
+                              composeLocalMatrices);
+  } else {
+    composeLocalMatrices(0, _localMatrixEntities.size());
+  }
+  _transformStats.localMatrixCount = _localMatrixEntities.size();
+
+  // Entities whose world matrix changes in this pass take generations newer than this one
+  const size_t firstTransformGeneration = getMutableTransformGeneration() + 1;
+
+  // For each entity in update order (serially, since parents must be updated before their
+  // children and transform generations are taken in order)
+  for (size_t i = 0; i < _updateOrder.size(); ++i) {
+    const size_t entity = _updateOrder[i];
+    const size_t parent = _parents[entity];
+    uint8_t     &flags  = _transformFlags[entity];
+
+    // If parent world matrix changed in this pass
+    if (parent != kNoEntity && _transformGenerations[parent] >= firstTransformGeneration) {
+      flags |= kWorldMatrixDirty;
+    }
+    if (flags == 0) continue;
+
+    // Recalculating world matrix
+    _modelMatrices[entity] = parent != kNoEntity
+                                 ? _modelMatrices[parent] * _localMatrices[entity]
+                                 : _localMatrices[entity];
+    _transformGenerations[entity] = ++getMutableTransformGeneration();
+    flags                         = 0;
+    ++_transformStats.worldMatrixCount;
+  }
+
+  _transformStats.milliseconds = std::chrono::duration<double, std::milli>(
+                                     std::chrono::steady_clock::now() - updateStartTime)
+                                     .count();
+
+  _hasDirtyTransforms = false;
+}
+
+// Sorts components of all the entities into typed arrays (the only place components are
+// type checked, so it is done once they change rather than every time they are iterated;
+// arrays keep their capacity, so sorting again allocates nothing unless they grow)
+void Scene::sortComponents() noexcept {
+  _meshes.clear();
+  _lights.clear();
+  _directionalLights.clear();
+  _pointLights.clear();
+  _spotLights.clear();
+  _componentOffsets.clear();
+
+  // For each component of each entity
+  for (size_t i = 0; i < _componentPtrs.size(); ++i) {
+    _componentOffsets.push_back(ComponentOffsets{_meshes.size(), _lights.size(),
+                                                 _directionalLights.size(), _pointLights.size(),
+                                                 _spotLights.size()});
+    for (size_t j = 0; j < _componentPtrs[i].size(); ++j) {
+      Component *componentPtr = _componentPtrs[i][j].get();
+
+      // If component is mesh
+      if (componentPtr->getType() == ComponentType::Mesh) {
+        _meshes.push_back(SceneComponent<Mesh>{i, static_cast<Mesh *>(componentPtr)});
+      }
+
+      // If component is light (spot light must be checked before directional and point ones,
+      // since it is both of them)
+      else if (componentPtr->getType() == ComponentType::Light) {
+        _lights.push_back(SceneComponent<BaseLight>{i, static_cast<BaseLight *>(componentPtr)});
+        if (SpotLight *spotLightPtr = dynamic_cast<SpotLight *>(componentPtr)) {
+          _spotLights.push_back(SceneComponent<SpotLight>{i, spotLightPtr});
+        } else if (DirectionalLight *directionalLightPtr =
+                       dynamic_cast<DirectionalLight *>(componentPtr)) {
+          _directionalLights.push_back(
+              SceneComponent<DirectionalLight>{i, directionalLightPtr});
+        } else if (PointLight *pointLightPtr = dynamic_cast<PointLight *>(componentPtr)) {
+          _pointLights.push_back(SceneComponent<PointLight>{i, pointLightPtr});
+        }
+      }
+    }
+  }
+  _componentOffsets.push_back(ComponentOffsets{_meshes.size(), _lights.size(),
+                                               _directionalLights.size(), _pointLights.size(),
+                                               _spotLights.size()});
+
+  _areComponentArraysDirty = false;
+}
+
+// Sorts components into typed arrays if components of any entity changed since the last sort
+// (must not be called from several threads at once while components are changed)
+void Scene::updateComponentArrays() noexcept {
+  if (_areComponentArraysDirty) sortComponents();
+}
+
+// Other static member functions
+
+// Gets scene scene objects are created in unless other one is specified
+Scene &Scene::getDefaultScene() noexcept {
+  static Scene sDefaultScene{};
+  return sDefaultScene;
+}
+
+// Gets global transform generation counter (shared by all the scenes, so generations are unique;
+// atomic, since scenes may be updated from different threads at once)
+std::atomic<size_t> &Scene::getMutableTransformGeneration() noexcept {
+  static std::atomic<size_t> sTransformGeneration{};
+  return sTransformGeneration;
+}
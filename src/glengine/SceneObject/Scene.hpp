@@ -0,0 +1,210 @@
+#ifndef GLENGINE_SCENEOBJECT_SCENE_HPP
+#define GLENGINE_SCENEOBJECT_SCENE_HPP
+
+// All the headers
+#include "./Component/component.inc"
+
+// STD
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+namespace glengine {
+
+class SceneObject;
+class JobSystem;
+
+// Scene component struct (component of specific type and entity owning it)
+template <typename T>
+struct SceneComponent {
+  size_t entity{};
+  T     *componentPtr{};
+};
+
+// Scene component range struct (components of specific type owned by an entity, valid until
+// components of any entity change)
+template <typename T>
+struct SceneComponentRange {
+  const SceneComponent<T> *first{};
+  const SceneComponent<T> *last{};
+
+  const SceneComponent<T> *begin() const noexcept { return first; }
+  const SceneComponent<T> *end() const noexcept { return last; }
+  size_t                   size() const noexcept { return static_cast<size_t>(last - first); }
+  bool                     empty() const noexcept { return first == last; }
+};
+
+// Transform update statistics struct (of the last update)
+struct TransformStats {
+  size_t localMatrixCount{};  // local matrices composed from translate, rotate and scale
+  size_t worldMatrixCount{};  // world matrices recalculated (descendants of changed ones too)
+  double milliseconds{};      // time spent updating transforms
+};
+
+// Scene class (data-oriented storage of scene objects: transforms are kept in parallel arrays
+// indexed by entity, and components are sorted into typed arrays once they change, so systems
+// iterate them linearly without type checks; scene objects are handles of entities)
+// Transforms form a hierarchy: changes only flag entities, and world (model) matrices of
+// flagged entities and their descendants are recalculated in one pass per frame
+// Transforms of distinct entities may be changed from several threads at once, while entities,
+// hierarchy and components are changed from one thread only
+class Scene {
+ public:
+  // Entity of scene objects which own none (and parent of root entities)
+  static constexpr size_t kNoEntity = std::numeric_limits<size_t>::max();
+
+  // Transform flags
+  static constexpr uint8_t kLocalMatrixDirty = 1;  // translate, rotate or scale changed
+  static constexpr uint8_t kWorldMatrixDirty = 2;  // local matrix changed
+
+ private:
+  // Transform arrays (model matrices are world ones, local matrices are relative to parent)
+  std::vector<glm::vec3> _translates{};
+  std::vector<glm::vec3> _rotates{};
+  std::vector<glm::vec3> _scales{};
+  std::vector<glm::mat4> _localMatrices{};
+  std::vector<glm::mat4> _modelMatrices{};
+  std::vector<size_t>    _transformGenerations{};
+  std::vector<uint8_t>   _transformFlags{};
+  std::atomic<bool>      _hasDirtyTransforms{};
+  TransformStats         _transformStats{};
+
+  // Transform hierarchy (entities are updated in topological order, so parents always come
+  // before their children)
+  std::vector<size_t> _parents{};
+  std::vector<size_t> _childCounts{};
+  std::vector<size_t> _updateOrder{};
+  bool                _isUpdateOrderDirty{};
+
+  // Transform update arrays (kept between updates, so updates allocate nothing)
+  std::vector<size_t> _depths{};
+  std::vector<size_t> _localMatrixEntities{};
+
+  // Components and scene object of each entity (scene object is nullptr if entity is free)
+  std::vector<std::vector<std::shared_ptr<Component>>> _componentPtrs{};
+  std::vector<SceneObject *>                           _sceneObjectPtrs{};
+  std::vector<size_t>                                  _freeEntities{};
+
+  // Typed component arrays (in order of entities, sorted again on the first query after
+  // components of any entity changed; lights of any type are also kept as base lights)
+  std::vector<SceneComponent<Mesh>>             _meshes{};
+  std::vector<SceneComponent<BaseLight>>        _lights{};
+  std::vector<SceneComponent<DirectionalLight>> _directionalLights{};
+  std::vector<SceneComponent<PointLight>>       _pointLights{};
+  std::vector<SceneComponent<SpotLight>>        _spotLights{};
+  bool                                          _areComponentArraysDirty{};
+
+  // Typed component array offsets struct (indices of the first components of an entity)
+  struct ComponentOffsets {
+    size_t mesh{};
+    size_t light{};
+    size_t directionalLight{};
+    size_t pointLight{};
+    size_t spotLight{};
+  };
+
+  // Offsets of each entity (offsets of the next entity end its components, so there is
+  // one more of them than entities)
+  std::vector<ComponentOffsets> _componentOffsets{};
+
+ public:
+  // Constructors, assignment operators and destructor
+  Scene() noexcept;
+  Scene(const Scene &scene)            = delete;
+  Scene &operator=(const Scene &scene) = delete;
+  Scene(Scene &&scene)                 = delete;
+  Scene &operator=(Scene &&scene)      = delete;
+  ~Scene() noexcept;
+
+  // Setters
+  void setSceneObjectPtr(size_t entity, SceneObject *sceneObjectPtr) noexcept;
+  void setLocalMatrix(size_t entity, const glm::mat4 &localMatrix) noexcept;
+  bool setParent(size_t entity, size_t parent) noexcept;
+  void setComponentPtrs(size_t                                         entity,
+                        const std::vector<std::shared_ptr<Component>> &componentPtrs) noexcept;
+
+  // Getters
+  size_t                                         getEntityCount() const noexcept;
+  size_t                                         getSceneObjectCount() const noexcept;
+  SceneObject                                   *getSceneObjectPtr(size_t entity) const noexcept;
+  const std::vector<glm::vec3>                  &getTranslates() const noexcept;
+  std::vector<glm::vec3>                        &getTranslates() noexcept;
+  const std::vector<glm::vec3>                  &getRotates() const noexcept;
+  std::vector<glm::vec3>                        &getRotates() noexcept;
+  const std::vector<glm::vec3>                  &getScales() const noexcept;
+  std::vector<glm::vec3>                        &getScales() noexcept;
+  const std::vector<glm::mat4>                  &getLocalMatrices() const noexcept;
+  const std::vector<glm::mat4>                  &getModelMatrices() const noexcept;
+  std::vector<glm::mat4>                        &getModelMatrices() noexcept;
+  const std::vector<size_t>                     &getTransformGenerations() const noexcept;
+  std::vector<size_t>                           &getTransformGenerations() noexcept;
+  const std::vector<size_t>                     &getParents() const noexcept;
+  const TransformStats                          &getTransformStats() const noexcept;
+  const std::vector<std::shared_ptr<Component>> &getComponentPtrs(size_t entity) const noexcept;
+  std::vector<std::shared_ptr<Component>>       &getComponentPtrs(size_t entity) noexcept;
+  const std::vector<SceneComponent<Mesh>>             &getMeshes() noexcept;
+  const std::vector<SceneComponent<BaseLight>>        &getLights() noexcept;
+  const std::vector<SceneComponent<DirectionalLight>> &getDirectionalLights() noexcept;
+  const std::vector<SceneComponent<PointLight>>       &getPointLights() noexcept;
+  const std::vector<SceneComponent<SpotLight>>        &getSpotLights() noexcept;
+
+  // Other member functions
+  size_t createEntity(SceneObject *sceneObjectPtr) noexcept;
+  void   destroyEntity(size_t entity) noexcept;
+  bool   isEntityAlive(size_t entity) const noexcept;
+  void   copyTransform(size_t entity, size_t sourceEntity) noexcept;
+  void   markTransformDirty(size_t entity) noexcept;
+  void   updateTransforms(JobSystem *jobSystemPtr = nullptr) noexcept;
+  void   sortComponents() noexcept;
+  void   updateComponentArrays() noexcept;
+
+  // Gets components of specific type (Mesh, BaseLight or exact light type, so spot lights are
+  // not directional or point ones) owned by entity without type checks or allocations
+  template <typename T>
+  SceneComponentRange<T> getComponents(size_t entity) noexcept {
+    updateComponentArrays();
+
+    if constexpr (std::is_same_v<T, Mesh>) {
+      return getComponentRange(_meshes, &ComponentOffsets::mesh, entity);
+    } else if constexpr (std::is_same_v<T, BaseLight>) {
+      return getComponentRange(_lights, &ComponentOffsets::light, entity);
+    } else if constexpr (std::is_same_v<T, DirectionalLight>) {
+      return getComponentRange(_directionalLights, &ComponentOffsets::directionalLight, entity);
+    } else if constexpr (std::is_same_v<T, PointLight>) {
+      return getComponentRange(_pointLights, &ComponentOffsets::pointLight, entity);
+    } else {
+      static_assert(std::is_same_v<T, SpotLight>,
+                    "Component type must be Mesh, BaseLight, DirectionalLight, PointLight "
+                    "or SpotLight");
+      return getComponentRange(_spotLights, &ComponentOffsets::spotLight, entity);
+    }
+  }
+
+  // Other static member functions
+  static Scene               &getDefaultScene() noexcept;
+  static std::atomic<size_t> &getMutableTransformGeneration() noexcept;
+
+ private:
+  // Gets range of typed components of entity (entities created after components were sorted
+  // own none)
+  template <typename T>
+  SceneComponentRange<T> getComponentRange(const std::vector<SceneComponent<T>> &components,
+                                           size_t ComponentOffsets::*offset,
+                                           size_t entity) const noexcept {
+    if (entity + 1 >= _componentOffsets.size()) return SceneComponentRange<T>{};
+
+    return SceneComponentRange<T>{components.data() + _componentOffsets[entity].*offset,
+                                  components.data() + _componentOffsets[entity + 1].*offset};
+  }
+};
+
+}  // namespace glengine
+
+#endif
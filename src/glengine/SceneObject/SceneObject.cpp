@@ -3,7 +3,15 @@
 
 // STD
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstdarg>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <string>
 #include <utility>
 
@@ -12,198 +20,509 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/euler_angles.hpp>
 
+// "glengine" internal library
+#include "../shader/uniformBuffer.hpp"
+#include "../shader/uniformCache.hpp"
+#include "./ShadowAtlas.hpp"
+#include "./ShadowCubeMapPool.hpp"
+
 using namespace glengine;
 
 // Global constants
-static constexpr size_t kMaxDirectionalLightCount = 8;
-static constexpr size_t kMaxPointLightCount       = 8;
-static constexpr size_t kMaxSpotLightCount        = 8;
+// (directional lights are kept in uniform block, point and spot lights in shader storage
+// buffers; only point lights with shadow cube map are limited by texture units, since each
+// takes its own sampler; they must match shader defines)
+static constexpr size_t kMaxDirectionalLightCount   = 8;
+static constexpr size_t kMaxPointLightCount         = 1024;
+static constexpr size_t kMaxSpotLightCount          = 256;
+static constexpr size_t kMaxShadowedPointLightCount = 8;
+
+// Light cluster grid (screen tiles and exponential depth slices of view frustum), work group
+// size of light clustering compute shader and light index list capacity (they must match
+// shader defines)
+static constexpr glm::uvec3 kLightClusterGridSize{16, 9, 24};
+static constexpr GLuint     kLightClusterWorkGroupSize = 64;
+static constexpr size_t     kLightClusterCount =
+    kLightClusterGridSize.x * kLightClusterGridSize.y * kLightClusterGridSize.z;
+static constexpr size_t kMaxLightIndexCount = kLightClusterCount * 32;
 
 static constexpr float kShadowMapDistance = 20.0f;
 
-// External linkage global variables
-extern GLuint gTextureBlack;
-extern GLuint gTextureWhite;
+// Luminance of attenuated light color light range ends at (lights are culled beyond it, and
+// shadow map resolution follows projected size of range sphere)
+static constexpr float     kMinLightLuminance = 1.0f / 256.0f;
+static constexpr glm::vec3 kLuminanceWeights{0.2126f, 0.7152f, 0.0722f};
+
+// Weight of logarithmic split distribution in practical cascade split scheme (rest is uniform)
+static constexpr float kShadowCascadeSplitLambda = 0.75f;
+
+// Frames scene object transform must stay unchanged for to be cached as static shadow caster
+static constexpr size_t kStaticShadowCasterFrameCount = 30;
+
+// Shadow map texture units (follow material texture units and match shader sampler bindings)
+static constexpr GLuint kShadowAtlasTextureUnit         = 7;
+static constexpr GLuint kPointLightShadowMapTextureUnit = kShadowAtlasTextureUnit + 1;
+
+// Texture units and image unit of shadow map filter compute shader (match its bindings)
+static constexpr GLuint kShadowFilterDepthTextureUnit     = 0;
+static constexpr GLuint kShadowFilterDepthCubeTextureUnit = 1;
+static constexpr GLuint kShadowFilterBlurTextureUnit      = 2;
+static constexpr GLuint kShadowFilterOutputImageUnit      = 0;
+static constexpr GLuint kShadowFilterWorkGroupSize        = 8;
+
+// FrameData uniform block struct (std140 layout)
+struct FrameDataBlock {
+  glm::mat4 view{};
+  glm::mat4 proj{};
+  glm::vec3 viewPos{};
+  float     padding{};
+  glm::mat4 invViewProj{};  // reconstructs world positions from depth in deferred shading
+};
+
+// Directional light struct of Lights uniform block (std140 layout)
+struct DirectionalLightBlock {
+  glm::vec3                                     color{};
+  GLuint                                        cascadeCount{};
+  glm::vec3                                     dir{};
+  float                                         padding{};
+  glm::vec4                                     cascadeSplits{};  // view depth of cascade ends
+  std::array<glm::mat4, kMaxShadowCascadeCount> VPs{};
+  std::array<glm::vec4, kMaxShadowCascadeCount> atlasRects{};  // shadow atlas tiles of cascades
+};
+
+// Point light struct of PointLights shader storage block (std430 layout)
+struct PointLightBlock {
+  glm::vec3 worldPos{};
+  float     range{};  // distance where attenuated luminance reaches kMinLightLuminance
+  glm::vec3 color{};
+  float     linAttCoef{};
+  float     quadAttCoef{};
+  float     farPlane{};
+  float     padding1[2]{};
+};
+
+// Spot light struct of SpotLights shader storage block (std430 layout)
+struct SpotLightBlock {
+  glm::vec3 worldPos{};
+  float     range{};  // distance where attenuated luminance reaches kMinLightLuminance
+  glm::vec3 color{};
+  float     padding1{};
+  glm::vec3 dir{};
+  float     linAttCoef{};
+  float     quadAttCoef{};
+  float     angle{};
+  float     smoothAngle{};
+  float     padding2{};
+  glm::mat4 VP{1.0f};
+  glm::vec4 atlasRect{};  // shadow atlas tile UV offset and size (zero if light has no tile)
+};
+
+// Lights uniform block struct (std140 layout)
+struct LightsBlock {
+  glm::vec3                                                    ambientColor{};
+  GLuint                                                       directionalLightCount{};
+  GLuint                                                       pointLightCount{};
+  GLuint                                                       spotLightCount{};
+  GLuint                                                       isShadowFiltered{};
+  GLuint                                                       shadowedPointLightCount{};
+  std::array<DirectionalLightBlock, kMaxDirectionalLightCount> directionalLights{};
+};
+
+// LightClusterData uniform block struct (std140 layout)
+struct LightClusterDataBlock {
+  glm::mat4  view{};
+  glm::mat4  invProj{};
+  glm::uvec3 gridSize{};
+  GLuint     isClustered{};  // clusters were filled this frame (all the lights are used if not)
+  glm::vec2  screenSize{};
+  float      nearPlane{};
+  float      farPlane{};
+};
+
+// Light cluster struct of LightClusters shader storage block (std430 layout)
+struct LightClusterBlock {
+  GLuint offset{};  // of the first light index in LightIndices shader storage block
+  GLuint pointLightCount{};
+  GLuint spotLightCount{};
+  GLuint padding{};
+};
+
+static_assert(sizeof(FrameDataBlock) == 208, "FrameData block must follow std140 layout");
+static_assert(sizeof(DirectionalLightBlock) == 368, "DirectionalLight must follow std140 layout");
+static_assert(sizeof(PointLightBlock) == 48, "PointLight must follow std430 layout");
+static_assert(sizeof(SpotLightBlock) == 144, "SpotLight must follow std430 layout");
+static_assert(sizeof(LightsBlock) <= 16384, "Lights block must fit minimal uniform block size");
+static_assert(sizeof(LightClusterDataBlock) == 160,
+              "LightClusterData block must follow std140 layout");
+static_assert(sizeof(LightClusterBlock) == 16, "LightCluster must follow std430 layout");
+
+// Shadow atlas tile request struct (light waiting for all the lights to be gathered and packed)
+struct ShadowAtlasRequest {
+  const SceneObject      *sceneObjectPtr{};
+  const SpotLight        *spotLightPtr{};         // set for spot lights only
+  const DirectionalLight *directionalLightPtr{};  // set for directional lights only
+  GLuint                  index{};                // index of light in its block
+  unsigned int            cascadeIndex{};         // cascade of directional light
+};
+
+// Shadow cube map request struct (point light waiting for all the lights to be gathered and
+// assigned cube maps of pool)
+struct ShadowCubeMapRequest {
+  const SceneObject *sceneObjectPtr{};
+  const PointLight  *pointLightPtr{};
+  GLuint             index{};  // index of light in its block
+};
+
+// Shadow cache entry struct (everything static depth of shadow map depends on, so it is
+// rendered again only when any of it changes)
+struct ShadowCacheEntry {
+  glm::mat4         lightVPMatrix{};      // light VP matrix (of the first face for point lights)
+  ShadowAtlasTile   tile{};               // atlas tile (unused for point lights)
+  size_t            cubeMapIndex{};       // cube map of pool (point lights only)
+  uint64_t          staticCasterHash{};   // hash of static casters in light volume
+  bool              hasDynamicCasters{};  // dynamic casters were drawn over static depth
+  bool              isValid{};            // static depth has been rendered
+  bool              isDepthUpdated{};     // depth changed this frame (moments must be filtered)
+  size_t            frame{};              // last frame entry was used (unused entries are dropped)
+};
+
+// Shadow cache key (light and cascade of directional light)
+using ShadowCacheKey = std::pair<const BaseLight *, unsigned int>;
+
+// Shadow caster volume struct (meshes cast shadow into shadow map only if they are inside of
+// light frustum and their bounding sphere swept along sweep direction intersects bounding
+// sphere; light range sphere is not swept, cascade sphere is swept along light direction)
+struct ShadowCasterVolume {
+  FrustumPlanes frustumPlanes{};
+  glm::vec4     boundingSphere{};  // center and radius
+  glm::vec3     sweepDirection{};  // zero for lights with range
+};
 
 // Local function headers
 
-static void renderSpotLightShadowMap(const std::vector<SceneObject> &sceneObjects,
-                                     std::vector<glm::mat4>         &spotLightVPMatrices,
-                                     const SceneObject              &spotLightSceneObject,
-                                     const SpotLight                *spotLightPtr,
-                                     GLuint spotLightShadowMapShaderProgram);
-static void renderDirectionalLightShadowMap(const std::vector<SceneObject> &sceneObjects,
-                                            std::vector<glm::mat4> &directionalLightVPMatrices,
-                                            const SceneObject      &directionalLightSceneObject,
-                                            const DirectionalLight *directionalLightPtr,
-                                            GLuint directionalLightShadowMapShaderProgram,
-                                            const BaseCamera &camera);
-static void renderPointLightShadowMap(const std::vector<SceneObject> &sceneObjects,
-                                      std::vector<float>             &pointLightFarPlanes,
-                                      const SceneObject              &pointLightSceneObject,
-                                      const PointLight               *pointLightPtr,
-                                      GLuint pointLightShadowMapShaderProgram);
-static void updateShaderProgramSpotLights(
-    GLuint shaderProgram, const std::vector<const SpotLight *> &spotLightPtrs,
-    const std::vector<const SceneObject *> &spotLightSceneObjectPtrs,
-    GLuint spotLightShadowMapShaderProgram, int &currShadowMapTextureUnit,
-    std::vector<glm::mat4> &spotLightVPMatrices);
-static void updateShaderProgramDirectionalLights(
-    GLuint shaderProgram, const std::vector<const DirectionalLight *> &directionalLightPtrs,
-    const std::vector<const SceneObject *> &directionalLightSceneObjectPtrs,
-    GLuint directionalLightShadowMapShaderProgram, int &currShadowMapTextureUnit,
-    std::vector<glm::mat4> &directionalLightVPMatrices);
-static void updateShaderProgramPointLights(
-    GLuint shaderProgram, const std::vector<const PointLight *> &pointLightPtrs,
-    const std::vector<const SceneObject *> &pointLightSceneObjectPtrs,
-    GLuint pointLightShadowMapShaderProgram, int &currShadowMapTextureUnit,
-    std::vector<float> &pointLightFarPlanes);
+static GLuint            getFrameDataUniformBuffer();
+static GLuint            getLightsUniformBuffer();
+static GLuint            getLightClusterDataUniformBuffer();
+static GLuint            getPointLightsStorageBuffer();
+static GLuint            getSpotLightsStorageBuffer();
+static GLuint            getLightClustersStorageBuffer();
+static GLuint            getLightIndicesStorageBuffer();
+static CullingStats     &getMutableCullingStats();
+static ShadowCacheStats &getMutableShadowCacheStats();
+static std::vector<ShadowCasterStats> &getMutableShadowCasterStats();
+static std::vector<const SceneObject *> &getShadowCasterPtrs();
+static std::unique_ptr<ShadowAtlas>               &getShadowAtlasPtr();
+static std::unique_ptr<ShadowCubeMapPool>         &getShadowCubeMapPoolPtr();
+static size_t                                     &getMutableShadowCubeMapPoolBudget();
+static std::map<ShadowCacheKey, ShadowCacheEntry> &getShadowCache();
+static glm::vec4 calculateMeshBoundingSphere(const SceneObject &sceneObject, const Mesh &mesh);
+static bool      isMeshInFrustum(const SceneObject &sceneObject, const Mesh &mesh,
+                                 const FrustumPlanes &frustumPlanes);
+static bool      isMeshInShadowCasterVolume(const SceneObject &sceneObject, const Mesh &mesh,
+                                            const ShadowCasterVolume &casterVolume);
+static void      renderSceneObjectDepthOnly(const SceneObject   &sceneObject,
+                                            const FrustumPlanes &frustumPlanes,
+                                            size_t               firstTransformGeneration,
+                                            size_t lastTransformGeneration, GLint modelLocation,
+                                            GLint instancedLocation, GLuint &currentVAO);
+static Scene    *markSceneObjectEntities(const std::vector<SceneObject> &sceneObjects,
+                                         std::vector<bool>              &isEntityMarked);
+static uint64_t  gatherShadowCasters(const std::vector<SceneObject> &sceneObjects,
+                                     const ShadowCasterVolume       &casterVolume,
+                                     size_t                          staticTransformGeneration,
+                                     std::vector<const SceneObject *> &casterPtrs,
+                                     bool &hasDynamicCasters, ShadowCasterStats &casterStats);
+static float         calculateLightRange(const PointLight &light);
+static GLsizei       calculateShadowMapResolution(const SceneObject &lightSceneObject,
+                                                  const PointLight  &light,
+                                                  const BaseCamera  &camera);
+static void          renderSceneObject(const SceneObject &sceneObject, float exposure,
+                                       const FrustumPlanes *frustumPlanesPtr);
+static FrustumPlanes calculateRangeFrustumPlanes(const glm::vec3 &center, float range);
+static glm::vec3 calculateLightDirection(const SceneObject &lightSceneObject,
+                                         const glm::vec3   &direction);
+static PerspectiveCamera calculateSpotLightShadowMapCamera(
+    const SceneObject &spotLightSceneObject, const SpotLight *spotLightPtr);
+static std::array<glm::vec3, 8> calculateFrustumCorners(const BaseCamera &camera);
+static float calculateCascadeSplit(float nearPlane, float farPlane, unsigned int splitIndex,
+                                   unsigned int cascadeCount);
+static glm::vec4 calculateCascadeBoundingSphere(const std::array<glm::vec3, 8> &cascadeCorners);
+static OrthographicCamera calculateDirectionalLightShadowMapCamera(
+    const SceneObject &directionalLightSceneObject, const DirectionalLight *directionalLightPtr,
+    const glm::vec4 &cascadeSphere, GLsizei tileResolution);
+static glm::mat4 renderAtlasShadowMap(const std::vector<SceneObject> &sceneObjects,
+                                      const BaseCamera &shadowMapCamera,
+                                      const glm::vec4  &casterBoundingSphere,
+                                      const glm::vec3 &casterSweepDirection, GLuint shaderProgram,
+                                      const ShadowAtlas &shadowAtlas, const ShadowAtlasTile &tile,
+                                      size_t staticTransformGeneration, ShadowCacheEntry &entry,
+                                      ShadowCasterStats &casterStats);
+static GLuint     getShadowFilterBlurTexture(GLsizei resolution);
+static void      filterShadowMap(GLuint filterShaderProgram, GLuint depthTexture, GLint face,
+                                 GLuint momentsTexture, GLuint blurTexture,
+                                 const glm::ivec4 &momentsRect);
+static void      renderPointLightCasters(const std::vector<const SceneObject *> &casterPtrs,
+                                         GLuint                                  shaderProgram,
+                                         const std::array<FrustumPlanes, 6> &faceFrustumPlanes,
+                                         const FrustumPlanes &rangeFrustumPlanes,
+                                         size_t               firstTransformGeneration,
+                                         size_t               lastTransformGeneration);
+static float     renderPointLightShadowMap(const std::vector<SceneObject> &sceneObjects,
+                                           const SceneObject              &pointLightSceneObject,
+                                           const PointLight               *pointLightPtr,
+                                           GLuint             pointLightShadowMapShaderProgram,
+                                           size_t             staticTransformGeneration,
+                                           size_t             cubeMapIndex,
+                                           ShadowCubeMap     &cubeMap,
+                                           ShadowCacheEntry  &entry,
+                                           ShadowCasterStats &casterStats);
+
+// Uniform handles (registered once instead of building uniform names every frame)
+static const UniformHandle kModelUniform         = registerUniform("MODEL");
+static const UniformHandle kLightColorUniform    = registerUniform("LIGHT_COLOR");
+static const UniformHandle kExposureUniform      = registerUniform("EXPOSURE");
+static const UniformHandle kLightWorldPosUniform = registerUniform("LIGHT.worldPos");
+static const UniformHandle kLightFarPlaneUniform = registerUniform("LIGHT.farPlane");
+static const UniformHandle kLightVPUniform       = registerUniform("LIGHT_VP");
+static const UniformHandle kInstancedUniform     = registerUniform("INSTANCED");
+static const UniformHandle kLightLayerUniform    = registerUniform("LIGHT_LAYER");
+static const UniformHandle kFilterPassUniform    = registerUniform("FILTER_PASS");
+static const UniformHandle kFilterFaceUniform    = registerUniform("FILTER_FACE");
+static const UniformHandle kFilterRectUniform    = registerUniform("FILTER_RECT");
+static const std::array<UniformHandle, 6> kLightVPUniforms{
+    registerUniform("LIGHT_VP[0]"), registerUniform("LIGHT_VP[1]"),
+    registerUniform("LIGHT_VP[2]"), registerUniform("LIGHT_VP[3]"),
+    registerUniform("LIGHT_VP[4]"), registerUniform("LIGHT_VP[5]"),
+};
 
 // Constructors, assignment operators and destructor
 
 // Default constructor
-SceneObject::SceneObject() noexcept { recalculateModelMatrix(); }
+SceneObject::SceneObject() noexcept
+    : _scenePtr{&Scene::getDefaultScene()}, _entity{_scenePtr->createEntity(this)} {
+  recalculateModelMatrix();
+}
 
 // Parameterized constructor
 SceneObject::SceneObject(const glm::vec3 &translate, const glm::vec3 &rotate,
                          const glm::vec3                               &scale,
                          const std::vector<std::shared_ptr<Component>> &componentPtrs) noexcept
-    : _translate{translate}, _rotate{rotate}, _scale{scale}, _componentPtrs{componentPtrs} {
+    : SceneObject{Scene::getDefaultScene(), translate, rotate, scale, componentPtrs} {}
+
+// Parameterized constructor
+SceneObject::SceneObject(Scene &scene, const glm::vec3 &translate, const glm::vec3 &rotate,
+                         const glm::vec3                               &scale,
+                         const std::vector<std::shared_ptr<Component>> &componentPtrs) noexcept
+    : _scenePtr{&scene}, _entity{scene.createEntity(this)} {
+  scene.getTranslates()[_entity] = translate;
+  scene.getRotates()[_entity]    = rotate;
+  scene.getScales()[_entity]     = scale;
+  scene.setComponentPtrs(_entity, componentPtrs);
   recalculateModelMatrix();
 }
 
 // Parameterized constructor
 SceneObject::SceneObject(const glm::vec3 &translate, const glm::vec3 &rotate,
                          const glm::vec3 &scale, int initComponentsCount, ...)
-    : _translate{translate}, _rotate{rotate}, _scale{scale} {
+    : SceneObject{} {
+  _scenePtr->getTranslates()[_entity] = translate;
+  _scenePtr->getRotates()[_entity]    = rotate;
+  _scenePtr->getScales()[_entity]     = scale;
   recalculateModelMatrix();
 
   // Adding components to components pointers vector
-  va_list componentPtrList{};
+  std::vector<std::shared_ptr<Component>> &componentPtrs = getComponentPtrs();
+  va_list                                  componentPtrList{};
   va_start(componentPtrList, initComponentsCount);
   for (int i = 0; i < initComponentsCount; ++i) {
-    _componentPtrs.push_back(va_arg(componentPtrList, std::shared_ptr<Component>));
+    componentPtrs.push_back(va_arg(componentPtrList, std::shared_ptr<Component>));
   }
   va_end(componentPtrList);
 }
 
-// Copy constructor
+// Copy constructor (copy gets its own entity in the same scene)
 SceneObject::SceneObject(const SceneObject &sceneObject) noexcept
-    : _translate{sceneObject._translate},
-      _rotate{sceneObject._rotate},
-      _scale{sceneObject._scale},
-      _modelMatrix{sceneObject._modelMatrix},
-      _componentPtrs{sceneObject._componentPtrs} {}
+    : _scenePtr{sceneObject._scenePtr}, _entity{_scenePtr->createEntity(this)} {
+  Scene &scene = *_scenePtr;
+  scene.copyTransform(_entity, sceneObject._entity);
+  scene.getTransformGenerations()[_entity] = ++Scene::getMutableTransformGeneration();
+  scene.setComponentPtrs(_entity, std::as_const(scene).getComponentPtrs(sceneObject._entity));
+}
 
 // Copy assignment operator
 SceneObject &SceneObject::operator=(const SceneObject &sceneObject) noexcept {
-  _translate     = sceneObject._translate;
-  _rotate        = sceneObject._rotate;
-  _scale         = sceneObject._scale;
-  _modelMatrix   = sceneObject._modelMatrix;
-  _componentPtrs = sceneObject._componentPtrs;
+  // If scene object was moved from or belongs to other scene, it takes entity in scene
+  // of the copied one
+  if (_scenePtr != sceneObject._scenePtr) {
+    if (_scenePtr != nullptr) _scenePtr->destroyEntity(_entity);
+    _scenePtr = sceneObject._scenePtr;
+    _entity   = _scenePtr->createEntity(this);
+  }
+
+  Scene &scene = *_scenePtr;
+  scene.copyTransform(_entity, sceneObject._entity);
+  scene.getTransformGenerations()[_entity] = ++Scene::getMutableTransformGeneration();
+  scene.setComponentPtrs(_entity, std::as_const(scene).getComponentPtrs(sceneObject._entity));
 
   return *this;
 }
 
-// Move constructor
+// Move constructor (entity is taken over, moved from scene object owns none and must be
+// assigned before it is used again)
 SceneObject::SceneObject(SceneObject &&sceneObject) noexcept
-    : _translate{std::exchange(sceneObject._translate, glm::vec3{})},
-      _rotate{std::exchange(sceneObject._rotate, glm::vec3{})},
-      _scale{std::exchange(sceneObject._scale, glm::vec3{})},
-      _modelMatrix{std::exchange(sceneObject._modelMatrix, glm::mat4{})},
-      _componentPtrs{
-          std::exchange(sceneObject._componentPtrs, std::vector<std::shared_ptr<Component>>{})} {}
+    : _scenePtr{std::exchange(sceneObject._scenePtr, nullptr)},
+      _entity{std::exchange(sceneObject._entity, Scene::kNoEntity)} {
+  // If scene object owned entity
+  if (_scenePtr != nullptr) {
+    _scenePtr->setSceneObjectPtr(_entity, this);
+
+    // Scene object changed its place in shadow casters
+    _scenePtr->getTransformGenerations()[_entity] = ++Scene::getMutableTransformGeneration();
+  }
+}
 
 // Move assignment operator
 SceneObject &SceneObject::operator=(SceneObject &&sceneObject) noexcept {
-  std::swap(_translate, sceneObject._translate);
-  std::swap(_rotate, sceneObject._rotate);
-  std::swap(_scale, sceneObject._scale);
-  std::swap(_modelMatrix, sceneObject._modelMatrix);
-  std::swap(_componentPtrs, sceneObject._componentPtrs);
+  std::swap(_scenePtr, sceneObject._scenePtr);
+  std::swap(_entity, sceneObject._entity);
+
+  // Both scene objects changed their place in shadow casters
+  if (_scenePtr != nullptr) {
+    _scenePtr->setSceneObjectPtr(_entity, this);
+    _scenePtr->getTransformGenerations()[_entity] = ++Scene::getMutableTransformGeneration();
+  }
+  if (sceneObject._scenePtr != nullptr) {
+    sceneObject._scenePtr->setSceneObjectPtr(sceneObject._entity, &sceneObject);
+    sceneObject._scenePtr->getTransformGenerations()[sceneObject._entity] =
+        ++Scene::getMutableTransformGeneration();
+  }
 
   return *this;
 }
 
 // Destructor
-SceneObject::~SceneObject() noexcept {}
+SceneObject::~SceneObject() noexcept {
+  if (_scenePtr != nullptr) _scenePtr->destroyEntity(_entity);
+}
 
 // Setters
 
 void SceneObject::setTranslate(const glm::vec3 &translate) noexcept {
-  _translate = translate;
+  _scenePtr->getTranslates()[_entity] = translate;
 
   recalculateModelMatrix();
 }
 
 void SceneObject::setRotate(const glm::vec3 &rotate) noexcept {
-  _rotate = rotate;
+  _scenePtr->getRotates()[_entity] = rotate;
 
   recalculateModelMatrix();
 }
 
 void SceneObject::setScale(const glm::vec3 &scale) noexcept {
-  _scale = scale;
+  _scenePtr->getScales()[_entity] = scale;
 
   recalculateModelMatrix();
 }
 
+// Sets model matrix relative to parent (it is kept until translate, rotate or scale change)
 void SceneObject::setModelMatrix(const glm::mat4 &modelMatrix) noexcept {
-  _modelMatrix = modelMatrix;
+  _scenePtr->setLocalMatrix(_entity, modelMatrix);
+}
+
+// Sets parent scene object of the same scene (nullptr makes scene object root; returns false
+// if parent is scene object itself, its descendant or belongs to other scene)
+bool SceneObject::setParent(const SceneObject *parentPtr) noexcept {
+  if (parentPtr == nullptr) return _scenePtr->setParent(_entity, Scene::kNoEntity);
+  if (parentPtr->_scenePtr != _scenePtr) return false;
+  return _scenePtr->setParent(_entity, parentPtr->_entity);
 }
 
 void SceneObject::setComponentPtrs(
     const std::vector<std::shared_ptr<Component>> &componentPtrs) noexcept {
-  _componentPtrs = componentPtrs;
+  _scenePtr->setComponentPtrs(_entity, componentPtrs);
+
+  // Meshes may have changed, so does depth scene object casts into shadow maps
+  _scenePtr->getTransformGenerations()[_entity] = ++Scene::getMutableTransformGeneration();
 }
 
-// Getters
+// Getters (references into scene arrays are invalidated once scene creates new entity;
+// model matrix is world one of the last scene transform update, non-const getters of translate,
+// rotate and scale flag it to be recalculated by the next update)
 
-const glm::vec3 &SceneObject::getTranslate() const noexcept { return _translate; }
+const glm::vec3 &SceneObject::getTranslate() const noexcept {
+  return std::as_const(*_scenePtr).getTranslates()[_entity];
+}
 
-glm::vec3 &SceneObject::getTranslate() noexcept { return _translate; }
+glm::vec3 &SceneObject::getTranslate() noexcept {
+  _scenePtr->markTransformDirty(_entity);
+  return _scenePtr->getTranslates()[_entity];
+}
 
-const glm::vec3 &SceneObject::getRotate() const noexcept { return _rotate; }
+const glm::vec3 &SceneObject::getRotate() const noexcept {
+  return std::as_const(*_scenePtr).getRotates()[_entity];
+}
 
-glm::vec3 &SceneObject::getRotate() noexcept { return _rotate; }
+glm::vec3 &SceneObject::getRotate() noexcept {
+  _scenePtr->markTransformDirty(_entity);
+  return _scenePtr->getRotates()[_entity];
+}
 
-const glm::vec3 &SceneObject::getScale() const noexcept { return _scale; }
+const glm::vec3 &SceneObject::getScale() const noexcept {
+  return std::as_const(*_scenePtr).getScales()[_entity];
+}
 
-glm::vec3 &SceneObject::getScale() noexcept { return _scale; }
+glm::vec3 &SceneObject::getScale() noexcept {
+  _scenePtr->markTransformDirty(_entity);
+  return _scenePtr->getScales()[_entity];
+}
 
-const glm::mat4 &SceneObject::getModelMatrix() const noexcept { return _modelMatrix; }
+const glm::mat4 &SceneObject::getModelMatrix() const noexcept {
+  return std::as_const(*_scenePtr).getModelMatrices()[_entity];
+}
 
-glm::mat4 &SceneObject::getModelMatrix() noexcept { return _modelMatrix; }
+glm::mat4 &SceneObject::getModelMatrix() noexcept {
+  return _scenePtr->getModelMatrices()[_entity];
+}
 
 const std::vector<std::shared_ptr<Component>> &SceneObject::getComponentPtrs() const noexcept {
-  return _componentPtrs;
+  return std::as_const(*_scenePtr).getComponentPtrs(_entity);
 }
 
 std::vector<std::shared_ptr<Component>> &SceneObject::getComponentPtrs() noexcept {
-  return _componentPtrs;
+  return _scenePtr->getComponentPtrs(_entity);
 }
 
-// Other member functions
+size_t SceneObject::getTransformGeneration() const noexcept {
+  return std::as_const(*_scenePtr).getTransformGenerations()[_entity];
+}
 
-void SceneObject::recalculateModelMatrix() noexcept {
-  // Calculating scene object model matrix
-  _modelMatrix = glm::translate(glm::mat4{1.0f}, _translate);
-  _modelMatrix = _modelMatrix * glm::eulerAngleXYZ(glm::radians(_rotate.x), glm::radians(_rotate.y),
-                                                   glm::radians(_rotate.z));
-  _modelMatrix = glm::scale(_modelMatrix, _scale);
+SceneObject *SceneObject::getParentPtr() const noexcept {
+  const size_t parent = _scenePtr->getParents()[_entity];
+  return parent != Scene::kNoEntity ? _scenePtr->getSceneObjectPtr(parent) : nullptr;
 }
 
+Scene *SceneObject::getScenePtr() const noexcept { return _scenePtr; }
+
+size_t SceneObject::getEntity() const noexcept { return _entity; }
+
+// Other member functions
+
+// Flags model matrix to be recalculated by the next scene transform update (transform changed
+// through scene arrays must be followed by this call)
+void SceneObject::recalculateModelMatrix() noexcept { _scenePtr->markTransformDirty(_entity); }
+
 std::vector<std::shared_ptr<const Component>> SceneObject::getSpecificComponentPtrs(
     ComponentType type) const noexcept {
-  std::vector<std::shared_ptr<const Component>> specificComponentPtrs{};
+  const std::vector<std::shared_ptr<Component>> &componentPtrs = getComponentPtrs();
+  std::vector<std::shared_ptr<const Component>>  specificComponentPtrs{};
 
   // For each component
-  for (size_t i = 0; i < _componentPtrs.size(); ++i) {
+  for (size_t i = 0; i < componentPtrs.size(); ++i) {
     // If current component has specific component type
-    if (_componentPtrs[i]->getType() == type) {
+    if (componentPtrs[i]->getType() == type) {
       // Pushing current component into the vector
-      specificComponentPtrs.push_back(std::shared_ptr<const Component>{_componentPtrs[i]});
+      specificComponentPtrs.push_back(std::shared_ptr<const Component>{componentPtrs[i]});
     }
   }
 
@@ -212,14 +531,16 @@ std::vector<std::shared_ptr<const Component>> SceneObject::getSpecificComponentP
 
 std::vector<std::shared_ptr<Component>> SceneObject::getSpecificComponentPtrs(
     ComponentType type) noexcept {
+  const std::vector<std::shared_ptr<Component>> &componentPtrs =
+      std::as_const(*this).getComponentPtrs();
   std::vector<std::shared_ptr<Component>> specificComponentPtrs{};
 
   // For each component
-  for (size_t i = 0; i < _componentPtrs.size(); ++i) {
+  for (size_t i = 0; i < componentPtrs.size(); ++i) {
     // If current component has specific component type
-    if (_componentPtrs[i]->getType() == type) {
+    if (componentPtrs[i]->getType() == type) {
       // Pushing current component into the vector
-      specificComponentPtrs.push_back(_componentPtrs[i]);
+      specificComponentPtrs.push_back(componentPtrs[i]);
     }
   }
 
@@ -234,8 +555,8 @@ void SceneObject::updateShaderModelMatrix(const Mesh &mesh) const noexcept {
 
     glUseProgram(shaderProgram);
 
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "MODEL"), 1, GL_FALSE,
-                       glm::value_ptr(_modelMatrix));
+    glUniformMatrix4fv(getUniformLocation(shaderProgram, kModelUniform), 1, GL_FALSE,
+                       glm::value_ptr(getModelMatrix()));
 
     glUseProgram(0);
   }
@@ -249,7 +570,7 @@ void SceneObject::updateShaderLightColor(const Mesh &mesh, const BaseLight &ligh
 
     glUseProgram(shaderProgram);
 
-    glUniform3fv(glGetUniformLocation(shaderProgram, "LIGHT_COLOR"), 1,
+    glUniform3fv(getUniformLocation(shaderProgram, kLightColorUniform), 1,
                  glm::value_ptr(light.getColor()));
 
     glUseProgram(0);
@@ -264,42 +585,44 @@ void SceneObject::updateShaderExposure(const Mesh &mesh, float exposure) const n
 
     glUseProgram(shaderProgram);
 
-    glUniform1f(glGetUniformLocation(shaderProgram, "EXPOSURE"), exposure);
+    glUniform1f(getUniformLocation(shaderProgram, kExposureUniform), exposure);
 
     glUseProgram(0);
   }
 }
 
-void SceneObject::render(float exposure) const noexcept {
-  // Getting mesh components pointers and light component pointer
-  std::vector<std::shared_ptr<const Component>> meshPtrs{
-      getSpecificComponentPtrs(ComponentType::Mesh)};
-  std::vector<std::shared_ptr<const Component>> lightPtrs{
-      getSpecificComponentPtrs(ComponentType::Light)};
+bool SceneObject::isMeshVisible(const Mesh          &mesh,
+                                const FrustumPlanes &frustumPlanes) const noexcept {
+  return isMeshVisible(mesh, frustumPlanes, getMutableCullingStats());
+}
 
-  // Using the first light component if scene object has at least one
-  const BaseLight *lightPtr{};
-  if (lightPtrs.size() >= 1) {
-    lightPtr = dynamic_cast<const BaseLight *>(lightPtrs[0].get());
+// Checks mesh visibility counting it in given statistics (so meshes may be checked
+// on different threads and their statistics added afterwards)
+bool SceneObject::isMeshVisible(const Mesh &mesh, const FrustumPlanes &frustumPlanes,
+                                CullingStats &cullingStats) const noexcept {
+  // Meshes without bounding volume and instanced meshes (instances are placed by shader)
+  // are always considered visible
+  if (!mesh.hasBoundingVolume() || mesh.getInstanceCount() > 1) {
+    ++cullingStats.visibleMeshCount;
+    return true;
   }
 
-  // For each mesh component
-  for (size_t i = 0; i < meshPtrs.size(); ++i) {
-    const Mesh &mesh = *dynamic_cast<const Mesh *>(meshPtrs[i].get());
-
-    // If mesh is complete
-    if (mesh.isComplete()) {
-      // Updating shader uniform variables
-      updateShaderModelMatrix(mesh);
-      if (lightPtr != nullptr) {
-        updateShaderLightColor(mesh, *lightPtr);
-      }
-      updateShaderExposure(mesh, exposure);
-
-      // Rendering mesh
-      mesh.render();
-    }
+  // If bounding sphere is outside of frustum
+  if (!isMeshInFrustum(*this, mesh, frustumPlanes)) {
+    ++cullingStats.culledMeshCount;
+    return false;
   }
+
+  ++cullingStats.visibleMeshCount;
+  return true;
+}
+
+void SceneObject::render(float exposure) const noexcept {
+  renderSceneObject(*this, exposure, nullptr);
+}
+
+void SceneObject::render(const FrustumPlanes &frustumPlanes, float exposure) const noexcept {
+  renderSceneObject(*this, exposure, &frustumPlanes);
 }
 
 // Other static member functions
@@ -309,382 +632,1055 @@ void SceneObject::updateShadersLights(const std::vector<SceneObject> &sceneObjec
                                       GLuint            directionalLightShadowMapShaderProgram,
                                       GLuint            pointLightShadowMapShaderProgram,
                                       GLuint            spotLightShadowMapShaderProgram,
-                                      const BaseCamera &camera) noexcept {
-  // Getting shader programs, light sources, their scene objects and light cameras matrices
-  std::vector<GLuint>                   shaderPrograms{};
-  std::vector<const SpotLight *>        spotLightPtrs{};
-  std::vector<const DirectionalLight *> directionalLightPtrs{};
-  std::vector<const PointLight *>       pointLightPtrs{};
-  std::vector<const SceneObject *>      spotLightSceneObjectPtrs{};
-  std::vector<const SceneObject *>      directionalLightSceneObjectPtrs{};
-  std::vector<const SceneObject *>      pointLightSceneObjectPtrs{};
-  std::vector<glm::mat4>                spotLightVPMatrices{};
-  std::vector<glm::mat4>                directionalLightVPMatrices{};
-  std::vector<float>                    pointLightFarPlanes{};
-  // For each scene object
-  for (size_t i = 0; i < sceneObjects.size(); ++i) {
-    const SceneObject &sceneObject = sceneObjects[i];
-
-    // Getting mesh and light component pointers
-    std::vector<std::shared_ptr<const Component>> meshPtrs{
-        sceneObject.getSpecificComponentPtrs(ComponentType::Mesh)};
-    std::vector<std::shared_ptr<const Component>> lightPtrs{
-        sceneObject.getSpecificComponentPtrs(ComponentType::Light)};
-
-    // For each mesh component
-    for (size_t i = 0; i < meshPtrs.size(); ++i) {
-      const Mesh &mesh = *dynamic_cast<const Mesh *>(meshPtrs[i].get());
-
-      // Adding shader program to the vector if mesh is complete
-      if (mesh.isComplete()) {
-        const GLuint shaderProgram = mesh.getShaderProgram();
-
-        bool notInVector{true};
-        for (size_t i = 0; i < shaderPrograms.size(); ++i) {
-          if (shaderProgram == shaderPrograms[i]) {
-            notInVector = false;
-            break;
-          }
-        }
+                                      const BaseCamera &camera,
+                                      GLuint            shadowMapFilterShaderProgram,
+                                      GLuint            lightClusteringShaderProgram) noexcept {
+  // Lights uniform block data shared by all shader programs
+  LightsBlock lightsBlock{};
+  lightsBlock.ambientColor     = ambientColor;
+  lightsBlock.isShadowFiltered = static_cast<GLuint>(shadowMapFilterShaderProgram > 0);
+
+  // Point and spot lights shader storage blocks data (reused, so it is not allocated every time)
+  static std::vector<PointLightBlock> sPointLightBlocks{};
+  static std::vector<SpotLightBlock>  sSpotLightBlocks{};
+  sPointLightBlocks.clear();
+  sSpotLightBlocks.clear();
+
+  // Enabling Z- and disabling stencil testing
+  glEnable(GL_DEPTH_TEST);
+  glDepthFunc(GL_LESS);
+  glDisable(GL_STENCIL_TEST);
+
+  // Getting original viewport
+  int viewport[4] = {0};
+  glGetIntegerv(GL_VIEWPORT, &viewport[0]);
+
+  // Getting transform generation scene objects must be older than to be static shadow casters
+  // (the next one of kStaticShadowCasterFrameCount frames ago)
+  static std::array<size_t, kStaticShadowCasterFrameCount> sFrameTransformGenerations{};
+  static size_t                                            sFrame{};
+  size_t &frameTransformGeneration =
+      sFrameTransformGenerations[sFrame % kStaticShadowCasterFrameCount];
+  const size_t staticTransformGeneration = frameTransformGeneration;
+  frameTransformGeneration               = Scene::getMutableTransformGeneration() + 1;
+  ++sFrame;
+
+  // Shadow maps are cached per light (and cascade) between frames
+  std::map<ShadowCacheKey, ShadowCacheEntry> &shadowCache = getShadowCache();
+  getMutableShadowCacheStats()                           = ShadowCacheStats{};
+  std::vector<ShadowCasterStats> &shadowCasterStats      = getMutableShadowCasterStats();
+  shadowCasterStats.clear();
+
+  // Dropping all the cached shadow maps if filtering was switched (moments are not up to date)
+  static GLuint sLastShadowMapFilterShaderProgram{};
+  if (shadowMapFilterShaderProgram != sLastShadowMapFilterShaderProgram) {
+    shadowCache.clear();
+    sLastShadowMapFilterShaderProgram = shadowMapFilterShaderProgram;
+  }
 
-        if (notInVector) {
-          shaderPrograms.push_back(shaderProgram);
-        }
+  // Shadow atlas tiles of spot and directional lights (packed once all the lights are gathered;
+  // requests are reused, so they are not allocated every frame)
+  static std::vector<ShadowAtlasRequest> sShadowAtlasRequests{};
+  static std::vector<GLsizei>            sShadowAtlasResolutions{};
+  std::vector<ShadowAtlasRequest>       &shadowAtlasRequests    = sShadowAtlasRequests;
+  std::vector<GLsizei>                  &shadowAtlasResolutions = sShadowAtlasResolutions;
+  shadowAtlasRequests.clear();
+  shadowAtlasResolutions.clear();
+
+  // Shadow cube maps of point lights (assigned once all the lights are gathered)
+  static std::vector<ShadowCubeMapRequest> sShadowCubeMapRequests{};
+  static std::vector<GLsizei>              sShadowCubeMapResolutions{};
+  std::vector<ShadowCubeMapRequest>       &shadowCubeMapRequests    = sShadowCubeMapRequests;
+  std::vector<GLsizei>                    &shadowCubeMapResolutions = sShadowCubeMapResolutions;
+  shadowCubeMapRequests.clear();
+  shadowCubeMapResolutions.clear();
+
+  // Getting camera frustum corners and depth range to split it into shadow cascades
+  const std::array<glm::vec3, 8> frustumCorners{calculateFrustumCorners(camera)};
+  const float nearPlane = glm::dot(frustumCorners[0] - camera.getPosition(), camera.getForward());
+  const float farPlane  = glm::dot(frustumCorners[4] - camera.getPosition(), camera.getForward());
+
+  // Marking entities of given scene objects (typed light arrays span the whole scene)
+  static std::vector<bool> sIsEntityMarked{};
+  Scene *scenePtr = markSceneObjectEntities(sceneObjects, sIsEntityMarked);
+
+  // If there are scene objects
+  if (scenePtr != nullptr) {
+    Scene &scene = *scenePtr;
+
+    // For each spot light of given scene objects
+    const std::vector<SceneComponent<SpotLight>> &spotLights = scene.getSpotLights();
+    for (size_t i = 0; i < spotLights.size(); ++i) {
+      if (!sIsEntityMarked[spotLights[i].entity]) continue;
+      const SceneObject &sceneObject  = *scene.getSceneObjectPtr(spotLights[i].entity);
+      const SpotLight   *spotLightPtr = spotLights[i].componentPtr;
+
+      // Skipping light if there is no room for it in shader storage buffer
+      if (sSpotLightBlocks.size() >= kMaxSpotLightCount) break;
+      const GLuint    index          = static_cast<GLuint>(sSpotLightBlocks.size());
+      SpotLightBlock &spotLightBlock = sSpotLightBlocks.emplace_back();
+
+      spotLightBlock.worldPos = glm::vec3{sceneObject.getModelMatrix()[3]};
+      spotLightBlock.range    = calculateLightRange(*spotLightPtr);
+      spotLightBlock.color    = spotLightPtr->getColor();
+      spotLightBlock.dir = calculateLightDirection(sceneObject, spotLightPtr->getDirection());
+      spotLightBlock.linAttCoef  = spotLightPtr->getLinAttCoef();
+      spotLightBlock.quadAttCoef = spotLightPtr->getQuadAttCoef();
+      spotLightBlock.angle       = spotLightPtr->getAngle();
+      spotLightBlock.smoothAngle = spotLightPtr->getSmoothAngle();
+
+      // Requesting shadow atlas tile sized by light importance if shader program is specified
+      if (spotLightShadowMapShaderProgram > 0) {
+        shadowAtlasRequests.push_back(
+            ShadowAtlasRequest{&sceneObject, spotLightPtr, nullptr, index});
+        shadowAtlasResolutions.push_back(
+            calculateShadowMapResolution(sceneObject, *spotLightPtr, camera));
       }
     }
 
-    // Enabling Z- and disabling stencil testing
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glDisable(GL_STENCIL_TEST);
-
-    // Getting original viewport
-    int viewport[4] = {0};
-    glGetIntegerv(GL_VIEWPORT, &viewport[0]);
-
-    // For each light component
-    for (size_t i = 0; i < lightPtrs.size(); ++i) {
-      const BaseLight *lightPtr = dynamic_cast<const BaseLight *>(lightPtrs[i].get());
-
-      const SpotLight        *spotLightPtr       = dynamic_cast<const SpotLight *>(lightPtr);
-      const DirectionalLight *direcionalLightPtr = dynamic_cast<const DirectionalLight *>(lightPtr);
-      const PointLight       *pointLightPtr      = dynamic_cast<const PointLight *>(lightPtr);
-
-      // If light is spot (must be before directional and point lights)
-      if (spotLightPtr != nullptr) {
-        // Adding light and scene object to appropriate vectors
-        spotLightPtrs.push_back(spotLightPtr);
-        spotLightSceneObjectPtrs.push_back(&sceneObject);
-
-        // Rendering shadow map if shader program is specified
-        if (spotLightShadowMapShaderProgram > 0) {
-          renderSpotLightShadowMap(sceneObjects, spotLightVPMatrices, sceneObject, spotLightPtr,
-                                   spotLightShadowMapShaderProgram);
+    // For each directional light of given scene objects
+    const std::vector<SceneComponent<DirectionalLight>> &directionalLights =
+        scene.getDirectionalLights();
+    for (size_t i = 0; i < directionalLights.size(); ++i) {
+      if (!sIsEntityMarked[directionalLights[i].entity]) continue;
+      const SceneObject &sceneObject = *scene.getSceneObjectPtr(directionalLights[i].entity);
+      const DirectionalLight *direcionalLightPtr = directionalLights[i].componentPtr;
+
+      // Skipping light if there is no room for it in uniform block
+      if (lightsBlock.directionalLightCount >= kMaxDirectionalLightCount) break;
+      const GLuint           index                 = lightsBlock.directionalLightCount++;
+      DirectionalLightBlock &directionalLightBlock = lightsBlock.directionalLights[index];
+
+      directionalLightBlock.color = direcionalLightPtr->getColor();
+      directionalLightBlock.dir =
+          calculateLightDirection(sceneObject, direcionalLightPtr->getDirection());
+
+      // Requesting shadow atlas tile for each cascade if shader program is specified
+      // (directional lights cover the whole view, so they always get the requested resolution)
+      if (directionalLightShadowMapShaderProgram > 0) {
+        directionalLightBlock.cascadeCount = direcionalLightPtr->getCascadeCount();
+        for (unsigned int c = 0; c < directionalLightBlock.cascadeCount; ++c) {
+          directionalLightBlock.cascadeSplits[c] = calculateCascadeSplit(
+              nearPlane, farPlane, c + 1, directionalLightBlock.cascadeCount);
+
+          shadowAtlasRequests.push_back(
+              ShadowAtlasRequest{&sceneObject, nullptr, direcionalLightPtr, index, c});
+          shadowAtlasResolutions.push_back(direcionalLightPtr->getShadowMapTextureResolution());
         }
       }
+    }
 
-      // If light is directional
-      else if (direcionalLightPtr != nullptr) {
-        // Adding light and scene object to appropriate vectors
-        directionalLightPtrs.push_back(direcionalLightPtr);
-        directionalLightSceneObjectPtrs.push_back(&sceneObject);
-
-        // Rendering shadow map if shader program is specified
-        if (directionalLightShadowMapShaderProgram > 0) {
-          renderDirectionalLightShadowMap(sceneObjects, directionalLightVPMatrices, sceneObject,
-                                          direcionalLightPtr,
-                                          directionalLightShadowMapShaderProgram, camera);
+    // For each point light of given scene objects
+    const std::vector<SceneComponent<PointLight>> &pointLights = scene.getPointLights();
+    for (size_t i = 0; i < pointLights.size(); ++i) {
+      if (!sIsEntityMarked[pointLights[i].entity]) continue;
+      const SceneObject &sceneObject   = *scene.getSceneObjectPtr(pointLights[i].entity);
+      const PointLight  *pointLightPtr = pointLights[i].componentPtr;
+
+      // Skipping light if there is no room for it in shader storage buffer
+      if (sPointLightBlocks.size() >= kMaxPointLightCount) break;
+      const GLuint     index           = static_cast<GLuint>(sPointLightBlocks.size());
+      PointLightBlock &pointLightBlock = sPointLightBlocks.emplace_back();
+
+      pointLightBlock.worldPos    = glm::vec3{sceneObject.getModelMatrix()[3]};
+      pointLightBlock.range       = calculateLightRange(*pointLightPtr);
+      pointLightBlock.color       = pointLightPtr->getColor();
+      pointLightBlock.linAttCoef  = pointLightPtr->getLinAttCoef();
+      pointLightBlock.quadAttCoef = pointLightPtr->getQuadAttCoef();
+
+      // Requesting cube map sized by light importance if shader program is specified
+      if (pointLightShadowMapShaderProgram > 0) {
+        shadowCubeMapRequests.push_back(ShadowCubeMapRequest{&sceneObject, pointLightPtr, index});
+        shadowCubeMapResolutions.push_back(
+            calculateShadowMapResolution(sceneObject, *pointLightPtr, camera));
+      }
+    }
+  }
+
+  // Unbinding shadow map textures (lights without cube map are not shadowed)
+  for (GLuint i = 0; i < kMaxShadowedPointLightCount; ++i) {
+    glActiveTexture(GL_TEXTURE0 + kPointLightShadowMapTextureUnit + i);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+  }
+
+  // Keeping requests of the most important lights only if there are more than shadow map
+  // samplers (requests stay in order of lights)
+  if (shadowCubeMapRequests.size() > kMaxShadowedPointLightCount) {
+    static std::vector<size_t> sRequestOrder{};
+    std::vector<size_t>       &requestOrder = sRequestOrder;
+    requestOrder.resize(shadowCubeMapRequests.size());
+    std::iota(requestOrder.begin(), requestOrder.end(), 0);
+    std::sort(requestOrder.begin(), requestOrder.end(),
+              [&shadowCubeMapResolutions](size_t a, size_t b) {
+                return shadowCubeMapResolutions[a] != shadowCubeMapResolutions[b]
+                           ? shadowCubeMapResolutions[a] > shadowCubeMapResolutions[b]
+                           : a < b;
+              });
+    requestOrder.resize(kMaxShadowedPointLightCount);
+    std::sort(requestOrder.begin(), requestOrder.end());
+
+    // Moving important requests to the front in place (each one moves towards the front,
+    // so none is overwritten before it is moved)
+    for (size_t i = 0; i < requestOrder.size(); ++i) {
+      shadowCubeMapRequests[i]    = shadowCubeMapRequests[requestOrder[i]];
+      shadowCubeMapResolutions[i] = shadowCubeMapResolutions[requestOrder[i]];
+    }
+    shadowCubeMapRequests.resize(requestOrder.size());
+    shadowCubeMapResolutions.resize(requestOrder.size());
+  }
+
+  // If any light requested shadow cube map
+  if (!shadowCubeMapRequests.empty()) {
+    // Creating shadow cube map pool on the first use (demos without point light shadows never
+    // allocate it, cube maps are never allocated again until budget changes)
+    std::unique_ptr<ShadowCubeMapPool> &shadowCubeMapPoolPtr = getShadowCubeMapPoolPtr();
+    if (shadowCubeMapPoolPtr == nullptr) {
+      shadowCubeMapPoolPtr = std::make_unique<ShadowCubeMapPool>(
+          getMutableShadowCubeMapPoolBudget(), kMaxShadowedPointLightCount);
+    }
+    if (shadowMapFilterShaderProgram > 0) shadowCubeMapPoolPtr->createMomentsTextures();
+
+    // Assigning cube maps to all the lights at once (the most important lights get the largest)
+    const std::vector<size_t> &cubeMapIndices =
+        shadowCubeMapPoolPtr->assign(shadowCubeMapResolutions);
+
+    // For each shadow cube map request
+    for (size_t i = 0; i < shadowCubeMapRequests.size(); ++i) {
+      const ShadowCubeMapRequest &request = shadowCubeMapRequests[i];
+
+      // If light got no cube map (its far plane stays zero, so it is not shadowed)
+      if (cubeMapIndices[i] == ShadowCubeMapPool::kNoCubeMap) continue;
+      ShadowCubeMap &cubeMap = shadowCubeMapPoolPtr->getCubeMap(cubeMapIndices[i]);
+
+      // Rendering shadow map
+      ShadowCacheEntry &shadowCacheEntry =
+          shadowCache[ShadowCacheKey{request.pointLightPtr, 0}];
+      shadowCacheEntry.frame = sFrame;
+      shadowCasterStats.push_back(ShadowCasterStats{request.pointLightPtr});
+      sPointLightBlocks[request.index].farPlane = renderPointLightShadowMap(
+          sceneObjects, *request.sceneObjectPtr, request.pointLightPtr,
+          pointLightShadowMapShaderProgram, staticTransformGeneration, cubeMapIndices[i], cubeMap,
+          shadowCacheEntry, shadowCasterStats.back());
+
+      // If shadow maps are filtered
+      GLuint shadowMapTexture = cubeMap.texture.get();
+      if (shadowMapFilterShaderProgram > 0) {
+        // Filtering each face of depth cube map into moments cube map if depth changed
+        const GLsizei momentsResolution = cubeMap.resolution / ShadowAtlas::kMomentsDownsampling;
+        if (shadowCacheEntry.isDepthUpdated) {
+          const GLuint blurTexture = getShadowFilterBlurTexture(momentsResolution);
+          for (GLint face = 0; face < 6; ++face) {
+            filterShadowMap(shadowMapFilterShaderProgram, cubeMap.texture.get(), face,
+                            cubeMap.momentsTexture.get(), blurTexture,
+                            glm::ivec4{0, 0, momentsResolution, momentsResolution});
+          }
         }
+
+        // Using moments cube map instead of depth one
+        shadowMapTexture = cubeMap.momentsTexture.get();
       }
 
-      // If light is point
-      else if (pointLightPtr != nullptr) {
-        // Adding light and scene object to appropriate vectors
-        pointLightPtrs.push_back(pointLightPtr);
-        pointLightSceneObjectPtrs.push_back(&sceneObject);
+      // Moving light in front of lights without shadow map (shadowed lights are iterated
+      // apart from clusters, since samplers must be indexed by dynamically uniform expressions;
+      // lights swapped back are not shadowed, because requests are in order of lights)
+      const GLuint shadowedIndex = lightsBlock.shadowedPointLightCount++;
+      std::swap(sPointLightBlocks[shadowedIndex], sPointLightBlocks[request.index]);
+
+      // Binding shadow map texture
+      glActiveTexture(GL_TEXTURE0 + kPointLightShadowMapTextureUnit + shadowedIndex);
+      glBindTexture(GL_TEXTURE_CUBE_MAP, shadowMapTexture);
+    }
+  }
+
+  // If any light requested shadow atlas tile
+  if (!shadowAtlasRequests.empty()) {
+    // Creating shadow atlas on the first use (demos without shadows never allocate it)
+    std::unique_ptr<ShadowAtlas> &shadowAtlasPtr = getShadowAtlasPtr();
+    if (shadowAtlasPtr == nullptr) shadowAtlasPtr = std::make_unique<ShadowAtlas>();
+    if (shadowMapFilterShaderProgram > 0) shadowAtlasPtr->createMomentsTexture();
+
+    // Packing tiles of all the lights at once (the most important lights get the largest tiles)
+    const std::vector<ShadowAtlasTile> &tiles = shadowAtlasPtr->pack(shadowAtlasResolutions);
+
+    // Atlas is not cleared as a whole since tiles of unchanged lights keep their depth,
+    // other tiles are cleared one by one
+    // For each shadow atlas request
+    for (size_t i = 0; i < shadowAtlasRequests.size(); ++i) {
+      const ShadowAtlasRequest &request = shadowAtlasRequests[i];
+
+      // If light got no tile (its tile rectangle stays zero, so it is not shadowed)
+      if (tiles[i].resolution == 0) continue;
+
+      // Getting shadow cache entry of light (and cascade)
+      const BaseLight *lightPtr =
+          request.spotLightPtr != nullptr
+              ? static_cast<const BaseLight *>(request.spotLightPtr)
+              : static_cast<const BaseLight *>(request.directionalLightPtr);
+      ShadowCacheEntry &shadowCacheEntry =
+          shadowCache[ShadowCacheKey{lightPtr, request.cascadeIndex}];
+      shadowCacheEntry.frame = sFrame;
+      shadowCasterStats.push_back(ShadowCasterStats{lightPtr, request.cascadeIndex});
+
+      // If light is spot
+      if (request.spotLightPtr != nullptr) {
+        // Casters must be within light range (sphere is tighter than frustum at its far corners)
+        const PerspectiveCamera shadowMapCamera{
+            calculateSpotLightShadowMapCamera(*request.sceneObjectPtr, request.spotLightPtr)};
+        const glm::vec4 lightSphere{shadowMapCamera.getPosition(), shadowMapCamera.getFarPlane()};
+
+        SpotLightBlock &spotLightBlock = sSpotLightBlocks[request.index];
+        spotLightBlock.VP = renderAtlasShadowMap(
+            sceneObjects, shadowMapCamera, lightSphere, glm::vec3{},
+            spotLightShadowMapShaderProgram, *shadowAtlasPtr, tiles[i], staticTransformGeneration,
+            shadowCacheEntry, shadowCasterStats.back());
+        spotLightBlock.atlasRect = shadowAtlasPtr->calculateTileRect(tiles[i]);
+      }
 
-        // Rendering shadow map if shader program is specified
-        if (pointLightShadowMapShaderProgram > 0) {
-          renderPointLightShadowMap(sceneObjects, pointLightFarPlanes, sceneObject, pointLightPtr,
-                                    pointLightShadowMapShaderProgram);
+      // If light is directional
+      else {
+        DirectionalLightBlock &directionalLightBlock =
+            lightsBlock.directionalLights[request.index];
+        const unsigned int c = request.cascadeIndex;
+
+        // Getting corners of camera frustum slice covered by cascade
+        const float cascadeNear = c > 0 ? directionalLightBlock.cascadeSplits[c - 1] : nearPlane;
+        const float cascadeFar  = directionalLightBlock.cascadeSplits[c];
+        std::array<glm::vec3, 8> cascadeCorners{};
+        for (size_t j = 0; j < 4; ++j) {
+          const glm::vec3 edge{frustumCorners[j + 4] - frustumCorners[j]};
+          cascadeCorners[j] =
+              frustumCorners[j] + edge * (cascadeNear - nearPlane) / (farPlane - nearPlane);
+          cascadeCorners[j + 4] =
+              frustumCorners[j] + edge * (cascadeFar - nearPlane) / (farPlane - nearPlane);
         }
+
+        // Casters outside of cascade must be able to cast shadow into it along light direction
+        const glm::vec4 cascadeSphere{calculateCascadeBoundingSphere(cascadeCorners)};
+
+        directionalLightBlock.VPs[c] = renderAtlasShadowMap(
+            sceneObjects,
+            calculateDirectionalLightShadowMapCamera(*request.sceneObjectPtr,
+                                                     request.directionalLightPtr, cascadeSphere,
+                                                     tiles[i].resolution),
+            cascadeSphere, glm::normalize(directionalLightBlock.dir),
+            directionalLightShadowMapShaderProgram, *shadowAtlasPtr, tiles[i],
+            staticTransformGeneration, shadowCacheEntry, shadowCasterStats.back());
+        directionalLightBlock.atlasRects[c] = shadowAtlasPtr->calculateTileRect(tiles[i]);
+      }
+
+      // Filtering depth of tile into moments atlas if shadow maps are filtered and depth changed
+      if (shadowMapFilterShaderProgram > 0 && shadowCacheEntry.isDepthUpdated) {
+        const GLint downsampling = ShadowAtlas::kMomentsDownsampling;
+        filterShadowMap(shadowMapFilterShaderProgram, shadowAtlasPtr->getTexture(), -1,
+                        shadowAtlasPtr->getMomentsTexture(),
+                        getShadowFilterBlurTexture(shadowAtlasPtr->getMomentsResolution()),
+                        glm::ivec4{tiles[i].x / downsampling, tiles[i].y / downsampling,
+                                   tiles[i].resolution / downsampling,
+                                   tiles[i].resolution / downsampling});
       }
     }
 
-    // Reverting viewport and Z-test changes
-    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
-    glDisable(GL_DEPTH_TEST);
+    // Unbinding shadow atlas framebuffer
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    // Binding shadow atlas texture (moments one if shadow maps are filtered)
+    glActiveTexture(GL_TEXTURE0 + kShadowAtlasTextureUnit);
+    glBindTexture(GL_TEXTURE_2D, shadowMapFilterShaderProgram > 0
+                                     ? shadowAtlasPtr->getMomentsTexture()
+                                     : shadowAtlasPtr->getTexture());
   }
 
-  // Updating shader programs uniform values
-  int currShadowMapTextureUnit = 7;
-  for (size_t i = 0; i < shaderPrograms.size(); ++i) {
-    const GLuint shaderProgram = shaderPrograms[i];
+  // Dropping cache entries of lights which were not rendered this frame (removed or unshadowed)
+  for (auto it = shadowCache.begin(); it != shadowCache.end();) {
+    it = it->second.frame != sFrame ? shadowCache.erase(it) : std::next(it);
+  }
 
-    // Ambient light
-    glUseProgram(shaderProgram);
-    glUniform3fv(glGetUniformLocation(shaderProgram, "AMBIENT_LIGHT_COLOR"), 1,
-                 glm::value_ptr(ambientColor));
+  // Reverting viewport and Z-test changes
+  glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+  glDisable(GL_DEPTH_TEST);
+
+  // Uploading lights data once for all shader programs
+  lightsBlock.pointLightCount = static_cast<GLuint>(sPointLightBlocks.size());
+  lightsBlock.spotLightCount  = static_cast<GLuint>(sSpotLightBlocks.size());
+  updateUniformBuffer(getLightsUniformBuffer(), &lightsBlock, sizeof(lightsBlock));
+  updateStorageBuffer(getPointLightsStorageBuffer(), sPointLightBlocks.data(),
+                      sizeof(PointLightBlock) * sPointLightBlocks.size());
+  updateStorageBuffer(getSpotLightsStorageBuffer(), sSpotLightBlocks.data(),
+                      sizeof(SpotLightBlock) * sSpotLightBlocks.size());
+
+  // Uploading light cluster grid data (clusters follow camera and viewport)
+  LightClusterDataBlock lightClusterDataBlock{};
+  lightClusterDataBlock.view        = camera.getViewMatrix();
+  lightClusterDataBlock.invProj     = glm::inverse(camera.getProjectionMatrix());
+  lightClusterDataBlock.gridSize    = kLightClusterGridSize;
+  lightClusterDataBlock.isClustered = static_cast<GLuint>(lightClusteringShaderProgram > 0);
+  lightClusterDataBlock.screenSize  = glm::vec2(viewport[2], viewport[3]);
+  lightClusterDataBlock.nearPlane   = nearPlane;
+  lightClusterDataBlock.farPlane    = farPlane;
+  updateUniformBuffer(getLightClusterDataUniformBuffer(), &lightClusterDataBlock,
+                      sizeof(lightClusterDataBlock));
+
+  // If lights are clustered
+  if (lightClusteringShaderProgram > 0) {
+    // Creating clusters and light indices buffers on the first use and resetting index count
+    getLightClustersStorageBuffer();
+    const GLuint lightIndexCount{};
+    updateStorageBuffer(getLightIndicesStorageBuffer(), &lightIndexCount,
+                        sizeof(lightIndexCount));
+
+    // Assigning lights to clusters by compute shader (invocation per cluster)
+    glUseProgram(lightClusteringShaderProgram);
+    glDispatchCompute(static_cast<GLuint>((kLightClusterCount + kLightClusterWorkGroupSize - 1) /
+                                          kLightClusterWorkGroupSize),
+                      1, 1);
     glUseProgram(0);
 
-    // Copying light VP matrices vectors
-    std::vector<glm::mat4> spotLightVPMatricesCopy{spotLightVPMatrices.crbegin(),
-                                                   spotLightVPMatrices.crend()};
-    std::vector<glm::mat4> directionalLightVPMatricesCopy{directionalLightVPMatrices.crbegin(),
-                                                          directionalLightVPMatrices.crend()};
-    std::vector<float>     pointLightFarPlanesCopy{pointLightFarPlanes.crbegin(),
-                                               pointLightFarPlanes.crend()};
+    // Making sure clusters are written before fragment shaders read them
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+  }
+}
 
-    // Spot lights
-    updateShaderProgramSpotLights(shaderProgram, spotLightPtrs, spotLightSceneObjectPtrs,
-                                  spotLightShadowMapShaderProgram, currShadowMapTextureUnit,
-                                  spotLightVPMatricesCopy);
+void SceneObject::updateShadersCamera(const BaseCamera &camera) noexcept {
+  // Uploading camera data once for all shader programs
+  FrameDataBlock frameDataBlock{};
+  frameDataBlock.view        = camera.getViewMatrix();
+  frameDataBlock.proj        = camera.getProjectionMatrix();
+  frameDataBlock.viewPos     = camera.getPosition();
+  frameDataBlock.invViewProj = glm::inverse(frameDataBlock.proj * frameDataBlock.view);
+  updateUniformBuffer(getFrameDataUniformBuffer(), &frameDataBlock, sizeof(frameDataBlock));
+}
 
-    // Directional lights
-    updateShaderProgramDirectionalLights(shaderProgram, directionalLightPtrs,
-                                         directionalLightSceneObjectPtrs,
-                                         directionalLightShadowMapShaderProgram,
-                                         currShadowMapTextureUnit, directionalLightVPMatricesCopy);
+// Gets frustum culling statistics gathered since the last reset
+const CullingStats &SceneObject::getCullingStats() noexcept { return getMutableCullingStats(); }
 
-    // Point lights
-    updateShaderProgramPointLights(shaderProgram, pointLightPtrs, pointLightSceneObjectPtrs,
-                                   pointLightShadowMapShaderProgram, currShadowMapTextureUnit,
-                                   pointLightFarPlanesCopy);
-  }
+// Resets frustum culling statistics (must be called once per frame)
+void SceneObject::resetCullingStats() noexcept { getMutableCullingStats() = CullingStats{}; }
+
+// Adds frustum culling statistics counted separately (render queues may add them from
+// different threads at once)
+void SceneObject::addCullingStats(const CullingStats &cullingStats) noexcept {
+  static std::mutex sCullingStatsMutex{};
+  std::lock_guard   lock{sCullingStatsMutex};
+
+  getMutableCullingStats().visibleMeshCount += cullingStats.visibleMeshCount;
+  getMutableCullingStats().culledMeshCount  += cullingStats.culledMeshCount;
 }
 
-void SceneObject::updateShadersCamera(const std::vector<SceneObject> &sceneObjects,
-                                      const BaseCamera               &camera) noexcept {
-  // Getting camera view and projection matrices
-  const glm::mat4 viewMatrix{camera.getViewMatrix()};
-  const glm::mat4 projMatrix{camera.getProjectionMatrix()};
-  const glm::vec3 position{camera.getPosition()};
+// Gets shadow atlas statistics of the last packing
+const ShadowAtlasStats &SceneObject::getShadowAtlasStats() noexcept {
+  static const ShadowAtlasStats kEmptyShadowAtlasStats{};
+
+  const std::unique_ptr<ShadowAtlas> &shadowAtlasPtr = getShadowAtlasPtr();
+  return shadowAtlasPtr != nullptr ? shadowAtlasPtr->getStats() : kEmptyShadowAtlasStats;
+}
 
+// Gets shadow cube map pool statistics of the last assignment
+const ShadowCubeMapPoolStats &SceneObject::getShadowCubeMapPoolStats() noexcept {
+  static const ShadowCubeMapPoolStats kEmptyShadowCubeMapPoolStats{};
+
+  const std::unique_ptr<ShadowCubeMapPool> &shadowCubeMapPoolPtr = getShadowCubeMapPoolPtr();
+  return shadowCubeMapPoolPtr != nullptr ? shadowCubeMapPoolPtr->getStats()
+                                         : kEmptyShadowCubeMapPoolStats;
+}
+
+// Sets video memory budget of shadow cube map pool in bytes (pool is allocated again
+// by the next updateShadersLights call, never in the middle of the frame)
+void SceneObject::setShadowCubeMapPoolBudget(size_t budget) noexcept {
+  // If budget did not change
+  if (budget == getMutableShadowCubeMapPoolBudget()) return;
+
+  getMutableShadowCubeMapPoolBudget() = budget;
+  getShadowCubeMapPoolPtr().reset();
+}
+
+// Gets statistics of shadow cache of the last updateShadersLights call
+const ShadowCacheStats &SceneObject::getShadowCacheStats() noexcept {
+  return getMutableShadowCacheStats();
+}
+
+// Gets shadow caster culling statistics of the last updateShadersLights call
+// (one per rendered shadow map, reused ones included)
+const std::vector<ShadowCasterStats> &SceneObject::getShadowCasterStats() noexcept {
+  return getMutableShadowCasterStats();
+}
+
+// Renders depth of scene objects meshes with the given shader program only
+// (no shader program changes of meshes, no material binds and no component lists;
+// only scene objects with transform generation in [first, last) range are rendered)
+void SceneObject::renderDepthOnly(const std::vector<SceneObject> &sceneObjects,
+                                  GLuint depthShaderProgram, const FrustumPlanes &frustumPlanes,
+                                  size_t firstTransformGeneration,
+                                  size_t lastTransformGeneration) noexcept {
+  // Binding depth shader program once for all the meshes
+  glUseProgram(depthShaderProgram);
+  const GLint modelLocation     = getUniformLocation(depthShaderProgram, kModelUniform);
+  const GLint instancedLocation = getUniformLocation(depthShaderProgram, kInstancedUniform);
+
+  GLuint currentVAO{};
   // For each scene object
   for (size_t i = 0; i < sceneObjects.size(); ++i) {
-    std::vector<std::shared_ptr<const Component>> meshPtrs{
-        sceneObjects[i].getSpecificComponentPtrs(ComponentType::Mesh)};
+    renderSceneObjectDepthOnly(sceneObjects[i], frustumPlanes, firstTransformGeneration,
+                               lastTransformGeneration, modelLocation, instancedLocation,
+                               currentVAO);
+  }
 
-    // For each mesh component
-    for (size_t i = 0; i < meshPtrs.size(); ++i) {
-      const Mesh &mesh = *dynamic_cast<const Mesh *>(meshPtrs[i].get());
+  // Unbinding shader program and VAO
+  glUseProgram(0);
+  glBindVertexArray(0);
+}
 
-      // If mesh is complete
-      if (mesh.isComplete()) {
-        // Updating object shader program uniform values
-        const GLuint shaderProgram = mesh.getShaderProgram();
+// Renders depth of the given scene objects only (shadow casters already culled by light volume)
+void SceneObject::renderDepthOnly(const std::vector<const SceneObject *> &sceneObjectPtrs,
+                                  GLuint depthShaderProgram, const FrustumPlanes &frustumPlanes,
+                                  size_t firstTransformGeneration,
+                                  size_t lastTransformGeneration) noexcept {
+  // Binding depth shader program once for all the meshes
+  glUseProgram(depthShaderProgram);
+  const GLint modelLocation     = getUniformLocation(depthShaderProgram, kModelUniform);
+  const GLint instancedLocation = getUniformLocation(depthShaderProgram, kInstancedUniform);
+
+  GLuint currentVAO{};
+  // For each scene object
+  for (size_t i = 0; i < sceneObjectPtrs.size(); ++i) {
+    renderSceneObjectDepthOnly(*sceneObjectPtrs[i], frustumPlanes, firstTransformGeneration,
+                               lastTransformGeneration, modelLocation, instancedLocation,
+                               currentVAO);
+  }
 
-        glUseProgram(shaderProgram);
+  // Unbinding shader program and VAO
+  glUseProgram(0);
+  glBindVertexArray(0);
+}
 
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "VIEW"), 1, GL_FALSE,
-                           glm::value_ptr(viewMatrix));
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "PROJ"), 1, GL_FALSE,
-                           glm::value_ptr(projMatrix));
-        glUniform3fv(glGetUniformLocation(shaderProgram, "VIEW_POS"), 1, glm::value_ptr(position));
+// Local function definitions
 
-        glUseProgram(0);
-      }
+GLuint getFrameDataUniformBuffer() {
+  static GLuint sFrameDataUniformBuffer{
+      createUniformBuffer(kFrameDataUniformBufferBinding, sizeof(FrameDataBlock))};
+  return sFrameDataUniformBuffer;
+}
+
+GLuint getLightsUniformBuffer() {
+  static GLuint sLightsUniformBuffer{
+      createUniformBuffer(kLightsUniformBufferBinding, sizeof(LightsBlock))};
+  return sLightsUniformBuffer;
+}
+
+GLuint getLightClusterDataUniformBuffer() {
+  static GLuint sLightClusterDataUniformBuffer{createUniformBuffer(
+      kLightClusterDataUniformBufferBinding, sizeof(LightClusterDataBlock))};
+  return sLightClusterDataUniformBuffer;
+}
+
+GLuint getPointLightsStorageBuffer() {
+  static GLuint sPointLightsStorageBuffer{createStorageBuffer(
+      kPointLightsStorageBufferBinding, sizeof(PointLightBlock) * kMaxPointLightCount)};
+  return sPointLightsStorageBuffer;
+}
+
+GLuint getSpotLightsStorageBuffer() {
+  static GLuint sSpotLightsStorageBuffer{createStorageBuffer(
+      kSpotLightsStorageBufferBinding, sizeof(SpotLightBlock) * kMaxSpotLightCount)};
+  return sSpotLightsStorageBuffer;
+}
+
+GLuint getLightClustersStorageBuffer() {
+  static GLuint sLightClustersStorageBuffer{createStorageBuffer(
+      kLightClustersStorageBufferBinding, sizeof(LightClusterBlock) * kLightClusterCount)};
+  return sLightClustersStorageBuffer;
+}
+
+GLuint getLightIndicesStorageBuffer() {
+  // Light index count followed by light indices of all the clusters
+  static GLuint sLightIndicesStorageBuffer{createStorageBuffer(
+      kLightIndicesStorageBufferBinding, sizeof(GLuint) * (1 + kMaxLightIndexCount))};
+  return sLightIndicesStorageBuffer;
+}
+
+CullingStats &getMutableCullingStats() {
+  static CullingStats sCullingStats{};
+  return sCullingStats;
+}
+
+ShadowCacheStats &getMutableShadowCacheStats() {
+  static ShadowCacheStats sShadowCacheStats{};
+  return sShadowCacheStats;
+}
+
+std::vector<ShadowCasterStats> &getMutableShadowCasterStats() {
+  static std::vector<ShadowCasterStats> sShadowCasterStats{};
+  return sShadowCasterStats;
+}
+
+std::vector<const SceneObject *> &getShadowCasterPtrs() {
+  // Shadow casters of the shadow map being rendered (reused, so it is not allocated every time)
+  static std::vector<const SceneObject *> sShadowCasterPtrs{};
+  return sShadowCasterPtrs;
+}
+
+std::unique_ptr<ShadowAtlas> &getShadowAtlasPtr() {
+  static std::unique_ptr<ShadowAtlas> sShadowAtlasPtr{};
+  return sShadowAtlasPtr;
+}
+
+std::unique_ptr<ShadowCubeMapPool> &getShadowCubeMapPoolPtr() {
+  static std::unique_ptr<ShadowCubeMapPool> sShadowCubeMapPoolPtr{};
+  return sShadowCubeMapPoolPtr;
+}
+
+size_t &getMutableShadowCubeMapPoolBudget() {
+  static size_t sShadowCubeMapPoolBudget{ShadowCubeMapPool::kDefaultBudget};
+  return sShadowCubeMapPoolBudget;
+}
+
+std::map<ShadowCacheKey, ShadowCacheEntry> &getShadowCache() {
+  static std::map<ShadowCacheKey, ShadowCacheEntry> sShadowCache{};
+  return sShadowCache;
+}
+
+glm::vec4 calculateMeshBoundingSphere(const SceneObject &sceneObject, const Mesh &mesh) {
+  // Transforming bounding sphere to world space (radius is scaled by the largest axis scale)
+  const glm::mat4 &modelMatrix = sceneObject.getModelMatrix();
+  const glm::vec3  center{modelMatrix * glm::vec4{mesh.getBoundingSphereCenter(), 1.0f}};
+  const float      maxScale = std::max({glm::length(glm::vec3{modelMatrix[0]}),
+                                        glm::length(glm::vec3{modelMatrix[1]}),
+                                        glm::length(glm::vec3{modelMatrix[2]})});
+
+  return glm::vec4{center, mesh.getBoundingSphereRadius() * maxScale};
+}
+
+bool isMeshInFrustum(const SceneObject &sceneObject, const Mesh &mesh,
+                     const FrustumPlanes &frustumPlanes) {
+  // Meshes without bounding volume and instanced meshes (instances are placed by shader)
+  // are always considered inside of frustum
+  if (!mesh.hasBoundingVolume() || mesh.getInstanceCount() > 1) return true;
+
+  const glm::vec4 sphere{calculateMeshBoundingSphere(sceneObject, mesh)};
+  return BaseCamera::isSphereInFrustum(frustumPlanes, glm::vec3{sphere}, sphere.w);
+}
+
+bool isMeshInShadowCasterVolume(const SceneObject &sceneObject, const Mesh &mesh,
+                                const ShadowCasterVolume &casterVolume) {
+  // Meshes without bounding volume and instanced meshes (instances are placed by shader)
+  // always cast shadow
+  if (!mesh.hasBoundingVolume() || mesh.getInstanceCount() > 1) return true;
+
+  // If bounding sphere is outside of light frustum
+  const glm::vec4 sphere{calculateMeshBoundingSphere(sceneObject, mesh)};
+  const glm::vec3 center{sphere};
+  if (!BaseCamera::isSphereInFrustum(casterVolume.frustumPlanes, center, sphere.w)) return false;
+
+  // Getting point of swept bounding sphere axis (segment from its center to infinity along
+  // sweep direction) closest to volume bounding sphere center (center itself if not swept)
+  const glm::vec3 volumeCenter{casterVolume.boundingSphere};
+  const float     sweepDistance =
+      std::max(glm::dot(volumeCenter - center, casterVolume.sweepDirection), 0.0f);
+  const glm::vec3 closestPoint{center + casterVolume.sweepDirection * sweepDistance};
+
+  // Mesh casts shadow if swept bounding sphere intersects volume bounding sphere
+  const float radiusSum = sphere.w + casterVolume.boundingSphere.w;
+  return glm::dot(volumeCenter - closestPoint, volumeCenter - closestPoint) <=
+         radiusSum * radiusSum;
+}
+
+void renderSceneObjectDepthOnly(const SceneObject &sceneObject, const FrustumPlanes &frustumPlanes,
+                                size_t firstTransformGeneration, size_t lastTransformGeneration,
+                                GLint modelLocation, GLint instancedLocation, GLuint &currentVAO) {
+  // If scene object transform generation is out of range
+  if (sceneObject.getTransformGeneration() < firstTransformGeneration ||
+      sceneObject.getTransformGeneration() >= lastTransformGeneration) {
+    return;
+  }
+
+  bool isModelUpdated = false;
+
+  // Culling statistics of depth-only passes (not added to frustum culling statistics, which
+  // are the ones of camera, since shadow casters are counted by shadow caster statistics)
+  CullingStats depthCullingStats{};
+
+  // For each mesh component
+  for (const SceneComponent<Mesh> &meshComponent : sceneObject.getComponents<Mesh>()) {
+    const Mesh &mesh = *meshComponent.componentPtr;
+
+    // If mesh is not complete, is tessellated (depth shader programs have no tessellation
+    // stages) or is outside of frustum
+    if (!mesh.isComplete() || mesh.getPatchVertices() > 0 ||
+        !sceneObject.isMeshVisible(mesh, frustumPlanes, depthCullingStats)) {
+      continue;
     }
+
+    // If VAO changed (depth shader programs read vertex positions only)
+    if (mesh.getVAO() != currentVAO) {
+      glBindVertexArray(mesh.getVAO());
+      currentVAO = mesh.getVAO();
+    }
+
+    // Updating model matrix once per scene object
+    if (!isModelUpdated) {
+      glUniformMatrix4fv(modelLocation, 1, GL_FALSE, glm::value_ptr(sceneObject.getModelMatrix()));
+      isModelUpdated = true;
+    }
+    glUniform1i(instancedLocation, static_cast<int>(mesh.getInstanceCount() > 1));
+
+    // Drawing mesh
+    mesh.draw();
   }
 }
 
-// Local function definitions
+Scene *markSceneObjectEntities(const std::vector<SceneObject> &sceneObjects,
+                               std::vector<bool>              &isEntityMarked) {
+  // If there are no scene objects
+  if (sceneObjects.empty()) return nullptr;
 
-void renderSpotLightShadowMap(const std::vector<SceneObject> &sceneObjects,
-                              std::vector<glm::mat4>         &spotLightVPMatrices,
-                              const SceneObject              &spotLightSceneObject,
-                              const SpotLight                *spotLightPtr,
-                              GLuint                          spotLightShadowMapShaderProgram) {
-  // Setting shadow map viewport
-  glViewport(0, 0, spotLightPtr->getShadowMapTextureResolution(),
-             spotLightPtr->getShadowMapTextureResolution());
+  // Marking entities of scene objects of scene the first one belongs to (marks are reused,
+  // so they are not allocated every time)
+  Scene *scenePtr = sceneObjects[0].getScenePtr();
+  isEntityMarked.assign(scenePtr->getEntityCount(), false);
+  for (size_t i = 0; i < sceneObjects.size(); ++i) {
+    if (sceneObjects[i].getScenePtr() != scenePtr) continue;
+    isEntityMarked[sceneObjects[i].getEntity()] = true;
+  }
 
-  // Binding and clearing shadow map framebuffer
-  glBindFramebuffer(GL_FRAMEBUFFER, spotLightPtr->getShadowMapFBO());
-  glClear(GL_DEPTH_BUFFER_BIT);
+  return scenePtr;
+}
+
+uint64_t gatherShadowCasters(const std::vector<SceneObject> &sceneObjects,
+                             const ShadowCasterVolume       &casterVolume,
+                             size_t                          staticTransformGeneration,
+                             std::vector<const SceneObject *> &casterPtrs,
+                             bool &hasDynamicCasters, ShadowCasterStats &casterStats) {
+  // FNV-1a hash of transform generations of static casters (they are unique, so hash changes
+  // whenever any static caster moves, enters or leaves light volume)
+  uint64_t staticCasterHash{0xcbf29ce484222325};
+  hasDynamicCasters = false;
+  casterPtrs.clear();
+
+  // Marking entities of given scene objects (typed mesh array spans the whole scene)
+  static std::vector<bool> sIsEntityMarked{};
+  Scene *scenePtr = markSceneObjectEntities(sceneObjects, sIsEntityMarked);
+  if (scenePtr == nullptr) return staticCasterHash;
+  const std::vector<SceneComponent<Mesh>> &meshes = scenePtr->getMeshes();
+
+  // For each entity owning meshes (meshes are in order of entities, so meshes of one entity
+  // follow each other)
+  for (size_t i = 0; i < meshes.size();) {
+    const size_t entity    = meshes[i].entity;
+    bool         hasMeshes = false;
+    bool         isCaster  = false;
+
+    // If entity is not one of given scene objects
+    if (!sIsEntityMarked[entity]) {
+      while (i < meshes.size() && meshes[i].entity == entity) ++i;
+      continue;
+    }
+    const SceneObject &sceneObject = *scenePtr->getSceneObjectPtr(entity);
+
+    // For each mesh of entity (the rest are skipped once scene object is known to cast shadow)
+    for (; i < meshes.size() && meshes[i].entity == entity; ++i) {
+      const Mesh &mesh = *meshes[i].componentPtr;
+
+      // If mesh is not rendered into shadow maps or scene object is already known to cast shadow
+      if (isCaster || !mesh.isComplete() || mesh.getPatchVertices() > 0) continue;
+
+      hasMeshes = true;
+      isCaster  = isMeshInShadowCasterVolume(sceneObject, mesh, casterVolume);
+    }
 
+    // If scene object has no meshes rendered into shadow maps
+    if (!hasMeshes) continue;
+
+    // If scene object cannot cast shadow into shadow map
+    if (!isCaster) {
+      ++casterStats.culledCount;
+      continue;
+    }
+
+    ++casterStats.casterCount;
+    casterPtrs.push_back(&sceneObject);
+
+    // If scene object is static caster
+    if (sceneObject.getTransformGeneration() < staticTransformGeneration) {
+      staticCasterHash ^= static_cast<uint64_t>(sceneObject.getTransformGeneration());
+      staticCasterHash *= 0x100000001b3;
+    } else {
+      hasDynamicCasters = true;
+    }
+  }
+
+  return staticCasterHash;
+}
+
+float calculateLightRange(const PointLight &light) {
+  // Solving luminance / (1 + lin * d + quad * d^2) = kMinLightLuminance for distance d
+  // (light is unbounded if it is not attenuated, and has no range if it is too dim anyway)
+  const float linAttCoef  = light.getLinAttCoef();
+  const float quadAttCoef = light.getQuadAttCoef();
+  const float luminance   = std::abs(glm::dot(light.getColor(), kLuminanceWeights));
+  const float constTerm   = luminance / kMinLightLuminance - 1.0f;
+  if (constTerm <= 0.0f) return 0.0f;
+  if (quadAttCoef > 0.0f) {
+    return (-linAttCoef + std::sqrt(linAttCoef * linAttCoef + 4.0f * quadAttCoef * constTerm)) /
+           (2.0f * quadAttCoef);
+  }
+  return linAttCoef > 0.0f ? constTerm / linAttCoef : std::numeric_limits<float>::max();
+}
+
+GLsizei calculateShadowMapResolution(const SceneObject &lightSceneObject, const PointLight &light,
+                                     const BaseCamera &camera) {
+  // Projected size of light range sphere (fraction of viewport height, which is the whole
+  // viewport once camera gets into the sphere) falls off with distance, so does resolution
+  // of its shadow map (range is limited by shadow map far plane, beyond which nothing
+  // is shadowed anyway)
+  const glm::vec3 lightWorldPos{lightSceneObject.getModelMatrix()[3]};
+
+  const float range      = std::min(calculateLightRange(light), 2.0f * kShadowMapDistance);
+  const float distance   = glm::length(lightWorldPos - camera.getPosition());
+  const float screenSize = camera.getProjectionMatrix()[1][1] * range / std::max(distance, range);
+
+  return static_cast<GLsizei>(static_cast<float>(light.getShadowMapTextureResolution()) *
+                              std::min(screenSize, 1.0f));
+}
+
+void renderSceneObject(const SceneObject &sceneObject, float exposure,
+                       const FrustumPlanes *frustumPlanesPtr) {
+  // Using the first light component if scene object has at least one
+  const BaseLight *lightPtr = sceneObject.getComponentPtr<BaseLight>();
+
+  // For each mesh component
+  for (const SceneComponent<Mesh> &meshComponent : sceneObject.getComponents<Mesh>()) {
+    const Mesh &mesh = *meshComponent.componentPtr;
+
+    // If mesh is not complete
+    if (!mesh.isComplete()) continue;
+
+    // If mesh is outside of frustum
+    if (frustumPlanesPtr != nullptr && !sceneObject.isMeshVisible(mesh, *frustumPlanesPtr)) {
+      continue;
+    }
+
+    // Updating shader uniform variables
+    sceneObject.updateShaderModelMatrix(mesh);
+    if (lightPtr != nullptr) {
+      sceneObject.updateShaderLightColor(mesh, *lightPtr);
+    }
+    sceneObject.updateShaderExposure(mesh, exposure);
+
+    // Rendering mesh
+    mesh.render();
+  }
+}
+
+FrustumPlanes calculateRangeFrustumPlanes(const glm::vec3 &center, float range) {
+  // Axis-aligned cube around center (union of 6 cube map face frustums with far plane at range)
+  return FrustumPlanes{
+      glm::vec4{1.0f, 0.0f, 0.0f, range - center.x},
+      glm::vec4{-1.0f, 0.0f, 0.0f, range + center.x},
+      glm::vec4{0.0f, 1.0f, 0.0f, range - center.y},
+      glm::vec4{0.0f, -1.0f, 0.0f, range + center.y},
+      glm::vec4{0.0f, 0.0f, 1.0f, range - center.z},
+      glm::vec4{0.0f, 0.0f, -1.0f, range + center.z},
+  };
+}
+
+glm::vec3 calculateLightDirection(const SceneObject &lightSceneObject,
+                                  const glm::vec3   &direction) {
+  // Rotating direction by world matrix (so rotations of parents apply too), normalizing it
+  // back since the matrix may also scale
+  return glm::normalize(glm::mat3{lightSceneObject.getModelMatrix()} * direction);
+}
+
+PerspectiveCamera calculateSpotLightShadowMapCamera(const SceneObject &spotLightSceneObject,
+                                                    const SpotLight   *spotLightPtr) {
   // Configuring camera viewing from light position in light direction
   PerspectiveCamera shadowMapCamera{};
-  shadowMapCamera.setPosition(spotLightSceneObject.getTranslate());
+  shadowMapCamera.setPosition(glm::vec3{spotLightSceneObject.getModelMatrix()[3]});
   shadowMapCamera.setWorldUp(kUp);
-  shadowMapCamera.look(glm::vec3{
-      glm::eulerAngleXYZ(glm::radians(spotLightSceneObject.getRotate().x),
-                         glm::radians(spotLightSceneObject.getRotate().y),
-                         glm::radians(spotLightSceneObject.getRotate().z)) *
-      glm::vec4{spotLightPtr->getDirection(), 0.0f}
-  });
+  shadowMapCamera.look(calculateLightDirection(spotLightSceneObject, spotLightPtr->getDirection()));
   shadowMapCamera.setVerticalFOV(2.0f * spotLightPtr->getAngle());
   shadowMapCamera.setAspectRatio(1.0f);
   shadowMapCamera.setNearPlane(0.01f);
   shadowMapCamera.setFarPlane(2.0f * kShadowMapDistance);
 
-  // Pushing light VP matrix to vector
-  spotLightVPMatrices.push_back(shadowMapCamera.getProjectionMatrix() *
-                                shadowMapCamera.getViewMatrix());
+  return shadowMapCamera;
+}
 
-  // Temporary changing scene object shader programs
-  std::vector<GLuint> initShaderPrograms{};
-  // For each scene object
-  for (size_t i = 0; i < sceneObjects.size(); ++i) {
-    std::vector<std::shared_ptr<Component>> meshPtrs{
-        const_cast<std::vector<SceneObject> &>(sceneObjects)[i].getSpecificComponentPtrs(
-            ComponentType::Mesh)};
-
-    // For each mesh component
-    for (size_t i = 0; i < meshPtrs.size(); ++i) {
-      Mesh &mesh = *dynamic_cast<Mesh *>(meshPtrs[i].get());
-
-      // If mesh is complete
-      if (mesh.isComplete()) {
-        initShaderPrograms.push_back(mesh.getShaderProgram());
-        mesh.setShaderProgram(spotLightShadowMapShaderProgram);
-      }
-    }
+std::array<glm::vec3, 8> calculateFrustumCorners(const BaseCamera &camera) {
+  // Unprojecting NDC cube corners (near plane ones first, then far plane ones in the same order)
+  const glm::mat4 invViewProjMatrix{
+      glm::inverse(camera.getProjectionMatrix() * camera.getViewMatrix())};
+  std::array<glm::vec3, 8> frustumCorners{};
+  for (size_t i = 0; i < frustumCorners.size(); ++i) {
+    const glm::vec4 ndcCorner{(i & 1) != 0 ? 1.0f : -1.0f, (i & 2) != 0 ? 1.0f : -1.0f,
+                              i >= 4 ? 1.0f : -1.0f, 1.0f};
+    const glm::vec4 worldCorner{invViewProjMatrix * ndcCorner};
+    frustumCorners[i] = glm::vec3{worldCorner} / worldCorner.w;
   }
-  // Temporary updating shader camera
-  SceneObject::updateShadersCamera(sceneObjects, shadowMapCamera);
 
-  // Rendering scene object from camera point of view
-  // and reverting shader program changes for each scene object
-  std::vector<GLuint> initShaderProgramsReversed{initShaderPrograms.crbegin(),
-                                                 initShaderPrograms.crend()};
-  for (size_t i = 0; i < sceneObjects.size(); ++i) {
-    sceneObjects[i].render();
+  return frustumCorners;
+}
 
-    // Getting mesh component pointers
-    std::vector<std::shared_ptr<Component>> meshPtrs{
-        const_cast<std::vector<SceneObject> &>(sceneObjects)[i].getSpecificComponentPtrs(
-            ComponentType::Mesh)};
+float calculateCascadeSplit(float nearPlane, float farPlane, unsigned int splitIndex,
+                            unsigned int cascadeCount) {
+  // Practical split scheme (blend of logarithmic and uniform splits)
+  const float fraction = static_cast<float>(splitIndex) / static_cast<float>(cascadeCount);
+  const float logSplit = std::max(nearPlane, 1e-3f) *
+                         std::pow(farPlane / std::max(nearPlane, 1e-3f), fraction);
+  const float uniformSplit = nearPlane + (farPlane - nearPlane) * fraction;
 
-    // For each mesh component
-    for (size_t i = 0; i < meshPtrs.size(); ++i) {
-      Mesh &mesh = *dynamic_cast<Mesh *>(meshPtrs[i].get());
+  return kShadowCascadeSplitLambda * logSplit + (1.0f - kShadowCascadeSplitLambda) * uniformSplit;
+}
 
-      // If mesh is complete
-      if (mesh.isComplete()) {
-        mesh.setShaderProgram(initShaderProgramsReversed.back());
-        initShaderProgramsReversed.pop_back();
-      }
-    }
+glm::vec4 calculateCascadeBoundingSphere(const std::array<glm::vec3, 8> &cascadeCorners) {
+  // Getting bounding sphere of cascade (its size does not change with camera rotation,
+  // so texels keep their world size)
+  glm::vec3 center{};
+  for (size_t i = 0; i < cascadeCorners.size(); ++i) center += cascadeCorners[i];
+  center /= static_cast<float>(cascadeCorners.size());
+  float radius{};
+  for (size_t i = 0; i < cascadeCorners.size(); ++i) {
+    radius = std::max(radius, glm::length(cascadeCorners[i] - center));
   }
+  radius = std::ceil(radius * 16.0f) / 16.0f;
 
-  // Unbinding shadow map framebuffer
-  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  return glm::vec4{center, radius};
 }
 
-static void renderDirectionalLightShadowMap(const std::vector<SceneObject> &sceneObjects,
-                                            std::vector<glm::mat4> &directionalLightVPMatrices,
-                                            const SceneObject      &directionalLightSceneObject,
-                                            const DirectionalLight *directionalLightPtr,
-                                            GLuint directionalLightShadowMapShaderProgram,
-                                            const BaseCamera &camera) {
-  // Setting shadow map viewport
-  glViewport(0, 0, directionalLightPtr->getShadowMapTextureResolution(),
-             directionalLightPtr->getShadowMapTextureResolution());
-
-  // Binding and clearing shadow map framebuffer
-  glBindFramebuffer(GL_FRAMEBUFFER, directionalLightPtr->getShadowMapFBO());
-  glClear(GL_DEPTH_BUFFER_BIT);
+OrthographicCamera calculateDirectionalLightShadowMapCamera(
+    const SceneObject &directionalLightSceneObject, const DirectionalLight *directionalLightPtr,
+    const glm::vec4 &cascadeSphere, GLsizei tileResolution) {
+  const glm::vec3 center{cascadeSphere};
+  const float     radius = cascadeSphere.w;
 
-  // Configuring camera viewing from light position in light direction
+  // Configuring camera viewing from behind of cascade in light direction
+  // (shadow map distance is added so that casters outside of cascade still cast shadows)
   OrthographicCamera shadowMapCamera{};
-  glm::vec3          lightDir{
-      glm::eulerAngleXYZ(glm::radians(directionalLightSceneObject.getRotate().x),
-                                  glm::radians(directionalLightSceneObject.getRotate().y),
-                                  glm::radians(directionalLightSceneObject.getRotate().z)) *
-      glm::vec4{directionalLightPtr->getDirection(), 0.0f}
-  };
-  glm::vec3 cameraPos{
-      -glm::normalize(lightDir) * kShadowMapDistance + camera.getPosition() +
-      glm::normalize(camera.getForward() - lightDir * glm::dot(lightDir, camera.getForward())) *
-          kShadowMapDistance / 2.0f};
-  shadowMapCamera.setPosition(cameraPos);
+  const glm::vec3    lightDir{glm::normalize(
+      calculateLightDirection(directionalLightSceneObject, directionalLightPtr->getDirection()))};
+  shadowMapCamera.setPosition(center - lightDir * (radius + kShadowMapDistance));
   shadowMapCamera.setWorldUp(kUp);
   shadowMapCamera.look(lightDir);
-  shadowMapCamera.setLeftBorder(-kShadowMapDistance);
-  shadowMapCamera.setRightBorder(kShadowMapDistance);
-  shadowMapCamera.setBottomBorder(-kShadowMapDistance);
-  shadowMapCamera.setTopBorder(kShadowMapDistance);
+  shadowMapCamera.setLeftBorder(-radius);
+  shadowMapCamera.setRightBorder(radius);
+  shadowMapCamera.setBottomBorder(-radius);
+  shadowMapCamera.setTopBorder(radius);
   shadowMapCamera.setNearPlane(0.0f);
-  shadowMapCamera.setFarPlane(2.0f * kShadowMapDistance);
-
-  // Pushing light VP matrix to vector
-  directionalLightVPMatrices.push_back(shadowMapCamera.getProjectionMatrix() *
-                                       shadowMapCamera.getViewMatrix());
+  shadowMapCamera.setFarPlane(2.0f * radius + kShadowMapDistance);
+
+  // Snapping projection to texel grid so that shadow edges do not shimmer when camera moves
+  glm::mat4 projMatrix{shadowMapCamera.getProjectionMatrix()};
+  const float     halfTileResolution = static_cast<float>(tileResolution) / 2.0f;
+  const glm::vec4 originTexel{projMatrix * shadowMapCamera.getViewMatrix() *
+                              glm::vec4{0.0f, 0.0f, 0.0f, 1.0f} * halfTileResolution};
+  projMatrix[3][0] += (std::round(originTexel.x) - originTexel.x) / halfTileResolution;
+  projMatrix[3][1] += (std::round(originTexel.y) - originTexel.y) / halfTileResolution;
+  shadowMapCamera.setProjectionMatrix(projMatrix);
+
+  return shadowMapCamera;
+}
 
-  // Temporary changing scene object shader programs
-  std::vector<GLuint> initShaderPrograms{};
-  // For each scene object
-  for (size_t i = 0; i < sceneObjects.size(); ++i) {
-    std::vector<std::shared_ptr<Component>> meshPtrs{
-        const_cast<std::vector<SceneObject> &>(sceneObjects)[i].getSpecificComponentPtrs(
-            ComponentType::Mesh)};
-
-    // For each mesh component
-    for (size_t i = 0; i < meshPtrs.size(); ++i) {
-      Mesh &mesh = *dynamic_cast<Mesh *>(meshPtrs[i].get());
-
-      // If mesh is complete
-      if (mesh.isComplete()) {
-        initShaderPrograms.push_back(mesh.getShaderProgram());
-        mesh.setShaderProgram(directionalLightShadowMapShaderProgram);
-      }
-    }
+glm::mat4 renderAtlasShadowMap(const std::vector<SceneObject> &sceneObjects,
+                               const BaseCamera &shadowMapCamera,
+                               const glm::vec4  &casterBoundingSphere,
+                               const glm::vec3 &casterSweepDirection, GLuint shaderProgram,
+                               const ShadowAtlas &shadowAtlas, const ShadowAtlasTile &tile,
+                               size_t staticTransformGeneration, ShadowCacheEntry &entry,
+                               ShadowCasterStats &casterStats) {
+  ShadowCacheStats                 &shadowCacheStats = getMutableShadowCacheStats();
+  std::vector<const SceneObject *> &casterPtrs       = getShadowCasterPtrs();
+
+  const glm::mat4 lightVPMatrix{shadowMapCamera.getProjectionMatrix() *
+                                shadowMapCamera.getViewMatrix()};
+  const FrustumPlanes frustumPlanes{shadowMapCamera.calculateFrustumPlanes()};
+
+  // Gathering casters, checking if static depth of tile is still valid and if there are
+  // dynamic casters to draw
+  bool           hasDynamicCasters{};
+  const uint64_t staticCasterHash = gatherShadowCasters(
+      sceneObjects,
+      ShadowCasterVolume{frustumPlanes, casterBoundingSphere, casterSweepDirection},
+      staticTransformGeneration, casterPtrs, hasDynamicCasters, casterStats);
+  const bool isStaticDepthValid = entry.isValid && entry.lightVPMatrix == lightVPMatrix &&
+                                  entry.tile.x == tile.x && entry.tile.y == tile.y &&
+                                  entry.tile.resolution == tile.resolution &&
+                                  entry.staticCasterHash == staticCasterHash;
+
+  // If nothing changed and no dynamic casters were or are there, tile keeps the last depth
+  entry.isDepthUpdated = !isStaticDepthValid || hasDynamicCasters || entry.hasDynamicCasters;
+  if (!entry.isDepthUpdated) {
+    ++shadowCacheStats.reusedCount;
+    return lightVPMatrix;
   }
-  // Temporary updating shader camera
-  SceneObject::updateShadersCamera(sceneObjects, shadowMapCamera);
-
-  // Rendering scene object from camera point of view
-  // and reverting shader program changes for each scene object
-  std::vector<GLuint> initShaderProgramsReversed{initShaderPrograms.crbegin(),
-                                                 initShaderPrograms.crend()};
-  for (size_t i = 0; i < sceneObjects.size(); ++i) {
-    sceneObjects[i].render();
 
-    // Getting mesh component pointers
-    std::vector<std::shared_ptr<Component>> meshPtrs{
-        const_cast<std::vector<SceneObject> &>(sceneObjects)[i].getSpecificComponentPtrs(
-            ComponentType::Mesh)};
+  // Updating shader program uniform values
+  glUseProgram(shaderProgram);
+  glUniformMatrix4fv(getUniformLocation(shaderProgram, kLightVPUniform), 1, GL_FALSE,
+                     glm::value_ptr(lightVPMatrix));
+  glUseProgram(0);
 
-    // For each mesh component
-    for (size_t i = 0; i < meshPtrs.size(); ++i) {
-      Mesh &mesh = *dynamic_cast<Mesh *>(meshPtrs[i].get());
+  // Setting tile viewport
+  glViewport(tile.x, tile.y, tile.resolution, tile.resolution);
+
+  // If static depth is outdated
+  if (!isStaticDepthValid) {
+    // Clearing static atlas tile and rendering static casters depth into it
+    glBindFramebuffer(GL_FRAMEBUFFER, shadowAtlas.getStaticFBO());
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(tile.x, tile.y, tile.resolution, tile.resolution);
+    glClear(GL_DEPTH_BUFFER_BIT);
+    glDisable(GL_SCISSOR_TEST);
+    SceneObject::renderDepthOnly(casterPtrs, shaderProgram, frustumPlanes, 0,
+                                 staticTransformGeneration);
+    ++shadowCacheStats.staticRenderCount;
+
+    entry.lightVPMatrix    = lightVPMatrix;
+    entry.tile             = tile;
+    entry.staticCasterHash = staticCasterHash;
+    entry.isValid          = true;
+  }
 
-      // If mesh is complete
-      if (mesh.isComplete()) {
-        mesh.setShaderProgram(initShaderProgramsReversed.back());
-        initShaderProgramsReversed.pop_back();
-      }
-    }
+  // Copying static depth into atlas tile (which also erases dynamic casters of the last frame)
+  glCopyImageSubData(shadowAtlas.getStaticTexture(), GL_TEXTURE_2D, 0, tile.x, tile.y, 0,
+                     shadowAtlas.getTexture(), GL_TEXTURE_2D, 0, tile.x, tile.y, 0,
+                     tile.resolution, tile.resolution, 1);
+
+  // Drawing dynamic casters over static depth
+  if (hasDynamicCasters) {
+    glBindFramebuffer(GL_FRAMEBUFFER, shadowAtlas.getFBO());
+    SceneObject::renderDepthOnly(casterPtrs, shaderProgram, frustumPlanes,
+                                 staticTransformGeneration);
+    ++shadowCacheStats.dynamicRenderCount;
   }
+  entry.hasDynamicCasters = hasDynamicCasters;
 
-  // Unbinding shadow map framebuffer
+  // Unbinding framebuffer
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
 
-static void renderPointLightShadowMap(const std::vector<SceneObject> &sceneObjects,
-                                      std::vector<float>             &pointLightFarPlanes,
-                                      const SceneObject              &pointLightSceneObject,
-                                      const PointLight               *pointLightPtr,
-                                      GLuint pointLightShadowMapShaderProgram) {
-  // Setting shadow map viewport
-  glViewport(0, 0, pointLightPtr->getShadowMapTextureResolution(),
-             pointLightPtr->getShadowMapTextureResolution());
+  // Returning light VP matrix
+  return lightVPMatrix;
+}
 
-  // Binding and clearing shadow map framebuffer
-  glBindFramebuffer(GL_FRAMEBUFFER, pointLightPtr->getShadowMapFBO());
-  glClear(GL_DEPTH_BUFFER_BIT);
+float renderPointLightShadowMap(const std::vector<SceneObject> &sceneObjects,
+                                const SceneObject              &pointLightSceneObject,
+                                const PointLight               *pointLightPtr,
+                                GLuint                          pointLightShadowMapShaderProgram,
+                                size_t staticTransformGeneration, size_t cubeMapIndex,
+                                ShadowCubeMap &cubeMap, ShadowCacheEntry &entry,
+                                ShadowCasterStats &casterStats) {
+  ShadowCacheStats                 &shadowCacheStats = getMutableShadowCacheStats();
+  std::vector<const SceneObject *> &casterPtrs       = getShadowCasterPtrs();
+  const GLsizei                     resolution       = cubeMap.resolution;
 
   // Configuring camera viewing from light position in light direction
   PerspectiveCamera shadowMapCamera{};
-  shadowMapCamera.setPosition(pointLightSceneObject.getTranslate());
+  shadowMapCamera.setPosition(glm::vec3{pointLightSceneObject.getModelMatrix()[3]});
   shadowMapCamera.setVerticalFOV(glm::radians(90.0f));
   shadowMapCamera.setAspectRatio(1.0f);
   shadowMapCamera.setNearPlane(0.01f);
   shadowMapCamera.setFarPlane(2.0f * kShadowMapDistance);
 
-  glm::mat4              projMatrix{shadowMapCamera.getProjectionMatrix()};
-  std::vector<glm::mat4> pointLightVPMatrices{};
+  glm::mat4                    projMatrix{shadowMapCamera.getProjectionMatrix()};
+  std::array<glm::mat4, 6>     pointLightVPMatrices{};
+  std::array<FrustumPlanes, 6> faceFrustumPlanes{};
   // For each cube map face
   for (unsigned int i = 0; i < 6; ++i) {
     switch (i) {
@@ -714,281 +1710,166 @@ static void renderPointLightShadowMap(const std::vector<SceneObject> &sceneObjec
         break;
     }
 
-    pointLightVPMatrices.push_back(projMatrix * shadowMapCamera.getViewMatrix());
+    pointLightVPMatrices[i] = projMatrix * shadowMapCamera.getViewMatrix();
+    faceFrustumPlanes[i] = shadowMapCamera.calculateFrustumPlanes();
   }
 
-  // Pushing light camera far plane to vector
-  pointLightFarPlanes.push_back(shadowMapCamera.getFarPlane());
+  // Gathering casters within light range, checking if static depth of cube map is still valid
+  // and if there are dynamic casters to draw
+  const FrustumPlanes frustumPlanes{calculateRangeFrustumPlanes(
+      shadowMapCamera.getPosition(), shadowMapCamera.getFarPlane())};
+  const glm::vec4 lightSphere{shadowMapCamera.getPosition(), shadowMapCamera.getFarPlane()};
+  bool            hasDynamicCasters{};
+  const uint64_t  staticCasterHash = gatherShadowCasters(
+      sceneObjects, ShadowCasterVolume{frustumPlanes, lightSphere, glm::vec3{}},
+      staticTransformGeneration, casterPtrs, hasDynamicCasters, casterStats);
+  // (cube map must be the same one as the last frame and must still keep static depth of light)
+  const bool isStaticDepthValid = entry.isValid && entry.lightVPMatrix == pointLightVPMatrices[0] &&
+                                  entry.cubeMapIndex == cubeMapIndex &&
+                                  cubeMap.staticLightPtr == pointLightPtr &&
+                                  entry.staticCasterHash == staticCasterHash;
+
+  // If nothing changed and no dynamic casters were or are there, cube map keeps the last depth
+  entry.isDepthUpdated = !isStaticDepthValid || hasDynamicCasters || entry.hasDynamicCasters;
+  if (!entry.isDepthUpdated) {
+    ++shadowCacheStats.reusedCount;
+    return shadowMapCamera.getFarPlane();
+  }
 
   // Updating shader program uniform values
   glUseProgram(pointLightShadowMapShaderProgram);
   for (unsigned int i = 0; i < 6; ++i) {
-    glUniformMatrix4fv(glGetUniformLocation(pointLightShadowMapShaderProgram,
-                                            ("LIGHT_VP[" + std::to_string(i) + "]").c_str()),
-                       1, GL_FALSE, glm::value_ptr(pointLightVPMatrices[i]));
-    glUniform3fv(glGetUniformLocation(pointLightShadowMapShaderProgram, "LIGHT.worldPos"), 1,
-                 glm::value_ptr(pointLightSceneObject.getTranslate()));
-    glUniform1f(glGetUniformLocation(pointLightShadowMapShaderProgram, "LIGHT.farPlane"),
-                shadowMapCamera.getFarPlane());
+    glUniformMatrix4fv(getUniformLocation(pointLightShadowMapShaderProgram, kLightVPUniforms[i]), 1,
+                       GL_FALSE, glm::value_ptr(pointLightVPMatrices[i]));
   }
+  glUniform3fv(getUniformLocation(pointLightShadowMapShaderProgram, kLightWorldPosUniform), 1,
+               glm::value_ptr(shadowMapCamera.getPosition()));
+  glUniform1f(getUniformLocation(pointLightShadowMapShaderProgram, kLightFarPlaneUniform),
+              shadowMapCamera.getFarPlane());
   glUseProgram(0);
 
-  // Temporary changing scene object shader programs
-  std::vector<GLuint> initShaderPrograms{};
-  // For each scene object
-  for (size_t i = 0; i < sceneObjects.size(); ++i) {
-    std::vector<std::shared_ptr<Component>> meshPtrs{
-        const_cast<std::vector<SceneObject> &>(sceneObjects)[i].getSpecificComponentPtrs(
-            ComponentType::Mesh)};
-
-    // For each mesh component
-    for (size_t i = 0; i < meshPtrs.size(); ++i) {
-      Mesh &mesh = *dynamic_cast<Mesh *>(meshPtrs[i].get());
-
-      // If mesh is complete
-      if (mesh.isComplete()) {
-        initShaderPrograms.push_back(mesh.getShaderProgram());
-        mesh.setShaderProgram(pointLightShadowMapShaderProgram);
-      }
-    }
+  // Setting shadow map viewport
+  glViewport(0, 0, resolution, resolution);
+
+  // If static depth is outdated
+  if (!isStaticDepthValid) {
+    // Clearing static cube map and rendering static casters depth into it
+    glBindFramebuffer(GL_FRAMEBUFFER, cubeMap.staticFBO.get());
+    glClear(GL_DEPTH_BUFFER_BIT);
+    renderPointLightCasters(casterPtrs, pointLightShadowMapShaderProgram, faceFrustumPlanes,
+                            frustumPlanes, 0, staticTransformGeneration);
+    ++shadowCacheStats.staticRenderCount;
+
+    cubeMap.staticLightPtr = pointLightPtr;
+    entry.lightVPMatrix    = pointLightVPMatrices[0];
+    entry.cubeMapIndex     = cubeMapIndex;
+    entry.staticCasterHash = staticCasterHash;
+    entry.isValid          = true;
   }
-  // Temporary updating shader camera
-  SceneObject::updateShadersCamera(sceneObjects, shadowMapCamera);
-
-  // Rendering scene object from camera point of view
-  // and reverting shader program changes for each scene object
-  std::vector<GLuint> initShaderProgramsReversed{initShaderPrograms.crbegin(),
-                                                 initShaderPrograms.crend()};
-  for (size_t i = 0; i < sceneObjects.size(); ++i) {
-    sceneObjects[i].render();
 
-    // Getting mesh component pointers
-    std::vector<std::shared_ptr<Component>> meshPtrs{
-        const_cast<std::vector<SceneObject> &>(sceneObjects)[i].getSpecificComponentPtrs(
-            ComponentType::Mesh)};
-
-    // For each mesh component
-    for (size_t i = 0; i < meshPtrs.size(); ++i) {
-      Mesh &mesh = *dynamic_cast<Mesh *>(meshPtrs[i].get());
-
-      // If mesh is complete
-      if (mesh.isComplete()) {
-        mesh.setShaderProgram(initShaderProgramsReversed.back());
-        initShaderProgramsReversed.pop_back();
-      }
-    }
+  // Copying static depth into all the faces of shadow map (which also erases dynamic casters
+  // of the last frame)
+  glCopyImageSubData(cubeMap.staticTexture.get(), GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+                     cubeMap.texture.get(), GL_TEXTURE_CUBE_MAP, 0, 0, 0, 0,
+                     resolution, resolution, 6);
+
+  // Drawing dynamic casters over static depth
+  if (hasDynamicCasters) {
+    glBindFramebuffer(GL_FRAMEBUFFER, cubeMap.fbo.get());
+    renderPointLightCasters(casterPtrs, pointLightShadowMapShaderProgram, faceFrustumPlanes,
+                            frustumPlanes, staticTransformGeneration,
+                            std::numeric_limits<size_t>::max());
+    ++shadowCacheStats.dynamicRenderCount;
   }
+  entry.hasDynamicCasters = hasDynamicCasters;
 
   // Unbinding shadow map framebuffer
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
-}
-
-void updateShaderProgramSpotLights(GLuint                                  shaderProgram,
-                                   const std::vector<const SpotLight *>   &spotLightPtrs,
-                                   const std::vector<const SceneObject *> &spotLightSceneObjectPtrs,
-                                   GLuint                  spotLightShadowMapShaderProgram,
-                                   int                    &currShadowMapTextureUnit,
-                                   std::vector<glm::mat4> &spotLightVPMatrices) {
-  glUseProgram(shaderProgram);
-
-  // For each spot light
-  for (size_t i = 0; i < spotLightSceneObjectPtrs.size() && i < kMaxSpotLightCount; ++i) {
-    const SceneObject &sceneObject  = *spotLightSceneObjectPtrs[i];
-    const SpotLight   *spotLightPtr = spotLightPtrs[i];
-
-    glUniform3fv(glGetUniformLocation(shaderProgram,
-                                      ("SPOT_LIGHTS[" + std::to_string(i) + "].worldPos").c_str()),
-                 1, glm::value_ptr(sceneObject.getTranslate()));
-    glUniform3fv(glGetUniformLocation(shaderProgram,
-                                      ("SPOT_LIGHTS[" + std::to_string(i) + "].color").c_str()),
-                 1, glm::value_ptr(spotLightPtr->getColor()));
-    glm::mat4 rotateMatrix{glm::eulerAngleXYZ(glm::radians(sceneObject.getRotate().x),
-                                              glm::radians(sceneObject.getRotate().y),
-                                              glm::radians(sceneObject.getRotate().z))};
-    glm::vec3 dir{
-        rotateMatrix * glm::vec4{spotLightPtr->getDirection(), 0.0f}
-    };
-    glUniform3fv(
-        glGetUniformLocation(shaderProgram, ("SPOT_LIGHTS[" + std::to_string(i) + "].dir").c_str()),
-        1, glm::value_ptr(dir));
-    glUniform1f(glGetUniformLocation(shaderProgram,
-                                     ("SPOT_LIGHTS[" + std::to_string(i) + "].linAttCoef").c_str()),
-                spotLightPtr->getLinAttCoef());
-    glUniform1f(glGetUniformLocation(
-                    shaderProgram, ("SPOT_LIGHTS[" + std::to_string(i) + "].quadAttCoef").c_str()),
-                spotLightPtr->getQuadAttCoef());
-    glUniform1f(glGetUniformLocation(shaderProgram,
-                                     ("SPOT_LIGHTS[" + std::to_string(i) + "].angle").c_str()),
-                spotLightPtr->getAngle());
-    glUniform1f(glGetUniformLocation(
-                    shaderProgram, ("SPOT_LIGHTS[" + std::to_string(i) + "].smoothAngle").c_str()),
-                spotLightPtr->getSmoothAngle());
-    glUniform1i(glGetUniformLocation(shaderProgram,
-                                     ("SPOT_LIGHTS[" + std::to_string(i) + "].shadowMap").c_str()),
-                currShadowMapTextureUnit);
-
-    // If shader program is specified
-    if (spotLightShadowMapShaderProgram > 0) {
-      glUniformMatrix4fv(glGetUniformLocation(
-                             shaderProgram, ("SPOT_LIGHTS[" + std::to_string(i) + "].VP").c_str()),
-                         1, GL_FALSE, glm::value_ptr(spotLightVPMatrices.back()));
-
-      // Deleting element from back
-      spotLightVPMatrices.pop_back();
-    }
 
-    // Binding shadow map texture
-    glActiveTexture(GL_TEXTURE0 + currShadowMapTextureUnit);
-    glBindTexture(GL_TEXTURE_2D, spotLightPtr->getShadowMapTexture());
-
-    // Incrementing current shadow map texture unit
-    ++currShadowMapTextureUnit;
-  }
-
-  // For the rest of spot lights in shader program
-  for (size_t i = spotLightSceneObjectPtrs.size(); i < kMaxSpotLightCount; ++i) {
-    glUniform1i(glGetUniformLocation(shaderProgram,
-                                     ("SPOT_LIGHTS[" + std::to_string(i) + "].shadowMap").c_str()),
-                currShadowMapTextureUnit);
-
-    // Binding shadow map texture
-    glActiveTexture(GL_TEXTURE0 + currShadowMapTextureUnit);
-    glBindTexture(GL_TEXTURE_2D, gTextureBlack);
-
-    // Incrementing current shadow map texture unit
-    ++currShadowMapTextureUnit;
-  }
-
-  glUseProgram(0);
+  // Returning light camera far plane
+  return shadowMapCamera.getFarPlane();
 }
 
-void updateShaderProgramDirectionalLights(
-    GLuint shaderProgram, const std::vector<const DirectionalLight *> &directionalLightPtrs,
-    const std::vector<const SceneObject *> &directionalLightSceneObjectPtrs,
-    GLuint directionalLightShadowMapShaderProgram, int &currShadowMapTextureUnit,
-    std::vector<glm::mat4> &directionalLightVPMatrices) {
-  glUseProgram(shaderProgram);
-
-  // For each directional light
-  for (size_t i = 0; i < directionalLightSceneObjectPtrs.size() && i < kMaxDirectionalLightCount;
-       ++i) {
-    const SceneObject      &sceneObject         = *directionalLightSceneObjectPtrs[i];
-    const DirectionalLight *directionalLightPtr = directionalLightPtrs[i];
-
-    glUniform3fv(
-        glGetUniformLocation(shaderProgram,
-                             ("DIRECTIONAL_LIGHTS[" + std::to_string(i) + "].color").c_str()),
-        1, glm::value_ptr(directionalLightPtr->getColor()));
-    glm::mat4 rotateMatrix{glm::eulerAngleXYZ(glm::radians(sceneObject.getRotate().x),
-                                              glm::radians(sceneObject.getRotate().y),
-                                              glm::radians(sceneObject.getRotate().z))};
-    glm::vec3 dir{
-        rotateMatrix * glm::vec4{directionalLightPtr->getDirection(), 0.0f}
-    };
-    glUniform3fv(glGetUniformLocation(
-                     shaderProgram, ("DIRECTIONAL_LIGHTS[" + std::to_string(i) + "].dir").c_str()),
-                 1, glm::value_ptr(dir));
-    glUniform1i(
-        glGetUniformLocation(shaderProgram,
-                             ("DIRECTIONAL_LIGHTS[" + std::to_string(i) + "].shadowMap").c_str()),
-        currShadowMapTextureUnit);
-
-    // If shader program is specified
-    if (directionalLightShadowMapShaderProgram > 0) {
-      glUniformMatrix4fv(
-          glGetUniformLocation(shaderProgram,
-                               ("DIRECTIONAL_LIGHTS[" + std::to_string(i) + "].VP").c_str()),
-          1, GL_FALSE, glm::value_ptr(directionalLightVPMatrices.back()));
-
-      // Deleting element from back
-      directionalLightVPMatrices.pop_back();
-    }
-
-    // Binding shadow map texture
-    glActiveTexture(GL_TEXTURE0 + currShadowMapTextureUnit);
-    glBindTexture(GL_TEXTURE_2D, directionalLightPtr->getShadowMapTexture());
-
-    // Incrementing current shadow map texture unit
-    ++currShadowMapTextureUnit;
+void renderPointLightCasters(const std::vector<const SceneObject *> &casterPtrs,
+                             GLuint                                  shaderProgram,
+                             const std::array<FrustumPlanes, 6>     &faceFrustumPlanes,
+                             const FrustumPlanes                    &rangeFrustumPlanes,
+                             size_t firstTransformGeneration, size_t lastTransformGeneration) {
+  // If shader program has no layer uniform, its geometry shader amplifies every triangle
+  // to all the faces, so casters are culled against light range only
+  const GLint layerLocation = getUniformLocation(shaderProgram, kLightLayerUniform);
+  if (layerLocation < 0) {
+    SceneObject::renderDepthOnly(casterPtrs, shaderProgram, rangeFrustumPlanes,
+                                 firstTransformGeneration, lastTransformGeneration);
+    return;
   }
 
-  // For the rest of directional lights in shader program
-  for (size_t i = directionalLightSceneObjectPtrs.size(); i < kMaxDirectionalLightCount; ++i) {
-    glUniform1i(
-        glGetUniformLocation(shaderProgram,
-                             ("DIRECTIONAL_LIGHTS[" + std::to_string(i) + "].shadowMap").c_str()),
-        currShadowMapTextureUnit);
-
-    // Binding shadow map texture
-    glActiveTexture(GL_TEXTURE0 + currShadowMapTextureUnit);
-    glBindTexture(GL_TEXTURE_2D, gTextureBlack);
+  // For each cube map face (vertex shader selects layer, so casters are drawn only into faces
+  // whose frustum they intersect)
+  for (size_t i = 0; i < faceFrustumPlanes.size(); ++i) {
+    glUseProgram(shaderProgram);
+    glUniform1i(layerLocation, static_cast<GLint>(i));
+    glUseProgram(0);
 
-    // Incrementing current shadow map texture unit
-    ++currShadowMapTextureUnit;
+    SceneObject::renderDepthOnly(casterPtrs, shaderProgram, faceFrustumPlanes[i],
+                                 firstTransformGeneration, lastTransformGeneration);
   }
-
-  glUseProgram(0);
 }
 
-void updateShaderProgramPointLights(
-    GLuint shaderProgram, const std::vector<const PointLight *> &pointLightPtrs,
-    const std::vector<const SceneObject *> &pointLightSceneObjectPtrs,
-    GLuint pointLightShadowMapShaderProgram, int &currShadowMapTextureUnit,
-    std::vector<float> &pointLightFarPlanes) {
-  glUseProgram(shaderProgram);
-
-  // For each point light
-  for (size_t i = 0; i < pointLightSceneObjectPtrs.size() && i < kMaxPointLightCount; ++i) {
-    const SceneObject &sceneObject   = *pointLightSceneObjectPtrs[i];
-    const PointLight  *pointLightPtr = pointLightPtrs[i];
-
-    glUniform3fv(glGetUniformLocation(shaderProgram,
-                                      ("POINT_LIGHTS[" + std::to_string(i) + "].worldPos").c_str()),
-                 1, glm::value_ptr(sceneObject.getTranslate()));
-    glUniform3fv(glGetUniformLocation(shaderProgram,
-                                      ("POINT_LIGHTS[" + std::to_string(i) + "].color").c_str()),
-                 1, glm::value_ptr(pointLightPtr->getColor()));
-    glUniform1f(glGetUniformLocation(
-                    shaderProgram, ("POINT_LIGHTS[" + std::to_string(i) + "].linAttCoef").c_str()),
-                pointLightPtr->getLinAttCoef());
-    glUniform1f(glGetUniformLocation(
-                    shaderProgram, ("POINT_LIGHTS[" + std::to_string(i) + "].quadAttCoef").c_str()),
-                pointLightPtr->getQuadAttCoef());
-    glUniform1i(glGetUniformLocation(shaderProgram,
-                                     ("POINT_LIGHTS[" + std::to_string(i) + "].shadowMap").c_str()),
-                currShadowMapTextureUnit);
-
-    // If shader program is specified
-    if (pointLightShadowMapShaderProgram > 0) {
-      glUniform1f(glGetUniformLocation(
-                      shaderProgram, ("POINT_LIGHTS[" + std::to_string(i) + "].farPlane").c_str()),
-                  pointLightFarPlanes.back());
-
-      // Deleting element from back
-      pointLightFarPlanes.pop_back();
-    }
-
-    // Binding shadow map texture
-    glActiveTexture(GL_TEXTURE0 + currShadowMapTextureUnit);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, pointLightPtr->getShadowMapTexture());
-
-    // Incrementing current shadow map texture unit
-    ++currShadowMapTextureUnit;
+GLuint getShadowFilterBlurTexture(GLsizei resolution) {
+  static TextureHandle sBlurTexture{};
+  static GLsizei       sBlurTextureResolution{};
+
+  // Creating blur texture on the first use or when a larger one is needed
+  if (resolution > sBlurTextureResolution) {
+    sBlurTexture           = TextureHandle::create();
+    sBlurTextureResolution = resolution;
+    glBindTexture(GL_TEXTURE_2D, sBlurTexture.get());
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RG32F, resolution, resolution);
+    glBindTexture(GL_TEXTURE_2D, 0);
   }
 
-  // For the rest of point lights in shader program
-  for (size_t i = pointLightSceneObjectPtrs.size(); i < kMaxPointLightCount; ++i) {
-    glUniform1i(glGetUniformLocation(shaderProgram,
-                                     ("POINT_LIGHTS[" + std::to_string(i) + "].shadowMap").c_str()),
-                currShadowMapTextureUnit);
+  return sBlurTexture.get();
+}
 
-    // Binding shadow map texture
-    glActiveTexture(GL_TEXTURE0 + currShadowMapTextureUnit);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, gTextureBlack);
+void filterShadowMap(GLuint filterShaderProgram, GLuint depthTexture, GLint face,
+                     GLuint momentsTexture, GLuint blurTexture, const glm::ivec4 &momentsRect) {
+  const GLuint groupCountX = (momentsRect.z + kShadowFilterWorkGroupSize - 1) /
+                             kShadowFilterWorkGroupSize;
+  const GLuint groupCountY = (momentsRect.w + kShadowFilterWorkGroupSize - 1) /
+                             kShadowFilterWorkGroupSize;
 
-    // Incrementing current shadow map texture unit
-    ++currShadowMapTextureUnit;
+  // Updating shader program uniform values
+  glUseProgram(filterShaderProgram);
+  glUniform1i(getUniformLocation(filterShaderProgram, kFilterFaceUniform), face);
+  glUniform4iv(getUniformLocation(filterShaderProgram, kFilterRectUniform), 1,
+               glm::value_ptr(momentsRect));
+
+  // Binding depth shadow map (cube map if face is specified)
+  if (face < 0) {
+    glActiveTexture(GL_TEXTURE0 + kShadowFilterDepthTextureUnit);
+    glBindTexture(GL_TEXTURE_2D, depthTexture);
+  } else {
+    glActiveTexture(GL_TEXTURE0 + kShadowFilterDepthCubeTextureUnit);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, depthTexture);
   }
 
+  // Turning depth into moments and blurring them horizontally into blur texture
+  glUniform1i(getUniformLocation(filterShaderProgram, kFilterPassUniform), 0);
+  glBindImageTexture(kShadowFilterOutputImageUnit, blurTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY,
+                     GL_RG32F);
+  glDispatchCompute(groupCountX, groupCountY, 1);
+  glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+  // Blurring moments vertically into moments shadow map (single face of cube map)
+  glUniform1i(getUniformLocation(filterShaderProgram, kFilterPassUniform), 1);
+  glActiveTexture(GL_TEXTURE0 + kShadowFilterBlurTextureUnit);
+  glBindTexture(GL_TEXTURE_2D, blurTexture);
+  glBindImageTexture(kShadowFilterOutputImageUnit, momentsTexture, 0, GL_FALSE,
+                     face < 0 ? 0 : face, GL_WRITE_ONLY, GL_RG32F);
+  glDispatchCompute(groupCountX, groupCountY, 1);
+  glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+  // Unbinding shader program
   glUseProgram(0);
 }
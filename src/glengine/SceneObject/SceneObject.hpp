@@ -3,8 +3,12 @@
 
 // All the headers
 #include "./Component/component.inc"
+#include "./Scene.hpp"
+#include "./ShadowAtlas.hpp"
+#include "./ShadowCubeMapPool.hpp"
 
 // STD
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -14,24 +18,47 @@
 
 namespace glengine {
 
-// Scene object class
-class SceneObject {
- private:
-  // World orientation
-  glm::vec3 _translate{};
-  glm::vec3 _rotate{};
-  glm::vec3 _scale{};
+// Frustum culling statistics struct (of camera passes; shadow passes are counted by shadow
+// caster statistics instead)
+struct CullingStats {
+  size_t visibleMeshCount{};  // meshes intersecting frustum (or having no bounding volume)
+  size_t culledMeshCount{};   // meshes skipped for being completely outside of frustum
+};
 
-  glm::mat4 _modelMatrix{};
+// Shadow cache statistics struct (shadow maps are spot light and directional light cascade tiles
+// of shadow atlas and point light cube maps)
+struct ShadowCacheStats {
+  size_t staticRenderCount{};   // shadow maps whose static casters depth was rendered again
+  size_t dynamicRenderCount{};  // shadow maps whose dynamic casters were drawn over static depth
+  size_t reusedCount{};         // shadow maps left untouched since nothing changed in their volume
+};
 
-  // Components
-  std::vector<std::shared_ptr<Component>> _componentPtrs{};
+// Shadow caster culling statistics struct (of one shadow map: spot light, directional light
+// cascade or point light)
+struct ShadowCasterStats {
+  const BaseLight *lightPtr{};
+  unsigned int     cascadeIndex{};
+  size_t           casterCount{};  // scene objects casting shadow into shadow map
+  size_t           culledCount{};  // scene objects skipped for being unable to cast shadow into it
+};
+
+// Scene object class (handle of scene entity, whose orientation relative to parent, model matrix,
+// transform generation and components are kept in scene arrays; transform generation is
+// a unique value taken from global counter on every transform change, so shadow caches
+// can tell which scene objects moved)
+class SceneObject {
+ private:
+  Scene *_scenePtr{};
+  size_t _entity{Scene::kNoEntity};
 
  public:
   // Constructors, assignment operators and destructor
   SceneObject() noexcept;
   SceneObject(const glm::vec3 &translate, const glm::vec3 &rotate, const glm::vec3 &scale,
               const std::vector<std::shared_ptr<Component>> &componentPtrs) noexcept;
+  SceneObject(Scene &scene, const glm::vec3 &translate, const glm::vec3 &rotate,
+              const glm::vec3                               &scale,
+              const std::vector<std::shared_ptr<Component>> &componentPtrs) noexcept;
   SceneObject(const glm::vec3 &translate, const glm::vec3 &rotate, const glm::vec3 &scale,
               int initComponentsCount, ...);
   SceneObject(const SceneObject &sceneObject) noexcept;
@@ -45,6 +72,7 @@ class SceneObject {
   void setRotate(const glm::vec3 &rotate) noexcept;
   void setScale(const glm::vec3 &scale) noexcept;
   void setModelMatrix(const glm::mat4 &modelMatrix) noexcept;
+  bool setParent(const SceneObject *parentPtr) noexcept;
   void setComponentPtrs(const std::vector<std::shared_ptr<Component>> &componentPtrs) noexcept;
 
   // Getters
@@ -58,19 +86,63 @@ class SceneObject {
   glm::mat4                                     &getModelMatrix() noexcept;
   const std::vector<std::shared_ptr<Component>> &getComponentPtrs() const noexcept;
   std::vector<std::shared_ptr<Component>>       &getComponentPtrs() noexcept;
+  size_t                                         getTransformGeneration() const noexcept;
+  SceneObject                                   *getParentPtr() const noexcept;
+  Scene                                         *getScenePtr() const noexcept;
+  size_t                                         getEntity() const noexcept;
 
   // Other member functions
   void recalculateModelMatrix() noexcept;
 
+  // Gets components of specific type as a new vector (it is allocated every call, so typed
+  // queries below are used every frame)
   std::vector<std::shared_ptr<const Component>> getSpecificComponentPtrs(
       ComponentType type) const noexcept;
   std::vector<std::shared_ptr<Component>> getSpecificComponentPtrs(ComponentType type) noexcept;
 
+  // Gets range of components of specific type (Mesh, BaseLight or exact light type) without
+  // type checks or allocations
+  template <typename T>
+  SceneComponentRange<T> getComponents() const noexcept {
+    return _scenePtr->getComponents<T>(_entity);
+  }
+
+  // Calls function for each component of specific type
+  template <typename T, typename Function>
+  void forEach(Function function) const {
+    for (const SceneComponent<T> &component : _scenePtr->getComponents<T>(_entity)) {
+      function(static_cast<const T &>(*component.componentPtr));
+    }
+  }
+  template <typename T, typename Function>
+  void forEach(Function function) {
+    for (const SceneComponent<T> &component : _scenePtr->getComponents<T>(_entity)) {
+      function(*component.componentPtr);
+    }
+  }
+
+  // Gets the first component of specific type (nullptr if there is none)
+  template <typename T>
+  const T *getComponentPtr() const noexcept {
+    const SceneComponentRange<T> components{_scenePtr->getComponents<T>(_entity)};
+    return components.empty() ? nullptr : components.first->componentPtr;
+  }
+  template <typename T>
+  T *getComponentPtr() noexcept {
+    const SceneComponentRange<T> components{_scenePtr->getComponents<T>(_entity)};
+    return components.empty() ? nullptr : components.first->componentPtr;
+  }
+
   void updateShaderModelMatrix(const Mesh &mesh) const noexcept;
   void updateShaderLightColor(const Mesh &mesh, const BaseLight &light) const noexcept;
   void updateShaderExposure(const Mesh &mesh, float exposure) const noexcept;
 
+  bool isMeshVisible(const Mesh &mesh, const FrustumPlanes &frustumPlanes) const noexcept;
+  bool isMeshVisible(const Mesh &mesh, const FrustumPlanes &frustumPlanes,
+                     CullingStats &cullingStats) const noexcept;
+
   void render(float exposure = 1.0f) const noexcept;
+  void render(const FrustumPlanes &frustumPlanes, float exposure = 1.0f) const noexcept;
 
   // Other static member functions
   static void updateShadersLights(const std::vector<SceneObject> &sceneObjects,
@@ -78,9 +150,27 @@ class SceneObject {
                                   GLuint            directionalLightShadowMapShaderProgram = 0,
                                   GLuint            pointLightShadowMapShaderProgram       = 0,
                                   GLuint            spotLightShadowMapShaderProgram        = 0,
-                                  const BaseCamera &camera = PerspectiveCamera{}) noexcept;
-  static void updateShadersCamera(const std::vector<SceneObject> &sceneObjects,
-                                  const BaseCamera               &camera) noexcept;
+                                  const BaseCamera &camera = PerspectiveCamera{},
+                                  GLuint            shadowMapFilterShaderProgram = 0,
+                                  GLuint            lightClusteringShaderProgram = 0) noexcept;
+  static void updateShadersCamera(const BaseCamera &camera) noexcept;
+  static void addCullingStats(const CullingStats &cullingStats) noexcept;
+  static void renderDepthOnly(
+      const std::vector<SceneObject> &sceneObjects, GLuint depthShaderProgram,
+      const FrustumPlanes &frustumPlanes, size_t firstTransformGeneration = 0,
+      size_t lastTransformGeneration = std::numeric_limits<size_t>::max()) noexcept;
+  static void renderDepthOnly(
+      const std::vector<const SceneObject *> &sceneObjectPtrs, GLuint depthShaderProgram,
+      const FrustumPlanes &frustumPlanes, size_t firstTransformGeneration = 0,
+      size_t lastTransformGeneration = std::numeric_limits<size_t>::max()) noexcept;
+
+  static const CullingStats                   &getCullingStats() noexcept;
+  static void                                  resetCullingStats() noexcept;
+  static const ShadowAtlasStats               &getShadowAtlasStats() noexcept;
+  static const ShadowCacheStats               &getShadowCacheStats() noexcept;
+  static const ShadowCubeMapPoolStats         &getShadowCubeMapPoolStats() noexcept;
+  static void                                  setShadowCubeMapPoolBudget(size_t budget) noexcept;
+  static const std::vector<ShadowCasterStats> &getShadowCasterStats() noexcept;
 };
 
 }  // namespace glengine
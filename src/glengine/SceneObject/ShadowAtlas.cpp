@@ -0,0 +1,173 @@
+// Header file
+#include "./ShadowAtlas.hpp"
+
+// STD
+#include <algorithm>
+#include <numeric>
+
+using namespace glengine;
+
+// Local function headers
+static void    configureAtlasFramebuffer(GLuint fbo, GLuint texture, GLsizei resolution);
+static GLsizei roundDownToPowerOfTwo(GLsizei value);
+static void    decodeMortonIndex(size_t index, size_t &x, size_t &y);
+
+// Constructors, assignment operators and destructor
+
+// Parameterized constructor (resolution is rounded down to power of two)
+ShadowAtlas::ShadowAtlas(GLsizei resolution) noexcept
+    : _resolution{roundDownToPowerOfTwo(std::max(resolution, kMinTileResolution))},
+      _fbo{FramebufferHandle::create()},
+      _texture{TextureHandle::create()},
+      _staticFBO{FramebufferHandle::create()},
+      _staticTexture{TextureHandle::create()} {
+  configureAtlasFramebuffer(_fbo.get(), _texture.get(), _resolution);
+  configureAtlasFramebuffer(_staticFBO.get(), _staticTexture.get(), _resolution);
+}
+
+// Destructor (atlas FBOs and textures are deleted by their handles)
+ShadowAtlas::~ShadowAtlas() noexcept {}
+
+// Getters
+
+GLsizei ShadowAtlas::getResolution() const noexcept { return _resolution; }
+
+GLuint ShadowAtlas::getFBO() const noexcept { return _fbo.get(); }
+
+GLuint ShadowAtlas::getTexture() const noexcept { return _texture.get(); }
+
+GLuint ShadowAtlas::getStaticFBO() const noexcept { return _staticFBO.get(); }
+
+GLuint ShadowAtlas::getStaticTexture() const noexcept { return _staticTexture.get(); }
+
+GLuint ShadowAtlas::getMomentsTexture() const noexcept { return _momentsTexture.get(); }
+
+GLsizei ShadowAtlas::getMomentsResolution() const noexcept {
+  return _resolution / kMomentsDownsampling;
+}
+
+const ShadowAtlasStats &ShadowAtlas::getStats() const noexcept { return _stats; }
+
+// Other member functions
+
+// Packs tiles of requested resolutions into atlas (returns tiles in order of requests, which
+// stay valid until the next packing)
+const std::vector<ShadowAtlasTile> &ShadowAtlas::pack(
+    const std::vector<GLsizei> &requestedResolutions) noexcept {
+  _stats = ShadowAtlasStats{};
+  std::vector<ShadowAtlasTile> &tiles = _tiles;
+  tiles.assign(requestedResolutions.size(), ShadowAtlasTile{});
+
+  // Rounding requested resolutions down to powers of two between minimal tile and atlas ones
+  std::vector<GLsizei> &resolutions = _resolutions;
+  resolutions.resize(requestedResolutions.size());
+  for (size_t i = 0; i < requestedResolutions.size(); ++i) {
+    resolutions[i] = roundDownToPowerOfTwo(
+        std::clamp(requestedResolutions[i], kMinTileResolution, _resolution));
+  }
+
+  // Ordering tiles from the largest to the smallest (tiles of equal resolution stay in order
+  // of requests, as with stable sort, which would allocate its temporary buffer)
+  std::vector<size_t> &tileOrder = _tileOrder;
+  tileOrder.resize(requestedResolutions.size());
+  std::iota(tileOrder.begin(), tileOrder.end(), 0);
+  std::sort(tileOrder.begin(), tileOrder.end(), [&resolutions](size_t a, size_t b) {
+    return resolutions[a] != resolutions[b] ? resolutions[a] > resolutions[b] : a < b;
+  });
+
+  // Atlas is split into minimal tiles which are allocated in Morton order, so each tile is
+  // a contiguous range of them and is always aligned since tiles never grow in size
+  const size_t cellsPerSide = static_cast<size_t>(_resolution / kMinTileResolution);
+  const size_t cellCount    = cellsPerSide * cellsPerSide;
+  size_t       nextCell{};
+
+  // For each tile from the largest to the smallest
+  for (size_t i = 0; i < tileOrder.size(); ++i) {
+    const size_t tileIndex  = tileOrder[i];
+    GLsizei      resolution = resolutions[tileIndex];
+    size_t       cellsPerTile =
+        static_cast<size_t>(resolution / kMinTileResolution) * (resolution / kMinTileResolution);
+
+    // Halving tile while it does not fit into the rest of atlas
+    while (resolution > kMinTileResolution && nextCell + cellsPerTile > cellCount) {
+      resolution   /= 2;
+      cellsPerTile /= 4;
+    }
+
+    // If even minimal tile does not fit
+    if (nextCell + cellsPerTile > cellCount) {
+      ++_stats.rejectedTileCount;
+      continue;
+    }
+    if (resolution < resolutions[tileIndex]) ++_stats.downsizedTileCount;
+
+    // Placing tile at the next free cell
+    size_t cellX{}, cellY{};
+    decodeMortonIndex(nextCell, cellX, cellY);
+    tiles[tileIndex] = ShadowAtlasTile{static_cast<GLint>(cellX) * kMinTileResolution,
+                                       static_cast<GLint>(cellY) * kMinTileResolution, resolution};
+    nextCell        += cellsPerTile;
+    ++_stats.packedTileCount;
+  }
+
+  return tiles;
+}
+
+// Calculates UV rectangle of tile (offset in XY and size in ZW)
+glm::vec4 ShadowAtlas::calculateTileRect(const ShadowAtlasTile &tile) const noexcept {
+  const float resolution = static_cast<float>(_resolution);
+  return glm::vec4{static_cast<float>(tile.x) / resolution, static_cast<float>(tile.y) / resolution,
+                   static_cast<float>(tile.resolution) / resolution,
+                   static_cast<float>(tile.resolution) / resolution};
+}
+
+// Creates moments atlas on the first call (atlases of depth shadow maps only never allocate it)
+void ShadowAtlas::createMomentsTexture() noexcept {
+  if (_momentsTexture) return;
+
+  // Creating and configuring moments texture (filtered by hardware, tiles are clamped by shader)
+  _momentsTexture = TextureHandle::create();
+  glBindTexture(GL_TEXTURE_2D, _momentsTexture.get());
+  glTexStorage2D(GL_TEXTURE_2D, 1, GL_RG32F, getMomentsResolution(), getMomentsResolution());
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Local function definitions
+
+static void configureAtlasFramebuffer(GLuint fbo, GLuint texture, GLsizei resolution) {
+  // Creating and configuring atlas depth texture (tiles are clamped by shader, so no border)
+  glBindTexture(GL_TEXTURE_2D, texture);
+  glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT24, resolution, resolution);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  // Creating and configuring atlas FBO
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
+  glDrawBuffer(GL_NONE);
+  glReadBuffer(GL_NONE);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+static GLsizei roundDownToPowerOfTwo(GLsizei value) {
+  GLsizei powerOfTwo = 1;
+  while (powerOfTwo * 2 <= value) powerOfTwo *= 2;
+  return powerOfTwo;
+}
+
+static void decodeMortonIndex(size_t index, size_t &x, size_t &y) {
+  // Even bits of index are X bits and odd ones are Y bits
+  x = 0;
+  y = 0;
+  for (size_t bit = 0; (index >> (2 * bit)) != 0; ++bit) {
+    x |= ((index >> (2 * bit)) & 1) << bit;
+    y |= ((index >> (2 * bit + 1)) & 1) << bit;
+  }
+}
@@ -0,0 +1,90 @@
+#ifndef GLENGINE_SCENEOBJECT_SHADOWATLAS_HPP
+#define GLENGINE_SCENEOBJECT_SHADOWATLAS_HPP
+
+// STD
+#include <cstddef>
+#include <vector>
+
+// OpenGL
+#include <glad/glad.h>
+
+// GLM
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+
+// "glengine" internal library
+#include "../GlHandle.hpp"
+
+namespace glengine {
+
+// Shadow atlas tile struct (square texel region of atlas, zero resolution if tile did not fit)
+struct ShadowAtlasTile {
+  GLint   x{};
+  GLint   y{};
+  GLsizei resolution{};
+};
+
+// Shadow atlas statistics struct
+struct ShadowAtlasStats {
+  size_t packedTileCount{};     // tiles allocated by the last packing
+  size_t downsizedTileCount{};  // tiles allocated smaller than requested for lack of space
+  size_t rejectedTileCount{};   // tiles not allocated at all (their lights are not shadowed)
+};
+
+// Shadow atlas class (one depth texture shared by all spot and directional light shadow maps,
+// which are packed into power-of-two tiles every frame; static atlas of the same layout keeps
+// depth of static casters only, which is copied into atlas tiles instead of being rendered again;
+// moments atlas of half resolution keeps filtered shadow maps if they are enabled)
+class ShadowAtlas {
+ public:
+  // Default atlas resolution and minimal tile resolution in texels
+  static constexpr GLsizei kDefaultResolution = 4096;
+  static constexpr GLsizei kMinTileResolution = 128;
+
+  // Downsampling of moments atlas (prefiltered moments need fewer texels than depth)
+  static constexpr GLsizei kMomentsDownsampling = 2;
+
+ private:
+  GLsizei           _resolution{};
+  FramebufferHandle _fbo{};
+  TextureHandle     _texture{};
+  FramebufferHandle _staticFBO{};
+  TextureHandle     _staticTexture{};
+  TextureHandle     _momentsTexture{};
+  ShadowAtlasStats  _stats{};
+
+  // Tiles of the last packing and packing arrays (kept, so packing allocates nothing
+  // while tile count does not grow)
+  std::vector<ShadowAtlasTile> _tiles{};
+  std::vector<GLsizei>         _resolutions{};
+  std::vector<size_t>          _tileOrder{};
+
+ public:
+  // Constructors, assignment operators and destructor
+  explicit ShadowAtlas(GLsizei resolution = kDefaultResolution) noexcept;
+  ShadowAtlas(const ShadowAtlas &shadowAtlas)            = delete;
+  ShadowAtlas &operator=(const ShadowAtlas &shadowAtlas) = delete;
+  ShadowAtlas(ShadowAtlas &&shadowAtlas)                 = delete;
+  ShadowAtlas &operator=(ShadowAtlas &&shadowAtlas)      = delete;
+  ~ShadowAtlas() noexcept;
+
+  // Getters
+  GLsizei                 getResolution() const noexcept;
+  GLuint                  getFBO() const noexcept;
+  GLuint                  getTexture() const noexcept;
+  GLuint                  getStaticFBO() const noexcept;
+  GLuint                  getStaticTexture() const noexcept;
+  GLuint                  getMomentsTexture() const noexcept;
+  GLsizei                 getMomentsResolution() const noexcept;
+  const ShadowAtlasStats &getStats() const noexcept;
+
+  // Other member functions
+  const std::vector<ShadowAtlasTile> &pack(
+      const std::vector<GLsizei> &requestedResolutions) noexcept;
+  glm::vec4 calculateTileRect(const ShadowAtlasTile &tile) const noexcept;
+  void      createMomentsTexture() noexcept;
+};
+
+}  // namespace glengine
+
+#endif
@@ -0,0 +1,207 @@
+// Header file
+#include "./ShadowCubeMapPool.hpp"
+
+// STD
+#include <algorithm>
+#include <numeric>
+
+// "glengine" internal library
+#include "./ShadowAtlas.hpp"
+
+using namespace glengine;
+
+// Global constants
+
+// Bytes per texel of depth cube maps (24-bit depth is padded to 32 bits) and moments cube maps
+static constexpr size_t kDepthTexelByteCount   = 4;
+static constexpr size_t kMomentsTexelByteCount = 8;
+
+// Local function headers
+static void    configureCubeMapFramebuffer(GLuint fbo, GLuint texture, GLsizei resolution);
+static GLsizei roundDownToPowerOfTwo(GLsizei value);
+static size_t  calculateLevelCubeMapCount(GLsizei resolution, size_t lightCount);
+static size_t  calculateCubeMapByteCount(GLsizei resolution);
+static size_t  calculatePyramidByteCount(GLsizei maxResolution, size_t lightCount);
+
+// Constructors, assignment operators and destructor
+
+// Parameterized constructor (the smallest level has cube map for each of light count lights,
+// larger levels are dropped until pyramid fits budget)
+ShadowCubeMapPool::ShadowCubeMapPool(size_t budget, size_t lightCount,
+                                     GLsizei maxResolution) noexcept {
+  // Choosing the largest resolution whose pyramid fits budget
+  GLsizei topResolution = roundDownToPowerOfTwo(std::max(maxResolution, kMinResolution));
+  while (topResolution > kMinResolution &&
+         calculatePyramidByteCount(topResolution, lightCount) > budget) {
+    topResolution /= 2;
+  }
+  _stats.allocatedByteCount = calculatePyramidByteCount(topResolution, lightCount);
+
+  // For each level from the largest to the smallest
+  for (GLsizei resolution = topResolution; resolution >= kMinResolution; resolution /= 2) {
+    const size_t cubeMapCount = calculateLevelCubeMapCount(resolution, lightCount);
+    for (size_t i = 0; i < cubeMapCount; ++i) {
+      ShadowCubeMap cubeMap{resolution,
+                            FramebufferHandle::create(),
+                            TextureHandle::create(),
+                            FramebufferHandle::create(),
+                            TextureHandle::create()};
+      configureCubeMapFramebuffer(cubeMap.fbo.get(), cubeMap.texture.get(), resolution);
+      configureCubeMapFramebuffer(cubeMap.staticFBO.get(), cubeMap.staticTexture.get(),
+                                  resolution);
+      _cubeMaps.push_back(std::move(cubeMap));
+    }
+  }
+}
+
+// Destructor (cube map FBOs and textures are deleted by their handles)
+ShadowCubeMapPool::~ShadowCubeMapPool() noexcept {}
+
+// Getters
+
+size_t ShadowCubeMapPool::getCubeMapCount() const noexcept { return _cubeMaps.size(); }
+
+const ShadowCubeMap &ShadowCubeMapPool::getCubeMap(size_t index) const noexcept {
+  return _cubeMaps[index];
+}
+
+ShadowCubeMap &ShadowCubeMapPool::getCubeMap(size_t index) noexcept { return _cubeMaps[index]; }
+
+const ShadowCubeMapPoolStats &ShadowCubeMapPool::getStats() const noexcept { return _stats; }
+
+// Other member functions
+
+// Assigns cube maps of requested resolutions to lights (returns cube map indices in order
+// of requests, which stay valid until the next assignment; lights requesting the largest
+// resolutions are served first)
+const std::vector<size_t> &ShadowCubeMapPool::assign(
+    const std::vector<GLsizei> &requestedResolutions) noexcept {
+  _stats.assignedCubeMapCount  = 0;
+  _stats.downsizedCubeMapCount = 0;
+  _stats.rejectedCubeMapCount  = 0;
+  std::vector<size_t> &indices = _indices;
+  indices.assign(requestedResolutions.size(), kNoCubeMap);
+  std::vector<bool> &isAssigned = _isAssigned;
+  isAssigned.assign(_cubeMaps.size(), false);
+
+  // Rounding requested resolutions down to powers of two not smaller than minimal one
+  std::vector<GLsizei> &resolutions = _resolutions;
+  resolutions.resize(requestedResolutions.size());
+  for (size_t i = 0; i < requestedResolutions.size(); ++i) {
+    resolutions[i] = roundDownToPowerOfTwo(std::max(requestedResolutions[i], kMinResolution));
+  }
+
+  // Ordering requests from the largest to the smallest (order is stable, so lights keep
+  // their cube maps between frames while their resolutions do not change; ties are broken
+  // by request index instead of stable sort, which would allocate its temporary buffer)
+  std::vector<size_t> &requestOrder = _requestOrder;
+  requestOrder.resize(requestedResolutions.size());
+  std::iota(requestOrder.begin(), requestOrder.end(), 0);
+  std::sort(requestOrder.begin(), requestOrder.end(), [&resolutions](size_t a, size_t b) {
+    return resolutions[a] != resolutions[b] ? resolutions[a] > resolutions[b] : a < b;
+  });
+
+  // For each request from the largest to the smallest
+  for (size_t i = 0; i < requestOrder.size(); ++i) {
+    const size_t requestIndex = requestOrder[i];
+
+    // Taking the largest free cube map not larger than requested one
+    for (size_t j = 0; j < _cubeMaps.size(); ++j) {
+      if (isAssigned[j] || _cubeMaps[j].resolution > resolutions[requestIndex]) continue;
+
+      indices[requestIndex] = j;
+      isAssigned[j]         = true;
+      break;
+    }
+
+    // If there is no free cube map small enough
+    if (indices[requestIndex] == kNoCubeMap) {
+      ++_stats.rejectedCubeMapCount;
+      continue;
+    }
+    if (_cubeMaps[indices[requestIndex]].resolution < resolutions[requestIndex]) {
+      ++_stats.downsizedCubeMapCount;
+    }
+    ++_stats.assignedCubeMapCount;
+  }
+
+  return indices;
+}
+
+// Creates moments cube maps on the first call (they are counted in budget from the beginning,
+// but pools of depth shadow maps only never allocate them)
+void ShadowCubeMapPool::createMomentsTextures() noexcept {
+  // For each cube map without moments cube map
+  for (size_t i = 0; i < _cubeMaps.size(); ++i) {
+    ShadowCubeMap &cubeMap = _cubeMaps[i];
+    if (cubeMap.momentsTexture) continue;
+
+    // Creating and configuring moments cube map (filtered by hardware)
+    const GLsizei momentsResolution = cubeMap.resolution / ShadowAtlas::kMomentsDownsampling;
+    cubeMap.momentsTexture          = TextureHandle::create();
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cubeMap.momentsTexture.get());
+    glTexStorage2D(GL_TEXTURE_CUBE_MAP, 1, GL_RG32F, momentsResolution, momentsResolution);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+  }
+  glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+}
+
+// Local function definitions
+
+static void configureCubeMapFramebuffer(GLuint fbo, GLuint texture, GLsizei resolution) {
+  // Creating and configuring depth cube map (live and static ones match, so that static one
+  // can be copied into live one)
+  glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+  glTexStorage2D(GL_TEXTURE_CUBE_MAP, 1, GL_DEPTH_COMPONENT24, resolution, resolution);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  // Creating and configuring FBO
+  glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+  glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, texture, 0);
+  glDrawBuffer(GL_NONE);
+  glReadBuffer(GL_NONE);
+  glBindFramebuffer(GL_FRAMEBUFFER, 0);
+  glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+}
+
+static GLsizei roundDownToPowerOfTwo(GLsizei value) {
+  GLsizei powerOfTwo = 1;
+  while (powerOfTwo * 2 <= value) powerOfTwo *= 2;
+  return powerOfTwo;
+}
+
+static size_t calculateLevelCubeMapCount(GLsizei resolution, size_t lightCount) {
+  // Halving cube map count for each level above the smallest one (at least one per level)
+  size_t cubeMapCount = std::max(lightCount, size_t{1});
+  for (GLsizei levelResolution = ShadowCubeMapPool::kMinResolution;
+       levelResolution < resolution; levelResolution *= 2) {
+    cubeMapCount = std::max(cubeMapCount / 2, size_t{1});
+  }
+  return cubeMapCount;
+}
+
+static size_t calculateCubeMapByteCount(GLsizei resolution) {
+  // Live and static depth cube maps and moments cube map of lower resolution
+  const size_t faceTexelCount = static_cast<size_t>(resolution) * static_cast<size_t>(resolution);
+  const size_t downsampling   = static_cast<size_t>(ShadowAtlas::kMomentsDownsampling);
+  return 6 * (2 * faceTexelCount * kDepthTexelByteCount +
+              faceTexelCount / (downsampling * downsampling) * kMomentsTexelByteCount);
+}
+
+static size_t calculatePyramidByteCount(GLsizei maxResolution, size_t lightCount) {
+  size_t byteCount{};
+  for (GLsizei resolution = maxResolution; resolution >= ShadowCubeMapPool::kMinResolution;
+       resolution /= 2) {
+    byteCount += calculateLevelCubeMapCount(resolution, lightCount) *
+                 calculateCubeMapByteCount(resolution);
+  }
+  return byteCount;
+}
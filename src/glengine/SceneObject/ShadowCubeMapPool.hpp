@@ -0,0 +1,86 @@
+#ifndef GLENGINE_SCENEOBJECT_SHADOWCUBEMAPPOOL_HPP
+#define GLENGINE_SCENEOBJECT_SHADOWCUBEMAPPOOL_HPP
+
+// STD
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// OpenGL
+#include <glad/glad.h>
+
+// "glengine" internal library
+#include "../GlHandle.hpp"
+
+namespace glengine {
+
+class BaseLight;
+
+// Shadow cube map struct (point light shadow map of pool; static cube map keeps depth of static
+// casters of the light it was last rendered for, moments cube map keeps filtered shadow map)
+struct ShadowCubeMap {
+  GLsizei           resolution{};
+  FramebufferHandle fbo{};
+  TextureHandle     texture{};
+  FramebufferHandle staticFBO{};
+  TextureHandle     staticTexture{};
+  TextureHandle     momentsTexture{};
+  const BaseLight  *staticLightPtr{};  // light whose static depth is kept (nullptr if none)
+};
+
+// Shadow cube map pool statistics struct
+struct ShadowCubeMapPoolStats {
+  size_t assignedCubeMapCount{};   // cube maps assigned by the last assignment
+  size_t downsizedCubeMapCount{};  // cube maps smaller than requested for lack of free ones
+  size_t rejectedCubeMapCount{};   // lights left without cube map (they are not shadowed)
+  size_t allocatedByteCount{};     // video memory taken by pool (moments cube maps included)
+};
+
+// Shadow cube map pool class (point light shadow maps preallocated within video memory budget
+// as a pyramid of resolutions, where each level has half the cube maps of the level below;
+// cube maps are assigned to lights by requested resolution every frame and never reallocated)
+class ShadowCubeMapPool {
+ public:
+  // Default budget in bytes and maximal and minimal cube map resolutions in texels
+  static constexpr size_t  kDefaultBudget        = size_t{128} << 20;
+  static constexpr GLsizei kDefaultMaxResolution = 1024;
+  static constexpr GLsizei kMinResolution        = 128;
+
+  // Index of cube map of lights which got none
+  static constexpr size_t kNoCubeMap = std::numeric_limits<size_t>::max();
+
+ private:
+  std::vector<ShadowCubeMap> _cubeMaps{};  // from the largest to the smallest
+  ShadowCubeMapPoolStats     _stats{};
+
+  // Cube map indices of the last assignment and assignment arrays (kept, so assignment
+  // allocates nothing while request count does not grow)
+  std::vector<size_t>  _indices{};
+  std::vector<bool>    _isAssigned{};
+  std::vector<GLsizei> _resolutions{};
+  std::vector<size_t>  _requestOrder{};
+
+ public:
+  // Constructors, assignment operators and destructor
+  ShadowCubeMapPool(size_t budget, size_t lightCount,
+                    GLsizei maxResolution = kDefaultMaxResolution) noexcept;
+  ShadowCubeMapPool(const ShadowCubeMapPool &shadowCubeMapPool)            = delete;
+  ShadowCubeMapPool &operator=(const ShadowCubeMapPool &shadowCubeMapPool) = delete;
+  ShadowCubeMapPool(ShadowCubeMapPool &&shadowCubeMapPool)                 = delete;
+  ShadowCubeMapPool &operator=(ShadowCubeMapPool &&shadowCubeMapPool)      = delete;
+  ~ShadowCubeMapPool() noexcept;
+
+  // Getters
+  size_t                        getCubeMapCount() const noexcept;
+  const ShadowCubeMap          &getCubeMap(size_t index) const noexcept;
+  ShadowCubeMap                &getCubeMap(size_t index) noexcept;
+  const ShadowCubeMapPoolStats &getStats() const noexcept;
+
+  // Other member functions
+  const std::vector<size_t> &assign(const std::vector<GLsizei> &requestedResolutions) noexcept;
+  void                       createMomentsTextures() noexcept;
+};
+
+}  // namespace glengine
+
+#endif
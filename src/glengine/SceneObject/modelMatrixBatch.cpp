@@ -0,0 +1,248 @@
+// Header file
+#include "./modelMatrixBatch.hpp"
+
+// STD
+#include <cmath>
+
+// SIMD intrinsics (chosen by instruction sets compiler targets, scalar code is used otherwise)
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define GLENGINE_MODEL_MATRIX_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GLENGINE_MODEL_MATRIX_BATCH_SSE2
+#endif
+
+// Global constants
+
+static constexpr float kDegreesToRadians = 3.14159265358979f / 180.0f;
+
+// Sine and cosine range reduction (pi / 4 is split into three parts, so that argument
+// is reduced without losing precision) and minimax polynomial coefficients (from Cephes library)
+static constexpr float kFourOverPi      = 1.27323954473516f;
+static constexpr float kPiOverFourPart1 = 0.78515625f;
+static constexpr float kPiOverFourPart2 = 2.4187564849853515625e-4f;
+static constexpr float kPiOverFourPart3 = 3.77489497744594108e-8f;
+static constexpr float kSinCoef0        = -1.9515295891e-4f;
+static constexpr float kSinCoef1        = 8.3321608736e-3f;
+static constexpr float kSinCoef2        = -1.6666654611e-1f;
+static constexpr float kCosCoef0        = 2.443315711809948e-5f;
+static constexpr float kCosCoef1        = -1.388731625493765e-3f;
+static constexpr float kCosCoef2        = 4.166664568298827e-2f;
+
+// Object count composed at once and instruction set name
+#if defined(GLENGINE_MODEL_MATRIX_BATCH_AVX2)
+static constexpr size_t kLaneCount        = 8;
+static constexpr char   kInstructionSet[] = "AVX2";
+#elif defined(GLENGINE_MODEL_MATRIX_BATCH_SSE2)
+static constexpr size_t kLaneCount        = 4;
+static constexpr char   kInstructionSet[] = "SSE2";
+#else
+static constexpr size_t kLaneCount        = 1;
+static constexpr char   kInstructionSet[] = "scalar";
+#endif
+
+// Lane operations (the same kernel is written once for both instruction sets)
+#if defined(GLENGINE_MODEL_MATRIX_BATCH_AVX2)
+using Float = __m256;
+using Int   = __m256i;
+
+static inline Float setFloat(float value) { return _mm256_set1_ps(value); }
+static inline Float loadFloat(const float *values) { return _mm256_load_ps(values); }
+static inline void  storeFloat(float *values, Float a) { _mm256_store_ps(values, a); }
+static inline Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+static inline Float sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+static inline Float mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+static inline Float mulAdd(Float a, Float b, Float c) { return _mm256_fmadd_ps(a, b, c); }
+static inline Float bitAnd(Float a, Float b) { return _mm256_and_ps(a, b); }
+static inline Float bitAndNot(Float a, Float b) { return _mm256_andnot_ps(a, b); }
+static inline Float bitXor(Float a, Float b) { return _mm256_xor_ps(a, b); }
+static inline Int   setInt(int value) { return _mm256_set1_epi32(value); }
+static inline Int   toInt(Float a) { return _mm256_cvttps_epi32(a); }
+static inline Float toFloat(Int a) { return _mm256_cvtepi32_ps(a); }
+static inline Float asFloat(Int a) { return _mm256_castsi256_ps(a); }
+static inline Int   addInt(Int a, Int b) { return _mm256_add_epi32(a, b); }
+static inline Int   subInt(Int a, Int b) { return _mm256_sub_epi32(a, b); }
+static inline Int   bitAndInt(Int a, Int b) { return _mm256_and_si256(a, b); }
+static inline Int   bitAndNotInt(Int a, Int b) { return _mm256_andnot_si256(a, b); }
+static inline Int   isEqualInt(Int a, Int b) { return _mm256_cmpeq_epi32(a, b); }
+static inline Int   shiftToSignBit(Int a) { return _mm256_slli_epi32(a, 29); }
+#elif defined(GLENGINE_MODEL_MATRIX_BATCH_SSE2)
+using Float = __m128;
+using Int   = __m128i;
+
+static inline Float setFloat(float value) { return _mm_set1_ps(value); }
+static inline Float loadFloat(const float *values) { return _mm_load_ps(values); }
+static inline void  storeFloat(float *values, Float a) { _mm_store_ps(values, a); }
+static inline Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+static inline Float sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+static inline Float mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+static inline Float mulAdd(Float a, Float b, Float c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+static inline Float bitAnd(Float a, Float b) { return _mm_and_ps(a, b); }
+static inline Float bitAndNot(Float a, Float b) { return _mm_andnot_ps(a, b); }
+static inline Float bitXor(Float a, Float b) { return _mm_xor_ps(a, b); }
+static inline Int   setInt(int value) { return _mm_set1_epi32(value); }
+static inline Int   toInt(Float a) { return _mm_cvttps_epi32(a); }
+static inline Float toFloat(Int a) { return _mm_cvtepi32_ps(a); }
+static inline Float asFloat(Int a) { return _mm_castsi128_ps(a); }
+static inline Int   addInt(Int a, Int b) { return _mm_add_epi32(a, b); }
+static inline Int   subInt(Int a, Int b) { return _mm_sub_epi32(a, b); }
+static inline Int   bitAndInt(Int a, Int b) { return _mm_and_si128(a, b); }
+static inline Int   bitAndNotInt(Int a, Int b) { return _mm_andnot_si128(a, b); }
+static inline Int   isEqualInt(Int a, Int b) { return _mm_cmpeq_epi32(a, b); }
+static inline Int   shiftToSignBit(Int a) { return _mm_slli_epi32(a, 29); }
+#endif
+
+// Local function headers
+#if defined(GLENGINE_MODEL_MATRIX_BATCH_AVX2) || defined(GLENGINE_MODEL_MATRIX_BATCH_SSE2)
+static void calculateSinCos(Float x, Float &sin, Float &cos);
+#endif
+static void composeLanes(const glm::vec3 *translates, const glm::vec3 *rotates,
+                         const glm::vec3 *scales, const size_t *indices, size_t first,
+                         size_t laneCount, glm::mat4 *modelMatrices);
+
+// Composes model matrices (translate * XYZ Euler angles rotate in degrees * scale) of objects
+// given by indices (or of the first count objects if indices is nullptr) from parallel arrays,
+// several objects at once with SIMD instructions the compiler targets
+void glengine::composeModelMatrices(const glm::vec3 *translates, const glm::vec3 *rotates,
+                                    const glm::vec3 *scales, const size_t *indices, size_t count,
+                                    glm::mat4 *modelMatrices) noexcept {
+  // For each group of objects composed at once (the last one may be incomplete)
+  for (size_t first = 0; first < count; first += kLaneCount) {
+    const size_t laneCount = count - first < kLaneCount ? count - first : kLaneCount;
+    composeLanes(translates, rotates, scales, indices, first, laneCount, modelMatrices);
+  }
+}
+
+// Gets instruction set model matrices are composed with ("AVX2", "SSE2" or "scalar")
+const char *glengine::getModelMatrixBatchInstructionSet() noexcept { return kInstructionSet; }
+
+// Local function definitions
+
+#if defined(GLENGINE_MODEL_MATRIX_BATCH_AVX2) || defined(GLENGINE_MODEL_MATRIX_BATCH_SSE2)
+void calculateSinCos(Float x, Float &sin, Float &cos) {
+  // Taking absolute value of argument (sine sign follows the argument one)
+  const Float signMask = asFloat(setInt(static_cast<int>(0x80000000)));
+  Float       sinSign  = bitAnd(x, signMask);
+  x                    = bitAndNot(signMask, x);
+
+  // Getting octant of argument (rounded up to even one) and reducing argument to [-pi/4, pi/4]
+  Int octant = toInt(mul(x, setFloat(kFourOverPi)));
+  octant     = bitAndInt(addInt(octant, setInt(1)), setInt(~1));
+
+  const Float y = toFloat(octant);
+  x             = sub(x, mul(y, setFloat(kPiOverFourPart1)));
+  x             = sub(x, mul(y, setFloat(kPiOverFourPart2)));
+  x             = sub(x, mul(y, setFloat(kPiOverFourPart3)));
+
+  // Getting signs and which polynomial gives sine and which one cosine by octant
+  sinSign = bitXor(sinSign, asFloat(shiftToSignBit(bitAndInt(octant, setInt(4)))));
+  const Float cosSign =
+      asFloat(shiftToSignBit(bitAndNotInt(subInt(octant, setInt(2)), setInt(4))));
+  const Float isSinPolynomial =
+      asFloat(isEqualInt(bitAndInt(octant, setInt(2)), setInt(0)));
+
+  // Evaluating cosine and sine polynomials
+  const Float z             = mul(x, x);
+  Float       cosPolynomial = mulAdd(setFloat(kCosCoef0), z, setFloat(kCosCoef1));
+  cosPolynomial             = mulAdd(cosPolynomial, z, setFloat(kCosCoef2));
+  cosPolynomial             = mul(mul(cosPolynomial, z), z);
+  cosPolynomial             = sub(cosPolynomial, mul(z, setFloat(0.5f)));
+  cosPolynomial             = add(cosPolynomial, setFloat(1.0f));
+
+  Float sinPolynomial = mulAdd(setFloat(kSinCoef0), z, setFloat(kSinCoef1));
+  sinPolynomial       = mulAdd(sinPolynomial, z, setFloat(kSinCoef2));
+  sinPolynomial       = mulAdd(mul(sinPolynomial, z), x, x);
+
+  // Selecting polynomials and applying signs
+  sin = bitXor(add(bitAnd(isSinPolynomial, sinPolynomial),
+                   bitAndNot(isSinPolynomial, cosPolynomial)),
+               sinSign);
+  cos = bitXor(add(bitAnd(isSinPolynomial, cosPolynomial),
+                   bitAndNot(isSinPolynomial, sinPolynomial)),
+               cosSign);
+}
+
+void composeLanes(const glm::vec3 *translates, const glm::vec3 *rotates, const glm::vec3 *scales,
+                  const size_t *indices, size_t first, size_t laneCount,
+                  glm::mat4 *modelMatrices) {
+  // Gathering rotates and scales of objects into lanes (unused lanes are zero)
+  alignas(32) float rotateXs[kLaneCount]{};
+  alignas(32) float rotateYs[kLaneCount]{};
+  alignas(32) float rotateZs[kLaneCount]{};
+  alignas(32) float scaleXs[kLaneCount]{};
+  alignas(32) float scaleYs[kLaneCount]{};
+  alignas(32) float scaleZs[kLaneCount]{};
+  for (size_t i = 0; i < laneCount; ++i) {
+    const size_t index = indices != nullptr ? indices[first + i] : first + i;
+    rotateXs[i]        = rotates[index].x;
+    rotateYs[i]        = rotates[index].y;
+    rotateZs[i]        = rotates[index].z;
+    scaleXs[i]         = scales[index].x;
+    scaleYs[i]         = scales[index].y;
+    scaleZs[i]         = scales[index].z;
+  }
+
+  // Calculating sines and cosines of rotation angles
+  const Float degreesToRadians = setFloat(kDegreesToRadians);
+  Float       s1{}, c1{}, s2{}, c2{}, s3{}, c3{};
+  calculateSinCos(mul(loadFloat(rotateXs), degreesToRadians), s1, c1);
+  calculateSinCos(mul(loadFloat(rotateYs), degreesToRadians), s2, c2);
+  calculateSinCos(mul(loadFloat(rotateZs), degreesToRadians), s3, c3);
+
+  // Composing scaled rotation columns (X * Y * Z rotation, the same as glm::eulerAngleXYZ)
+  const Float scaleX = loadFloat(scaleXs);
+  const Float scaleY = loadFloat(scaleYs);
+  const Float scaleZ = loadFloat(scaleZs);
+  const Float s1s2   = mul(s1, s2);
+  const Float c1s2   = mul(c1, s2);
+  alignas(32) float columns[9][kLaneCount]{};
+  storeFloat(columns[0], mul(mul(c2, c3), scaleX));
+  storeFloat(columns[1], mul(mulAdd(s1s2, c3, mul(c1, s3)), scaleX));
+  storeFloat(columns[2], mul(sub(mul(s1, s3), mul(c1s2, c3)), scaleX));
+  storeFloat(columns[3], mul(sub(setFloat(0.0f), mul(c2, s3)), scaleY));
+  storeFloat(columns[4], mul(sub(mul(c1, c3), mul(s1s2, s3)), scaleY));
+  storeFloat(columns[5], mul(mulAdd(c1s2, s3, mul(s1, c3)), scaleY));
+  storeFloat(columns[6], mul(s2, scaleZ));
+  storeFloat(columns[7], mul(sub(setFloat(0.0f), mul(s1, c2)), scaleZ));
+  storeFloat(columns[8], mul(mul(c1, c2), scaleZ));
+
+  // Scattering model matrices of objects
+  for (size_t i = 0; i < laneCount; ++i) {
+    const size_t index = indices != nullptr ? indices[first + i] : first + i;
+    glm::mat4   &modelMatrix = modelMatrices[index];
+    modelMatrix[0]           = glm::vec4{columns[0][i], columns[1][i], columns[2][i], 0.0f};
+    modelMatrix[1]           = glm::vec4{columns[3][i], columns[4][i], columns[5][i], 0.0f};
+    modelMatrix[2]           = glm::vec4{columns[6][i], columns[7][i], columns[8][i], 0.0f};
+    modelMatrix[3]           = glm::vec4{translates[index], 1.0f};
+  }
+}
+#else
+void composeLanes(const glm::vec3 *translates, const glm::vec3 *rotates, const glm::vec3 *scales,
+                  const size_t *indices, size_t first, size_t laneCount,
+                  glm::mat4 *modelMatrices) {
+  // For each object (one at a time)
+  for (size_t i = 0; i < laneCount; ++i) {
+    const size_t     index  = indices != nullptr ? indices[first + i] : first + i;
+    const glm::vec3 &rotate = rotates[index];
+    const glm::vec3 &scale  = scales[index];
+
+    // Calculating sines and cosines of rotation angles
+    const float s1 = std::sin(rotate.x * kDegreesToRadians);
+    const float c1 = std::cos(rotate.x * kDegreesToRadians);
+    const float s2 = std::sin(rotate.y * kDegreesToRadians);
+    const float c2 = std::cos(rotate.y * kDegreesToRadians);
+    const float s3 = std::sin(rotate.z * kDegreesToRadians);
+    const float c3 = std::cos(rotate.z * kDegreesToRadians);
+
+    // Composing scaled rotation columns (X * Y * Z rotation, the same as glm::eulerAngleXYZ)
+    glm::mat4 &modelMatrix = modelMatrices[index];
+    modelMatrix[0] = glm::vec4{c2 * c3, c1 * s3 + s1 * s2 * c3, s1 * s3 - c1 * s2 * c3, 0.0f} *
+                     scale.x;
+    modelMatrix[1] = glm::vec4{-c2 * s3, c1 * c3 - s1 * s2 * s3, s1 * c3 + c1 * s2 * s3, 0.0f} *
+                     scale.y;
+    modelMatrix[2] = glm::vec4{s2, -s1 * c2, c1 * c2, 0.0f} * scale.z;
+    modelMatrix[3] = glm::vec4{translates[index], 1.0f};
+  }
+}
+#endif
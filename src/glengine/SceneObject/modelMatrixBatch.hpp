@@ -0,0 +1,24 @@
+#ifndef GLENGINE_SCENEOBJECT_MODELMATRIXBATCH_HPP
+#define GLENGINE_SCENEOBJECT_MODELMATRIXBATCH_HPP
+
+// STD
+#include <cstddef>
+
+// GLM
+#include <glm/glm.hpp>
+
+namespace glengine {
+
+// Composes model matrices (translate * XYZ Euler angles rotate in degrees * scale) of objects
+// given by indices (or of the first count objects if indices is nullptr) from parallel arrays,
+// several objects at once with SIMD instructions the compiler targets
+void composeModelMatrices(const glm::vec3 *translates, const glm::vec3 *rotates,
+                          const glm::vec3 *scales, const size_t *indices, size_t count,
+                          glm::mat4 *modelMatrices) noexcept;
+
+// Gets instruction set model matrices are composed with ("AVX2", "SSE2" or "scalar")
+const char *getModelMatrixBatchInstructionSet() noexcept;
+
+}  // namespace glengine
+
+#endif
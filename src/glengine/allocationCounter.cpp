@@ -0,0 +1,47 @@
+// Header file
+#include "./allocationCounter.hpp"
+
+// STD
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Local function headers
+static std::atomic<size_t> &getMutableAllocationCount() noexcept;
+
+// Checks if heap allocations are counted
+bool glengine::isAllocationCountingEnabled() noexcept {
+#ifdef GLENGINE_COUNT_ALLOCATIONS
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Gets count of heap allocations since the start
+size_t glengine::getAllocationCount() noexcept {
+  return getMutableAllocationCount().load(std::memory_order_relaxed);
+}
+
+#ifdef GLENGINE_COUNT_ALLOCATIONS
+// Replacement of global operator new counting allocations (array and non-throwing versions
+// call this one, while over-aligned allocations are left uncounted)
+void *operator new(std::size_t size) {
+  getMutableAllocationCount().fetch_add(1, std::memory_order_relaxed);
+
+  // Allocating at least a byte, so every allocation has a unique address
+  if (void *ptr = std::malloc(size > 0 ? size : 1)) return ptr;
+  throw std::bad_alloc{};
+}
+
+// Replacements of global operator delete matching operator new
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+// Local function definitions
+
+std::atomic<size_t> &getMutableAllocationCount() noexcept {
+  static std::atomic<size_t> sAllocationCount{};
+  return sAllocationCount;
+}
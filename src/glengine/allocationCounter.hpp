@@ -0,0 +1,20 @@
+#ifndef GLENGINE_ALLOCATIONCOUNTER_HPP
+#define GLENGINE_ALLOCATIONCOUNTER_HPP
+
+// STD
+#include <cstddef>
+
+namespace glengine {
+
+// Checks if heap allocations are counted (only in programs compiled with
+// GLENGINE_COUNT_ALLOCATIONS defined, since counting replaces global operator new and delete,
+// which would also bypass new and delete checks of sanitizers)
+bool isAllocationCountingEnabled() noexcept;
+
+// Gets count of heap allocations (global operator new calls of all the threads) since the start
+// (always zero if allocations are not counted)
+size_t getAllocationCount() noexcept;
+
+}  // namespace glengine
+
+#endif
@@ -0,0 +1,473 @@
+// Header file
+#include "./TextureLoader.hpp"
+
+// STD
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+// STB
+#include <stb/stb_image.h>
+
+// "glengine" internal library
+#include "./filesystem.hpp"
+
+using namespace glengine;
+
+// Local function headers
+static GLenum getPixelFormat(int componentCount) noexcept;
+static size_t getImageByteCount(int width, int height, int componentCount, bool isHDR) noexcept;
+
+// Constructors, assignment operators and destructor
+
+// Parameterized constructor (zero worker count means one worker per hardware thread)
+TextureLoader::TextureLoader(unsigned int workerCount, size_t uploadRingSize) noexcept
+    : _uploadRing{uploadRingSize} {
+  if (workerCount == 0) workerCount = std::thread::hardware_concurrency();
+  if (workerCount == 0) workerCount = 1;
+
+  // Starting worker threads
+  for (unsigned int i = 0; i < workerCount; ++i) {
+    _workers.push_back(std::thread{&TextureLoader::work, this});
+  }
+}
+
+// Destructor
+TextureLoader::~TextureLoader() noexcept {
+  // Waking up worker threads and waiting for them to stop
+  {
+    std::lock_guard lock{_mutex};
+    _isRunning = false;
+  }
+  _taskCondition.notify_all();
+  for (size_t i = 0; i < _workers.size(); ++i) {
+    _workers[i].join();
+  }
+
+  // Freeing image memory of jobs that were never uploaded (textures keep their placeholders)
+  std::vector<std::shared_ptr<Job>> jobPtrs{_decodedJobs.begin(), _decodedJobs.end()};
+  for (size_t i = 0; i < _tasks.size(); ++i) {
+    jobPtrs.push_back(_tasks[i].jobPtr);
+  }
+  for (size_t i = 0; i < jobPtrs.size(); ++i) {
+    std::vector<Image> &images = jobPtrs[i]->images;
+    for (size_t j = 0; j < images.size(); ++j) {
+      stbi_image_free(std::exchange(images[j].data, nullptr));
+    }
+  }
+}
+
+// Setters
+
+void TextureLoader::setUploadBudget(size_t uploadBudget) noexcept { _uploadBudget = uploadBudget; }
+
+void TextureLoader::setCompressedCacheEnabled(bool isCompressedCacheEnabled) noexcept {
+  _isCompressedCacheEnabled = isCompressedCacheEnabled;
+}
+
+// Getters
+
+size_t TextureLoader::getUploadBudget() const noexcept { return _uploadBudget; }
+
+size_t TextureLoader::getWorkerCount() const noexcept { return _workers.size(); }
+
+bool TextureLoader::isCompressedCacheEnabled() const noexcept { return _isCompressedCacheEnabled; }
+
+TextureLoaderStats TextureLoader::getStats() const {
+  std::lock_guard lock{_mutex};
+  return _stats;
+}
+
+bool TextureLoader::isIdle() const {
+  std::lock_guard lock{_mutex};
+  return _stats.pendingTextureCount == 0;
+}
+
+// Other member functions
+
+// Loads 2D texture asynchronously
+GLuint TextureLoader::loadMap2D(const std::string &filename, bool sRGB,
+                                const glm::vec4 &placeholderColor) {
+  return enqueue(GL_TEXTURE_2D, std::vector<std::string>{filename}, false, sRGB,
+                 placeholderColor);
+}
+
+// Loads HDR 2D texture asynchronously
+GLuint TextureLoader::loadMap2DHDR(const std::string &filename,
+                                   const glm::vec4   &placeholderColor) {
+  return enqueue(GL_TEXTURE_2D, std::vector<std::string>{filename}, true, false,
+                 placeholderColor);
+}
+
+// Loads cubemap asynchronously
+GLuint TextureLoader::loadMapCube(const std::vector<std::string> &filenames, bool sRGB,
+                                  const glm::vec4 &placeholderColor) {
+  if (filenames.size() != 6) {
+    return 0;
+  }
+
+  return enqueue(GL_TEXTURE_CUBE_MAP, filenames, false, sRGB, placeholderColor);
+}
+
+// Loads HDR cubemap asynchronously
+GLuint TextureLoader::loadMapCubeHDR(const std::vector<std::string> &filenames,
+                                     const glm::vec4                &placeholderColor) {
+  if (filenames.size() != 6) {
+    return 0;
+  }
+
+  return enqueue(GL_TEXTURE_CUBE_MAP, filenames, true, false, placeholderColor);
+}
+
+// Uploads decoded textures within the upload budget (must be called on the render thread)
+size_t TextureLoader::processUploads() {
+  size_t uploadedByteCount{};
+  size_t uploadedCount{};
+
+  // Reclaiming upload ring space which GPU has finished reading
+  _uploadRing.reclaim();
+
+  // While there are decoded jobs
+  while (true) {
+    std::shared_ptr<Job> jobPtr{};
+    size_t               jobByteCount{};
+    {
+      std::lock_guard lock{_mutex};
+      if (_decodedJobs.empty()) break;
+
+      // Counting bytes of job images
+      jobByteCount = getJobByteCount(*_decodedJobs.front());
+
+      // If budget is exceeded (at least one job is uploaded per frame to make progress)
+      if (uploadedCount > 0 && uploadedByteCount + jobByteCount > _uploadBudget) break;
+
+      jobPtr = std::move(_decodedJobs.front());
+      _decodedJobs.pop_front();
+    }
+
+    // Uploading job images (workers never touch fully decoded jobs)
+    bool isUploaded = upload(*jobPtr);
+
+    std::lock_guard lock{_mutex};
+
+    // If upload ring has no free space yet (job is retried on the next processing)
+    if (!isUploaded) {
+      _decodedJobs.push_front(std::move(jobPtr));
+      break;
+    }
+
+    uploadedByteCount += jobByteCount;
+    ++uploadedCount;
+    --_stats.pendingTextureCount;
+    if (jobPtr->hasFailed) {
+      ++_stats.failedTextureCount;
+    } else {
+      ++_stats.uploadedTextureCount;
+    }
+    if (jobPtr->isCompressed) ++_stats.cachedTextureCount;
+    if (jobPtr->isCacheWritten) ++_stats.compressedTextureCount;
+  }
+
+  // Fencing upload ring space used by this processing
+  _uploadRing.fence();
+
+  std::lock_guard lock{_mutex};
+  _stats.uploadedByteCount = uploadedByteCount;
+  _stats.ringUsedByteCount = _uploadRing.getUsedByteCount();
+
+  return uploadedCount;
+}
+
+GLuint TextureLoader::enqueue(GLenum target, const std::vector<std::string> &filenames, bool isHDR,
+                              bool sRGB, const glm::vec4 &placeholderColor) {
+  // Creating texture
+  GLuint texture{};
+  glGenTextures(1, &texture);
+
+  // Binding texture
+  glBindTexture(target, texture);
+
+  // Filling texture with 1x1 placeholder
+  GLenum        iformat = (isHDR ? GL_RGBA16F : (sRGB ? GL_SRGB_ALPHA : GL_RGBA));
+  unsigned char placeholderImage[4]{};
+  for (int i = 0; i < 4; ++i) {
+    placeholderImage[i] =
+        static_cast<unsigned char>(glm::clamp(placeholderColor[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+  }
+  if (target == GL_TEXTURE_CUBE_MAP) {
+    for (size_t i = 0; i < filenames.size(); ++i) {
+      glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, iformat, 1, 1, 0, GL_RGBA,
+                   GL_UNSIGNED_BYTE, placeholderImage);
+    }
+  } else {
+    glTexImage2D(target, 0, iformat, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholderImage);
+  }
+
+  // Configuring texture (mip-mapped filtering is enabled after upload)
+  if (target == GL_TEXTURE_CUBE_MAP) {
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+  } else {
+    glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_REPEAT);
+  }
+  glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  // Unbinding texture
+  glBindTexture(target, 0);
+
+  // Creating job (absolute paths are resolved here since workers have no Qt application access)
+  std::shared_ptr<Job> jobPtr = std::make_shared<Job>();
+  jobPtr->texture             = texture;
+  jobPtr->target              = target;
+  jobPtr->isHDR               = isHDR;
+  jobPtr->sRGB                = sRGB;
+  jobPtr->images.resize(filenames.size());
+  for (size_t i = 0; i < filenames.size(); ++i) {
+    jobPtr->filenames.push_back(glengine::getAbsolutePathRelativeToExecutable(filenames[i]));
+  }
+
+  // Reading compressed texture instead of decoding images if it is newer than them
+  jobPtr->isCompressed = _isCompressedCacheEnabled && isCompressedTextureFresh(jobPtr->filenames);
+  jobPtr->taskCount    = (jobPtr->isCompressed ? 1 : filenames.size());
+
+  // Queueing decode task per image (cubemap faces are decoded in parallel)
+  {
+    std::lock_guard lock{_mutex};
+    for (size_t i = 0; i < jobPtr->taskCount; ++i) {
+      _tasks.push_back(Task{jobPtr, i});
+    }
+    ++_stats.pendingTextureCount;
+  }
+  _taskCondition.notify_all();
+
+  return texture;
+}
+
+void TextureLoader::work() {
+  // Flipping images for this thread only (global flag is not thread-safe)
+  stbi_set_flip_vertically_on_load_thread(true);
+
+  // While loader is running
+  while (true) {
+    // Waiting for task or stop request
+    Task task{};
+    {
+      std::unique_lock lock{_mutex};
+      _taskCondition.wait(lock, [this]() { return !_isRunning || !_tasks.empty(); });
+      if (!_isRunning) return;
+
+      task = std::move(_tasks.front());
+      _tasks.pop_front();
+    }
+
+    Job &job = *task.jobPtr;
+
+    // If compressed texture is read
+    if (job.isCompressed) {
+      bool isRead = readCompressedTexture(job.filenames, job.compressedTexture);
+
+      std::lock_guard lock{_mutex};
+
+      // If compressed texture is corrupted (falling back to decoding images)
+      if (!isRead) {
+        job.isCompressed = false;
+        job.taskCount    = job.images.size();
+        for (size_t i = 0; i < job.taskCount; ++i) {
+          _tasks.push_back(Task{task.jobPtr, i});
+        }
+        _taskCondition.notify_all();
+        continue;
+      }
+
+      _decodedJobs.push_back(std::move(task.jobPtr));
+      continue;
+    }
+
+    // Loading texture image
+    const std::string &filename = job.filenames[task.imageIndex];
+    Image              image{};
+    if (job.isHDR) {
+      image.data =
+          stbi_loadf(filename.c_str(), &image.width, &image.height, &image.componentCount, 0);
+    } else {
+      image.data =
+          stbi_load(filename.c_str(), &image.width, &image.height, &image.componentCount, 0);
+    }
+
+    std::lock_guard lock{_mutex};
+
+    if (image.data == nullptr) {
+      std::cout << "error: failed to load image " << filename << std::endl;
+      job.hasFailed = true;
+    }
+    job.images[task.imageIndex] = image;
+
+    // If all the job images are decoded
+    if (++job.decodedCount == job.taskCount) {
+      _decodedJobs.push_back(std::move(task.jobPtr));
+    }
+  }
+}
+
+bool TextureLoader::upload(Job &job) {
+  // If compressed texture is uploaded
+  if (job.isCompressed) return uploadCompressed(job);
+
+  // If any image failed to decode (texture keeps its placeholder)
+  if (job.hasFailed) {
+    for (size_t i = 0; i < job.images.size(); ++i) {
+      stbi_image_free(std::exchange(job.images[i].data, nullptr));
+    }
+    return true;
+  }
+
+  // Allocating upload ring space (jobs larger than the whole ring are uploaded from client memory)
+  size_t         ringOffset{};
+  unsigned char *ringPtr{};
+  size_t         jobByteCount = getJobByteCount(job);
+  if (_uploadRing.map() && jobByteCount <= _uploadRing.getSize()) {
+    ringPtr = static_cast<unsigned char *>(_uploadRing.allocate(jobByteCount, ringOffset));
+    if (ringPtr == nullptr) return false;
+  }
+
+  // Binding texture and upload ring
+  glBindTexture(job.target, job.texture);
+  if (ringPtr != nullptr) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _uploadRing.getPBO());
+
+  // Filling texture with image data
+  GLenum iformat = (job.isHDR ? GL_RGBA16F : (job.sRGB ? GL_SRGB_ALPHA : GL_RGBA));
+  for (size_t i = 0; i < job.images.size(); ++i) {
+    Image &image = job.images[i];
+    GLenum imageTarget =
+        (job.target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + i : job.target);
+
+    // Copying image into upload ring (GPU reads it asynchronously from the ring offset)
+    const void *pixels = image.data;
+    if (ringPtr != nullptr) {
+      size_t imageByteCount =
+          getImageByteCount(image.width, image.height, image.componentCount, job.isHDR);
+      std::memcpy(ringPtr, image.data, imageByteCount);
+      pixels      = reinterpret_cast<const void *>(ringOffset);
+      ringPtr    += imageByteCount;
+      ringOffset += imageByteCount;
+    }
+
+    glTexImage2D(imageTarget, 0, iformat, image.width, image.height, 0,
+                 getPixelFormat(image.componentCount), (job.isHDR ? GL_FLOAT : GL_UNSIGNED_BYTE),
+                 pixels);
+    // Freeing texture image memory
+    stbi_image_free(std::exchange(image.data, nullptr));
+  }
+
+  // Unbinding upload ring
+  if (ringPtr != nullptr) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  // Generating mip-maps (on GPU after the copy from upload ring)
+  if (job.target == GL_TEXTURE_2D) {
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  }
+
+  // Unbinding texture
+  glBindTexture(job.target, 0);
+
+  // Writing compressed texture for the next launches (reads texture back, so stalls once)
+  if (_isCompressedCacheEnabled) {
+    job.isCacheWritten = writeCompressedTexture(job.texture, job.target,
+                                                job.images[0].componentCount, job.isHDR,
+                                                job.sRGB, job.filenames);
+  }
+
+  return true;
+}
+
+bool TextureLoader::uploadCompressed(Job &job) {
+  const CompressedTexture &compressedTexture = job.compressedTexture;
+
+  // Allocating upload ring space (jobs larger than the whole ring are uploaded from client memory)
+  size_t         ringOffset{};
+  unsigned char *ringPtr{};
+  if (_uploadRing.map() && compressedTexture.data.size() <= _uploadRing.getSize()) {
+    ringPtr = static_cast<unsigned char *>(
+        _uploadRing.allocate(compressedTexture.data.size(), ringOffset));
+    if (ringPtr == nullptr) return false;
+
+    // Copying compressed texture into upload ring
+    std::memcpy(ringPtr, compressedTexture.data.data(), compressedTexture.data.size());
+  }
+
+  // Binding texture and upload ring
+  glBindTexture(job.target, job.texture);
+  if (ringPtr != nullptr) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _uploadRing.getPBO());
+
+  // Filling texture with prebuilt mip-maps of each face
+  const GLenum firstFaceTarget =
+      (job.target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : job.target);
+  for (int level = 0; level < compressedTexture.levelCount; ++level) {
+    for (int face = 0; face < compressedTexture.faceCount; ++face) {
+      const size_t imageIndex  = level * compressedTexture.faceCount + face;
+      const size_t imageOffset = compressedTexture.imageOffsets[imageIndex];
+      const void  *pixels =
+          (ringPtr != nullptr ? reinterpret_cast<const void *>(ringOffset + imageOffset)
+                              : compressedTexture.data.data() + imageOffset);
+      glCompressedTexImage2D(firstFaceTarget + face, level, compressedTexture.internalFormat,
+                             std::max(compressedTexture.width >> level, 1),
+                             std::max(compressedTexture.height >> level, 1), 0,
+                             compressedTexture.imageByteCounts[imageIndex], pixels);
+    }
+  }
+
+  // Unbinding upload ring
+  if (ringPtr != nullptr) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  // Enabling mip-mapped filtering if there are mip-maps
+  glTexParameteri(job.target, GL_TEXTURE_MAX_LEVEL, compressedTexture.levelCount - 1);
+  if (compressedTexture.levelCount > 1) {
+    glTexParameteri(job.target, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+  }
+
+  // Unbinding texture
+  glBindTexture(job.target, 0);
+
+  // Freeing compressed texture memory
+  job.compressedTexture.data = std::vector<unsigned char>{};
+
+  return true;
+}
+
+// Other static member functions
+
+size_t TextureLoader::getJobByteCount(const Job &job) noexcept {
+  if (job.isCompressed) return job.compressedTexture.data.size();
+
+  size_t jobByteCount{};
+  for (size_t i = 0; i < job.images.size(); ++i) {
+    jobByteCount += getImageByteCount(job.images[i].width, job.images[i].height,
+                                      job.images[i].componentCount, job.isHDR);
+  }
+  return jobByteCount;
+}
+
+// Local function definitions
+
+static GLenum getPixelFormat(int componentCount) noexcept {
+  switch (componentCount) {
+    case 1:
+      return GL_RED;
+    case 2:
+      return GL_RG;
+    case 3:
+      return GL_RGB;
+    default:
+      return GL_RGBA;
+  }
+}
+
+static size_t getImageByteCount(int width, int height, int componentCount, bool isHDR) noexcept {
+  return static_cast<size_t>(width) * static_cast<size_t>(height) *
+         static_cast<size_t>(componentCount) * (isHDR ? sizeof(float) : sizeof(unsigned char));
+}
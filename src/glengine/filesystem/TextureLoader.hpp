@@ -0,0 +1,136 @@
+#ifndef GLENGINE_FILESYSTEM_TEXTURELOADER_HPP
+#define GLENGINE_FILESYSTEM_TEXTURELOADER_HPP
+
+// STD
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// OpenGL
+#include <glad/glad.h>
+
+// GLM
+#include <glm/glm.hpp>
+
+// "glengine" internal library
+#include "./TextureUploadRing.hpp"
+#include "./textureCache.hpp"
+
+namespace glengine {
+
+// Texture loader statistics struct
+struct TextureLoaderStats {
+  size_t pendingTextureCount{};     // textures that are still decoding or waiting for upload
+  size_t uploadedTextureCount{};    // textures uploaded since the start
+  size_t failedTextureCount{};      // textures whose images failed to decode
+  size_t uploadedByteCount{};       // bytes uploaded during the last processing
+  size_t ringUsedByteCount{};       // bytes of upload ring which GPU has not finished reading
+  size_t cachedTextureCount{};      // textures loaded from compressed texture cache
+  size_t compressedTextureCount{};  // textures written to compressed texture cache
+};
+
+// Asynchronous texture loader class (a pool of worker threads decodes images in parallel
+// without OpenGL context, while decoded images are streamed on the render thread through
+// persistently mapped upload ring within a byte budget per frame; textures show
+// a 1x1 placeholder until their upload finishes; BCn compressed copies of textures are cached
+// next to source images and read instead of decoding them while they are newer than sources)
+class TextureLoader {
+ public:
+  // Default upload budget in bytes per frame
+  static constexpr size_t kDefaultUploadBudget = 16 * 1024 * 1024;
+  // Default placeholder color (normal maps should rather use flat normal {0.5, 0.5, 1.0, 1.0})
+  static inline const glm::vec4 kDefaultPlaceholderColor{0.5f, 0.5f, 0.5f, 1.0f};
+
+ private:
+  // Decoded image struct
+  struct Image {
+    int   width{};
+    int   height{};
+    int   componentCount{};
+    void *data{};
+  };
+
+  // Texture load job struct (one job per texture, one decode task per image
+  // or a single read task if compressed texture cache is fresh)
+  struct Job {
+    GLuint                   texture{};
+    GLenum                   target{};
+    bool                     isHDR{};
+    bool                     sRGB{};
+    std::vector<std::string> filenames{};
+    std::vector<Image>       images{};
+    CompressedTexture        compressedTexture{};
+    bool                     isCompressed{};
+    bool                     isCacheWritten{};
+    size_t                   taskCount{};
+    size_t                   decodedCount{};
+    bool                     hasFailed{};
+  };
+
+  // Decode task struct
+  struct Task {
+    std::shared_ptr<Job> jobPtr{};
+    size_t               imageIndex{};
+  };
+
+  std::deque<Task>                 _tasks{};
+  std::deque<std::shared_ptr<Job>> _decodedJobs{};
+  std::vector<std::thread>         _workers{};
+  mutable std::mutex               _mutex{};
+  std::condition_variable          _taskCondition{};
+  bool                             _isRunning{true};
+  size_t                           _uploadBudget{kDefaultUploadBudget};
+  bool                             _isCompressedCacheEnabled{true};
+  TextureLoaderStats               _stats{};
+  TextureUploadRing                _uploadRing;
+
+ public:
+  // Constructors, assignment operators and destructor
+  explicit TextureLoader(unsigned int workerCount = 0,
+                         size_t       uploadRingSize = TextureUploadRing::kDefaultSize) noexcept;
+  TextureLoader(const TextureLoader &textureLoader)            = delete;
+  TextureLoader &operator=(const TextureLoader &textureLoader) = delete;
+  TextureLoader(TextureLoader &&textureLoader)                 = delete;
+  TextureLoader &operator=(TextureLoader &&textureLoader)      = delete;
+  ~TextureLoader() noexcept;
+
+  // Setters
+  void setUploadBudget(size_t uploadBudget) noexcept;
+  void setCompressedCacheEnabled(bool isCompressedCacheEnabled) noexcept;
+
+  // Getters
+  size_t             getUploadBudget() const noexcept;
+  size_t             getWorkerCount() const noexcept;
+  bool               isCompressedCacheEnabled() const noexcept;
+  TextureLoaderStats getStats() const;
+  bool               isIdle() const;
+
+  // Other member functions
+  GLuint loadMap2D(const std::string &filename, bool sRGB,
+                   const glm::vec4 &placeholderColor = kDefaultPlaceholderColor);
+  GLuint loadMap2DHDR(const std::string &filename,
+                      const glm::vec4   &placeholderColor = kDefaultPlaceholderColor);
+  GLuint loadMapCube(const std::vector<std::string> &filenames, bool sRGB,
+                     const glm::vec4 &placeholderColor = kDefaultPlaceholderColor);
+  GLuint loadMapCubeHDR(const std::vector<std::string> &filenames,
+                        const glm::vec4 &placeholderColor = kDefaultPlaceholderColor);
+
+  size_t processUploads();
+
+ private:
+  GLuint enqueue(GLenum target, const std::vector<std::string> &filenames, bool isHDR, bool sRGB,
+                 const glm::vec4 &placeholderColor);
+  void   work();
+  bool   upload(Job &job);
+  bool   uploadCompressed(Job &job);
+
+  static size_t getJobByteCount(const Job &job) noexcept;
+};
+
+}  // namespace glengine
+
+#endif
@@ -0,0 +1,108 @@
+// Header file
+#include "./TextureUploadRing.hpp"
+
+// STD
+#include <iostream>
+
+using namespace glengine;
+
+// Global constants
+static constexpr size_t kRegionAlignment = 16;
+
+// Constructors, assignment operators and destructor
+
+// Parameterized constructor (buffer is created on the first allocation on the render thread)
+TextureUploadRing::TextureUploadRing(size_t size) noexcept : _size{size} {}
+
+// Destructor
+TextureUploadRing::~TextureUploadRing() noexcept {
+  for (size_t i = 0; i < _regions.size(); ++i) {
+    glDeleteSync(_regions[i].fence);
+  }
+
+  // Deleting buffer (it is unmapped implicitly)
+  if (_pbo != 0) glDeleteBuffers(1, &_pbo);
+}
+
+// Getters
+
+size_t TextureUploadRing::getSize() const noexcept { return _size; }
+
+size_t TextureUploadRing::getUsedByteCount() const noexcept { return _usedByteCount; }
+
+GLuint TextureUploadRing::getPBO() const noexcept { return _pbo; }
+
+// Other member functions
+
+// Maps buffer on the first call (returns false if persistent mapping is unavailable)
+bool TextureUploadRing::map() noexcept {
+  // If buffer is already mapped or it was created and mapping failed
+  if (_mappedPtr != nullptr) return true;
+  if (_pbo != 0) return false;
+
+  // Creating immutable buffer storage and mapping it for the whole buffer lifetime
+  constexpr GLbitfield kMapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  glGenBuffers(1, &_pbo);
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pbo);
+  glBufferStorage(GL_PIXEL_UNPACK_BUFFER, _size, nullptr, kMapFlags);
+  _mappedPtr =
+      static_cast<unsigned char *>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, _size, kMapFlags));
+  glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+  if (_mappedPtr == nullptr) {
+    std::cout << "error: unable to map texture upload ring, falling back to client memory"
+              << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+// Allocates ring space (returns nullptr if GPU still reads the space or it is too large)
+void *TextureUploadRing::allocate(size_t byteCount, size_t &offset) noexcept {
+  // If buffer cannot be mapped or allocation never fits
+  if (!map() || byteCount > _size) return nullptr;
+
+  // Aligning allocation start (wrapping to the ring start if allocation does not fit till the end)
+  size_t alignedHead       = (_head + kRegionAlignment - 1) / kRegionAlignment * kRegionAlignment;
+  size_t requiredByteCount = alignedHead - _head + byteCount;
+  if (alignedHead + byteCount > _size) {
+    alignedHead       = 0;
+    requiredByteCount = _size - _head + byteCount;
+  }
+
+  // If not enough space was reclaimed yet
+  if (_usedByteCount + requiredByteCount > _size) return nullptr;
+
+  _usedByteCount     += requiredByteCount;
+  _unfencedByteCount += requiredByteCount;
+  _head               = alignedHead + byteCount;
+
+  offset = alignedHead;
+  return _mappedPtr + alignedHead;
+}
+
+// Fences all the space allocated since the previous fence (call after issuing uploads from it)
+void TextureUploadRing::fence() noexcept {
+  // If nothing was allocated
+  if (_unfencedByteCount == 0) return;
+
+  _regions.push_back(Region{_unfencedByteCount, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)});
+  _unfencedByteCount = 0;
+}
+
+// Reclaims space of regions which GPU has finished reading (never waits for GPU)
+void TextureUploadRing::reclaim() noexcept {
+  // While the oldest region is read by GPU
+  while (!_regions.empty()) {
+    GLenum waitResult = glClientWaitSync(_regions.front().fence, 0, 0);
+    if (waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED) break;
+
+    glDeleteSync(_regions.front().fence);
+    _usedByteCount -= _regions.front().byteCount;
+    _regions.pop_front();
+  }
+
+  // Rewinding empty ring so that the next allocations do not wrap
+  if (_usedByteCount == 0) _head = 0;
+}
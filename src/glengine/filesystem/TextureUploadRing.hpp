@@ -0,0 +1,58 @@
+#ifndef GLENGINE_FILESYSTEM_TEXTUREUPLOADRING_HPP
+#define GLENGINE_FILESYSTEM_TEXTUREUPLOADRING_HPP
+
+// STD
+#include <cstddef>
+#include <deque>
+
+// OpenGL
+#include <glad/glad.h>
+
+namespace glengine {
+
+// Texture upload ring class (persistently mapped pixel unpack buffer which pixels are copied into
+// on CPU and which GPU reads asynchronously; space is reclaimed once fences of uploads signal)
+class TextureUploadRing {
+ public:
+  // Default ring size in bytes
+  static constexpr size_t kDefaultSize = 64 * 1024 * 1024;
+
+ private:
+  // Fenced ring region struct (all the space allocated between two fences)
+  struct Region {
+    size_t byteCount{};
+    GLsync fence{};
+  };
+
+  size_t             _size{};
+  GLuint             _pbo{};
+  unsigned char     *_mappedPtr{};
+  size_t             _head{};
+  size_t             _usedByteCount{};
+  size_t             _unfencedByteCount{};
+  std::deque<Region> _regions{};
+
+ public:
+  // Constructors, assignment operators and destructor
+  explicit TextureUploadRing(size_t size = kDefaultSize) noexcept;
+  TextureUploadRing(const TextureUploadRing &textureUploadRing)            = delete;
+  TextureUploadRing &operator=(const TextureUploadRing &textureUploadRing) = delete;
+  TextureUploadRing(TextureUploadRing &&textureUploadRing)                 = delete;
+  TextureUploadRing &operator=(TextureUploadRing &&textureUploadRing)      = delete;
+  ~TextureUploadRing() noexcept;
+
+  // Getters
+  size_t getSize() const noexcept;
+  size_t getUsedByteCount() const noexcept;
+  GLuint getPBO() const noexcept;
+
+  // Other member functions
+  bool  map() noexcept;
+  void *allocate(size_t byteCount, size_t &offset) noexcept;
+  void  fence() noexcept;
+  void  reclaim() noexcept;
+};
+
+}  // namespace glengine
+
+#endif
@@ -0,0 +1,202 @@
+// Header file
+#include "./textureCache.hpp"
+
+// STD
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+// Qt5
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QString>
+
+// Global constants
+static const std::string kCompressedTextureExtension{".bcn"};
+
+static constexpr uint32_t kCompressedTextureMagic       = 0x314E4342;  // "BCN1"
+static constexpr size_t   kCompressedTextureHeaderCount = 6;
+
+// Local function headers
+static void appendUint32(QByteArray &byteArray, uint32_t value);
+
+// Gets BCn internal format for image (BC4/BC5 for 1/2 components, BC7 for LDR, BC6H for HDR)
+GLenum glengine::getCompressedInternalFormat(int componentCount, bool isHDR, bool sRGB) noexcept {
+  if (isHDR) return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+  if (sRGB) return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+
+  switch (componentCount) {
+    case 1:
+      return GL_COMPRESSED_RED_RGTC1;
+    case 2:
+      return GL_COMPRESSED_RG_RGTC2;
+    default:
+      return GL_COMPRESSED_RGBA_BPTC_UNORM;
+  }
+}
+
+// Gets compressed texture filename (stored next to the first source image)
+std::string glengine::getCompressedTextureFilename(
+    const std::vector<std::string> &absoluteFilenames) {
+  if (absoluteFilenames.empty()) return std::string{};
+
+  return absoluteFilenames[0] + kCompressedTextureExtension;
+}
+
+// Checks if compressed texture exists and is newer than all of its source images
+bool glengine::isCompressedTextureFresh(const std::vector<std::string> &absoluteFilenames) {
+  QFileInfo compressedFileInfo{QString{getCompressedTextureFilename(absoluteFilenames).c_str()}};
+  if (absoluteFilenames.empty() || !compressedFileInfo.exists()) return false;
+
+  // For each source image
+  for (size_t i = 0; i < absoluteFilenames.size(); ++i) {
+    QFileInfo sourceFileInfo{QString{absoluteFilenames[i].c_str()}};
+    if (!(compressedFileInfo.lastModified() > sourceFileInfo.lastModified())) return false;
+  }
+
+  return true;
+}
+
+// Reads compressed texture of source images (does not need OpenGL context)
+bool glengine::readCompressedTexture(const std::vector<std::string> &absoluteFilenames,
+                                     CompressedTexture              &compressedTexture) {
+  // Reading compressed texture file
+  QFile compressedFile{QString{getCompressedTextureFilename(absoluteFilenames).c_str()}};
+  if (!compressedFile.open(QFile::ReadOnly)) return false;
+  QByteArray compressedFileData{compressedFile.readAll()};
+
+  const char  *readPtr = compressedFileData.constData();
+  const size_t size    = static_cast<size_t>(compressedFileData.size());
+  size_t       offset{};
+
+  // Reading header (magic, internal format, width, height, face count and level count)
+  uint32_t header[kCompressedTextureHeaderCount]{};
+  if (size < sizeof(header)) return false;
+  std::memcpy(header, readPtr, sizeof(header));
+  offset += sizeof(header);
+  if (header[0] != kCompressedTextureMagic) return false;
+
+  compressedTexture.internalFormat = static_cast<GLenum>(header[1]);
+  compressedTexture.width          = static_cast<int>(header[2]);
+  compressedTexture.height         = static_cast<int>(header[3]);
+  compressedTexture.faceCount      = static_cast<int>(header[4]);
+  compressedTexture.levelCount     = static_cast<int>(header[5]);
+  compressedTexture.imageOffsets.clear();
+  compressedTexture.imageByteCounts.clear();
+  compressedTexture.data.clear();
+
+  // For each image (level by level, face by face)
+  const int imageCount = compressedTexture.faceCount * compressedTexture.levelCount;
+  for (int i = 0; i < imageCount; ++i) {
+    // Reading image size
+    uint32_t imageByteCount{};
+    if (offset + sizeof(imageByteCount) > size) return false;
+    std::memcpy(&imageByteCount, readPtr + offset, sizeof(imageByteCount));
+    offset += sizeof(imageByteCount);
+
+    // Reading image
+    if (offset + imageByteCount > size) return false;
+    compressedTexture.imageOffsets.push_back(compressedTexture.data.size());
+    compressedTexture.imageByteCounts.push_back(imageByteCount);
+    compressedTexture.data.insert(compressedTexture.data.end(), readPtr + offset,
+                                  readPtr + offset + imageByteCount);
+    offset += imageByteCount;
+  }
+
+  return imageCount > 0;
+}
+
+// Compresses all the mip-map levels of texture by driver and writes them next to source images
+bool glengine::writeCompressedTexture(GLuint texture, GLenum target, int componentCount,
+                                      bool isHDR, bool sRGB,
+                                      const std::vector<std::string> &absoluteFilenames) {
+  const GLenum internalFormat = getCompressedInternalFormat(componentCount, isHDR, sRGB);
+  const GLenum type           = (isHDR ? GL_FLOAT : GL_UNSIGNED_BYTE);
+  const size_t pixelByteCount = 4 * (isHDR ? sizeof(float) : sizeof(unsigned char));
+  const int    faceCount      = (target == GL_TEXTURE_CUBE_MAP ? 6 : 1);
+  const GLenum firstFaceTarget =
+      (target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X : target);
+
+  // Getting texture size and mip-map level count
+  GLint width{}, height{};
+  glBindTexture(target, texture);
+  glGetTexLevelParameteriv(firstFaceTarget, 0, GL_TEXTURE_WIDTH, &width);
+  glGetTexLevelParameteriv(firstFaceTarget, 0, GL_TEXTURE_HEIGHT, &height);
+  int levelCount = 1;
+  if (target == GL_TEXTURE_2D) {
+    while ((std::max(width, height) >> levelCount) > 0) ++levelCount;
+  }
+
+  // Creating temporary texture and compressing each image of texture into it by driver
+  GLuint compressedTexture{};
+  glGenTextures(1, &compressedTexture);
+  std::vector<unsigned char> pixels{};
+  for (int level = 0; level < levelCount; ++level) {
+    const GLsizei levelWidth  = std::max(width >> level, 1);
+    const GLsizei levelHeight = std::max(height >> level, 1);
+    pixels.resize(static_cast<size_t>(levelWidth) * static_cast<size_t>(levelHeight) *
+                  pixelByteCount);
+
+    for (int face = 0; face < faceCount; ++face) {
+      glBindTexture(target, texture);
+      glGetTexImage(firstFaceTarget + face, level, GL_RGBA, type, pixels.data());
+      glBindTexture(target, compressedTexture);
+      glTexImage2D(firstFaceTarget + face, level, internalFormat, levelWidth, levelHeight, 0,
+                   GL_RGBA, type, pixels.data());
+    }
+  }
+
+  // If driver has not compressed texture
+  GLint isCompressed{};
+  glGetTexLevelParameteriv(firstFaceTarget, 0, GL_TEXTURE_COMPRESSED, &isCompressed);
+  if (isCompressed == GL_FALSE) {
+    glBindTexture(target, 0);
+    glDeleteTextures(1, &compressedTexture);
+    return false;
+  }
+
+  // Getting compressed images (header followed by image size and image itself)
+  QByteArray compressedFileData{};
+  appendUint32(compressedFileData, kCompressedTextureMagic);
+  appendUint32(compressedFileData, internalFormat);
+  appendUint32(compressedFileData, static_cast<uint32_t>(width));
+  appendUint32(compressedFileData, static_cast<uint32_t>(height));
+  appendUint32(compressedFileData, static_cast<uint32_t>(faceCount));
+  appendUint32(compressedFileData, static_cast<uint32_t>(levelCount));
+  for (int level = 0; level < levelCount; ++level) {
+    for (int face = 0; face < faceCount; ++face) {
+      GLint imageByteCount{};
+      glGetTexLevelParameteriv(firstFaceTarget + face, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE,
+                               &imageByteCount);
+      pixels.resize(static_cast<size_t>(imageByteCount));
+      glGetCompressedTexImage(firstFaceTarget + face, level, pixels.data());
+
+      appendUint32(compressedFileData, static_cast<uint32_t>(imageByteCount));
+      compressedFileData.append(reinterpret_cast<const char *>(pixels.data()), imageByteCount);
+    }
+  }
+
+  // Deleting temporary texture
+  glBindTexture(target, 0);
+  glDeleteTextures(1, &compressedTexture);
+
+  // Writing compressed texture file atomically (concurrent launches never read partial file)
+  const std::string compressedFilename{getCompressedTextureFilename(absoluteFilenames)};
+  QSaveFile         compressedFile{QString{compressedFilename.c_str()}};
+  if (!compressedFile.open(QFile::WriteOnly) || compressedFile.write(compressedFileData) < 0 ||
+      !compressedFile.commit()) {
+    std::cout << "error: unable to write " << compressedFilename << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+// Local function definitions
+
+static void appendUint32(QByteArray &byteArray, uint32_t value) {
+  byteArray.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
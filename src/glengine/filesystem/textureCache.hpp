@@ -0,0 +1,45 @@
+#ifndef GLENGINE_FILESYSTEM_TEXTURECACHE_HPP
+#define GLENGINE_FILESYSTEM_TEXTURECACHE_HPP
+
+// STD
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// OpenGL
+#include <glad/glad.h>
+
+namespace glengine {
+
+// Compressed texture struct (all the mip-map levels of all the faces as they are stored on GPU)
+struct CompressedTexture {
+  GLenum                     internalFormat{};
+  int                        width{};
+  int                        height{};
+  int                        faceCount{};
+  int                        levelCount{};
+  std::vector<size_t>        imageOffsets{};     // per level, per face
+  std::vector<size_t>        imageByteCounts{};  // per level, per face
+  std::vector<unsigned char> data{};
+};
+
+// Gets BCn internal format for image (BC4/BC5 for 1/2 components, BC7 for LDR, BC6H for HDR)
+GLenum getCompressedInternalFormat(int componentCount, bool isHDR, bool sRGB) noexcept;
+
+// Gets compressed texture filename (stored next to the first source image)
+std::string getCompressedTextureFilename(const std::vector<std::string> &absoluteFilenames);
+
+// Checks if compressed texture exists and is newer than all of its source images
+bool isCompressedTextureFresh(const std::vector<std::string> &absoluteFilenames);
+
+// Reads compressed texture of source images (does not need OpenGL context)
+bool readCompressedTexture(const std::vector<std::string> &absoluteFilenames,
+                           CompressedTexture              &compressedTexture);
+
+// Compresses all the mip-map levels of texture by driver and writes them next to source images
+bool writeCompressedTexture(GLuint texture, GLenum target, int componentCount, bool isHDR,
+                            bool sRGB, const std::vector<std::string> &absoluteFilenames);
+
+}  // namespace glengine
+
+#endif
@@ -3,8 +3,24 @@
 
 // All the headers
 #include "./filesystem/filesystem.hpp"
+#include "./filesystem/TextureLoader.hpp"
+#include "./filesystem/TextureUploadRing.hpp"
+#include "./filesystem/textureCache.hpp"
+#include "./jobs/JobGraph.hpp"
+#include "./jobs/JobSystem.hpp"
+#include "./SceneObject/RenderQueue.hpp"
+#include "./SceneObject/Scene.hpp"
 #include "./SceneObject/SceneObject.hpp"
+#include "./SceneObject/ShadowAtlas.hpp"
+#include "./SceneObject/ShadowCubeMapPool.hpp"
+#include "./SceneObject/modelMatrixBatch.hpp"
 #include "./shader/shader.hpp"
+#include "./shader/ShaderWatcher.hpp"
+#include "./shader/programCache.hpp"
+#include "./shader/uniformBuffer.hpp"
+#include "./shader/uniformCache.hpp"
+#include "./GlHandle.hpp"
+#include "./allocationCounter.hpp"
 #include "./gldebug.hpp"
 #include "./glinit.hpp"
 
@@ -0,0 +1,80 @@
+// Header file
+#include "./JobGraph.hpp"
+
+// STD
+#include <utility>
+
+using namespace glengine;
+
+// Constructors, assignment operators and destructor
+
+// Default constructor
+JobGraph::JobGraph() noexcept {}
+
+// Destructor
+JobGraph::~JobGraph() noexcept {}
+
+// Getters
+
+size_t JobGraph::getJobCount() const noexcept { return _nodes.size(); }
+
+// Other member functions
+
+// Adds job to graph and returns its index
+size_t JobGraph::addJob(Function function) {
+  _nodes.push_back(Node{std::move(function), std::vector<size_t>{}, 0});
+  return _nodes.size() - 1;
+}
+
+// Makes job run only after dependency job is executed
+void JobGraph::addDependency(size_t job, size_t dependencyJob) {
+  _nodes[dependencyJob].dependentJobs.push_back(job);
+  ++_nodes[job].dependencyCount;
+}
+
+// Runs all the jobs in order of dependencies and waits for them (executing them meanwhile)
+void JobGraph::run(JobSystem &jobSystem) {
+  // Reallocating remaining dependency counters if jobs were added since the last run
+  if (_remainingDependencyCountsSize != _nodes.size()) {
+    _remainingDependencyCounts     = std::make_unique<std::atomic<size_t>[]>(_nodes.size());
+    _remainingDependencyCountsSize = _nodes.size();
+  }
+  for (size_t i = 0; i < _nodes.size(); ++i) {
+    _remainingDependencyCounts[i].store(_nodes[i].dependencyCount, std::memory_order_relaxed);
+  }
+  _jobSystemPtr = &jobSystem;
+
+  // Submitting jobs without dependencies (the rest are submitted by their last dependency)
+  for (size_t i = 0; i < _nodes.size(); ++i) {
+    if (_nodes[i].dependencyCount == 0) submitJob(i);
+  }
+
+  jobSystem.wait(_counter);
+}
+
+// Removes all the jobs
+void JobGraph::clear() noexcept { _nodes.clear(); }
+
+// Submits job as range job of graph (so nothing is allocated)
+void JobGraph::submitJob(size_t job) {
+  _jobSystemPtr->submit(&JobGraph::executeJob, this, job, job + 1, _counter);
+}
+
+// Other static member functions
+
+// Executes job and submits its dependent jobs whose dependencies are all executed
+// (before counter is decremented, so waiting does not end until all the jobs are executed)
+void JobGraph::executeJob(void *jobGraphPtr, size_t job, size_t) {
+  JobGraph   &jobGraph = *static_cast<JobGraph *>(jobGraphPtr);
+  const Node &node     = jobGraph._nodes[job];
+  node.function();
+
+  // For each dependent job
+  for (size_t i = 0; i < node.dependentJobs.size(); ++i) {
+    const size_t dependentJob = node.dependentJobs[i];
+    if (jobGraph._remainingDependencyCounts[dependentJob].fetch_sub(
+            1, std::memory_order_acq_rel) == 1) {
+      jobGraph.submitJob(dependentJob);
+    }
+  }
+}
@@ -0,0 +1,64 @@
+#ifndef GLENGINE_JOBS_JOBGRAPH_HPP
+#define GLENGINE_JOBS_JOBGRAPH_HPP
+
+// STD
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// "glengine" internal library
+#include "./JobSystem.hpp"
+
+namespace glengine {
+
+// Job graph class (jobs with dependencies between them: each job is submitted to job system
+// once all the jobs it depends on are executed, so independent ones run in parallel; graph is
+// built once and may be run many times without allocating, but must be acyclic)
+class JobGraph {
+ public:
+  // Job function type (stored once when job is added, and called through a range job of job
+  // system on every run, so runs do not copy it)
+  using Function = std::function<void()>;
+
+ private:
+  // Node struct (job and jobs which depend on it)
+  struct Node {
+    Function            function{};
+    std::vector<size_t> dependentJobs{};
+    size_t              dependencyCount{};
+  };
+
+  std::vector<Node>                      _nodes{};
+  std::unique_ptr<std::atomic<size_t>[]> _remainingDependencyCounts{};
+  size_t                                 _remainingDependencyCountsSize{};
+  JobSystem                             *_jobSystemPtr{};
+  std::atomic<size_t>                    _counter{};
+
+ public:
+  // Constructors, assignment operators and destructor
+  JobGraph() noexcept;
+  JobGraph(const JobGraph &jobGraph)            = delete;
+  JobGraph &operator=(const JobGraph &jobGraph) = delete;
+  JobGraph(JobGraph &&jobGraph)                 = delete;
+  JobGraph &operator=(JobGraph &&jobGraph)      = delete;
+  ~JobGraph() noexcept;
+
+  // Getters
+  size_t getJobCount() const noexcept;
+
+  // Other member functions
+  size_t addJob(Function function);
+  void   addDependency(size_t job, size_t dependencyJob);
+  void   run(JobSystem &jobSystem);
+  void   clear() noexcept;
+
+ private:
+  void submitJob(size_t job);
+
+  static void executeJob(void *jobGraphPtr, size_t job, size_t end);
+};
+
+}  // namespace glengine
+
+#endif
@@ -0,0 +1,189 @@
+// Header file
+#include "./JobSystem.hpp"
+
+// STD
+#include <algorithm>
+#include <utility>
+
+using namespace glengine;
+
+// Global constants
+
+// Initial job capacity of job queues (they only grow if more jobs are queued at once)
+static constexpr size_t kInitialQueueCapacity = 256;
+
+// Global variables
+
+// Job system and job queue index of the current thread (nullptr outside of worker threads)
+static thread_local const JobSystem *tJobSystemPtr{};
+static thread_local size_t           tQueueIndex{};
+
+// Constructors, assignment operators and destructor
+
+// Parameterized constructor (zero worker count means one worker per hardware thread but one,
+// since the thread which waits for jobs executes them too)
+JobSystem::JobSystem(unsigned int workerCount) noexcept {
+  if (workerCount == 0) workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+  // Creating job queues (the first one for threads outside of job system)
+  for (unsigned int i = 0; i <= workerCount; ++i) {
+    _queues.push_back(std::make_unique<Queue>());
+    _queues.back()->jobs.reserve(kInitialQueueCapacity);
+  }
+
+  // Starting worker threads
+  for (unsigned int i = 0; i < workerCount; ++i) {
+    _workers.push_back(std::thread{&JobSystem::work, this, i + 1});
+  }
+}
+
+// Destructor (jobs must be waited for before)
+JobSystem::~JobSystem() noexcept {
+  // Waking up worker threads and waiting for them to stop
+  {
+    std::lock_guard lock{_sleepMutex};
+    _isRunning = false;
+  }
+  _sleepCondition.notify_all();
+  for (size_t i = 0; i < _workers.size(); ++i) {
+    _workers[i].join();
+  }
+}
+
+// Getters
+
+size_t JobSystem::getWorkerCount() const noexcept { return _workers.size(); }
+
+JobSystemStats JobSystem::getStats() const noexcept {
+  return JobSystemStats{_executedJobCount.load(), _stolenJobCount.load()};
+}
+
+// Other member functions
+
+// Submits job (called with context and range) to queue of the current thread and increments
+// counter (which is decremented once job is executed)
+void JobSystem::submit(RangeFunction rangeFunction, void *contextPtr, size_t begin, size_t end,
+                       std::atomic<size_t> &counter) {
+  Job job{};
+  job.rangeFunction = rangeFunction;
+  job.contextPtr    = contextPtr;
+  job.begin         = begin;
+  job.end           = end;
+  job.counterPtr    = &counter;
+  push(std::move(job));
+}
+
+// Waits for counter to reach zero, executing queued jobs meanwhile
+void JobSystem::wait(const std::atomic<size_t> &counter) {
+  const size_t queueIndex = getQueueIndex();
+  while (counter.load(std::memory_order_acquire) != 0) {
+    if (!executeJob(queueIndex)) std::this_thread::yield();
+  }
+}
+
+// Calls function for ranges of at most grain size indices in [0, count) in parallel
+// and waits for all of them (range is not split if it fits a single grain)
+void JobSystem::parallelFor(size_t count, size_t grainSize, RangeFunction rangeFunction,
+                            void *contextPtr) {
+  if (count == 0) return;
+  grainSize = std::max(grainSize, size_t{1});
+
+  // If there is a single range
+  if (count <= grainSize) {
+    rangeFunction(contextPtr, 0, count);
+    return;
+  }
+
+  // Submitting every range but the first one, which is executed by the current thread
+  std::atomic<size_t> counter{};
+  for (size_t begin = grainSize; begin < count; begin += grainSize) {
+    submit(rangeFunction, contextPtr, begin, std::min(begin + grainSize, count), counter);
+  }
+  rangeFunction(contextPtr, 0, grainSize);
+
+  wait(counter);
+}
+
+// Pushes job to the back of queue of the current thread and wakes up a worker thread
+void JobSystem::push(Job &&job) {
+  job.counterPtr->fetch_add(1, std::memory_order_relaxed);
+
+  // Pushing job to the back of queue
+  Queue &queue = *_queues[getQueueIndex()];
+  {
+    std::lock_guard lock{queue.mutex};
+    queue.jobs.push_back(std::move(job));
+  }
+  _queuedJobCount.fetch_add(1);
+
+  // Waking up a sleeping worker thread (locking sleep mutex, so the wake up is not lost
+  // between its check of queued job count and falling asleep)
+  { std::lock_guard lock{_sleepMutex}; }
+  _sleepCondition.notify_one();
+}
+
+// Executes jobs of the queue and stolen ones until job system stops
+void JobSystem::work(size_t queueIndex) {
+  tJobSystemPtr = this;
+  tQueueIndex   = queueIndex;
+
+  // While job system is running
+  while (_isRunning) {
+    if (executeJob(queueIndex)) continue;
+
+    // Sleeping until a job is queued
+    std::unique_lock lock{_sleepMutex};
+    _sleepCondition.wait(lock, [this]() { return _queuedJobCount != 0 || !_isRunning; });
+  }
+}
+
+// Executes the newest job of the queue or steals the oldest job of another queue
+// (returns false if all the queues are empty)
+bool JobSystem::executeJob(size_t queueIndex) {
+  Job  job{};
+  bool hasJob{};
+
+  // Popping job from the back of own queue
+  {
+    Queue          &queue = *_queues[queueIndex];
+    std::lock_guard lock{queue.mutex};
+    if (queue.jobs.size() > queue.firstJob) {
+      job = std::move(queue.jobs.back());
+      queue.jobs.pop_back();
+      hasJob = true;
+    }
+    if (queue.jobs.size() == queue.firstJob) {
+      queue.jobs.clear();
+      queue.firstJob = 0;
+    }
+  }
+
+  // Stealing job from the front of other queues starting with the next one
+  for (size_t i = 1; !hasJob && i < _queues.size(); ++i) {
+    Queue          &queue = *_queues[(queueIndex + i) % _queues.size()];
+    std::lock_guard lock{queue.mutex};
+    if (queue.jobs.size() > queue.firstJob) {
+      job    = std::move(queue.jobs[queue.firstJob++]);
+      hasJob = true;
+      _stolenJobCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (queue.jobs.size() == queue.firstJob) {
+      queue.jobs.clear();
+      queue.firstJob = 0;
+    }
+  }
+  if (!hasJob) return false;
+  _queuedJobCount.fetch_sub(1);
+
+  // Executing job and decrementing its counter
+  job.rangeFunction(job.contextPtr, job.begin, job.end);
+  _executedJobCount.fetch_add(1, std::memory_order_relaxed);
+  job.counterPtr->fetch_sub(1, std::memory_order_release);
+
+  return true;
+}
+
+// Gets job queue index of the current thread (0 for threads outside of job system)
+size_t JobSystem::getQueueIndex() const noexcept {
+  return tJobSystemPtr == this ? tQueueIndex : 0;
+}
@@ -0,0 +1,100 @@
+#ifndef GLENGINE_JOBS_JOBSYSTEM_HPP
+#define GLENGINE_JOBS_JOBSYSTEM_HPP
+
+// STD
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace glengine {
+
+// Job system statistics struct (since the start)
+struct JobSystemStats {
+  size_t executedJobCount{};  // jobs executed by worker and waiting threads
+  size_t stolenJobCount{};    // jobs taken from job queues of other threads
+};
+
+// Job system class (a pool of worker threads with a job queue each: threads take jobs they
+// submitted themselves from the back of their own queue, which keeps caches warm, and steal
+// the oldest jobs from the front of other queues once their own one is empty; threads waiting
+// for jobs to finish execute queued jobs meanwhile instead of blocking, so jobs may submit
+// and wait for other jobs; jobs are a function pointer with context and range of indices, so
+// submitting them allocates nothing; jobs must not use OpenGL, since context is current
+// on one thread)
+class JobSystem {
+ public:
+  // Job function type (called with context and [begin, end) range of indices)
+  using RangeFunction = void (*)(void *contextPtr, size_t begin, size_t end);
+
+ private:
+  // Job struct (counter is decremented once job is executed)
+  struct Job {
+    RangeFunction        rangeFunction{};
+    void                *contextPtr{};
+    size_t               begin{};
+    size_t               end{};
+    std::atomic<size_t> *counterPtr{};
+  };
+
+  // Job queue struct (jobs before the first one are already taken; queue 0 is shared
+  // by threads outside of job system; jobs keep their capacity once queue is empty)
+  struct Queue {
+    std::vector<Job> jobs{};
+    size_t           firstJob{};
+    std::mutex       mutex{};
+  };
+
+  std::vector<std::unique_ptr<Queue>> _queues{};
+  std::vector<std::thread>            _workers{};
+  std::mutex                          _sleepMutex{};
+  std::condition_variable             _sleepCondition{};
+  std::atomic<size_t>                 _queuedJobCount{};
+  std::atomic<bool>                   _isRunning{true};
+  std::atomic<size_t>                 _executedJobCount{};
+  std::atomic<size_t>                 _stolenJobCount{};
+
+ public:
+  // Constructors, assignment operators and destructor
+  explicit JobSystem(unsigned int workerCount = 0) noexcept;
+  JobSystem(const JobSystem &jobSystem)            = delete;
+  JobSystem &operator=(const JobSystem &jobSystem) = delete;
+  JobSystem(JobSystem &&jobSystem)                 = delete;
+  JobSystem &operator=(JobSystem &&jobSystem)      = delete;
+  ~JobSystem() noexcept;
+
+  // Getters
+  size_t         getWorkerCount() const noexcept;
+  JobSystemStats getStats() const noexcept;
+
+  // Other member functions
+  void submit(RangeFunction rangeFunction, void *contextPtr, size_t begin, size_t end,
+              std::atomic<size_t> &counter);
+  void wait(const std::atomic<size_t> &counter);
+  void parallelFor(size_t count, size_t grainSize, RangeFunction rangeFunction,
+                   void *contextPtr);
+
+  // Calls function (callable with begin and end indices) for ranges of indices in parallel
+  // (see the other overload; function is called through pointer, so it is not copied)
+  template <typename T>
+  void parallelFor(size_t count, size_t grainSize, const T &function) {
+    parallelFor(
+        count, grainSize,
+        [](void *contextPtr, size_t begin, size_t end) {
+          (*static_cast<const T *>(contextPtr))(begin, end);
+        },
+        const_cast<T *>(&function));
+  }
+
+ private:
+  void   push(Job &&job);
+  void   work(size_t queueIndex);
+  bool   executeJob(size_t queueIndex);
+  size_t getQueueIndex() const noexcept;
+};
+
+}  // namespace glengine
+
+#endif
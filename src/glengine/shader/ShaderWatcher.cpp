@@ -0,0 +1,280 @@
+// Header file
+#include "./ShaderWatcher.hpp"
+
+// STD
+#include <chrono>
+#include <iostream>
+#include <utility>
+
+// Linux
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// Qt5
+#include <QDateTime>
+#include <QFileInfo>
+#include <QString>
+
+// "glengine" internal library
+#include "./shader.hpp"
+
+// for "ms"
+using namespace std::chrono_literals;
+
+using namespace glengine;
+
+// Global constants
+static constexpr std::chrono::duration kShaderWatcherInterval = 500ms;
+static constexpr int                   kInotifyPollTimeoutMs  = 100;
+static constexpr size_t                kInotifyBufferSize     = 4096;
+
+// Local function headers
+static qint64 getModificationTime(const std::string &absoluteShaderFilename);
+
+// Constructors, assignment operators and destructor
+
+// Default constructor
+ShaderWatcher::ShaderWatcher() noexcept {
+#ifdef __linux__
+  // Initializing inotify instance (polling of modification times is used if it fails)
+  _inotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (_inotifyFD < 0) {
+    std::cout << "error: unable to initialize inotify, falling back to polling" << std::endl;
+  }
+#endif
+}
+
+// Destructor
+ShaderWatcher::~ShaderWatcher() noexcept {
+  stop();
+
+#ifdef __linux__
+  // Closing inotify instance (watch descriptors are removed with it)
+  if (_inotifyFD >= 0) close(_inotifyFD);
+#endif
+}
+
+// Getters
+
+bool ShaderWatcher::isUsingInotify() const noexcept { return _inotifyFD >= 0; }
+
+// Other member functions
+
+void ShaderWatcher::addShaderProgram(GLuint shaderProgram, const std::vector<GLenum> &shaderTypes,
+                                     const std::vector<std::string> &shaderFilenames) {
+  // If sizes mismatch
+  if (shaderTypes.size() != shaderFilenames.size()) return;
+
+  std::lock_guard lock{_mutex};
+
+  WatchedShaderProgram &watchedShaderProgram = _watchedShaderPrograms[shaderProgram];
+  watchedShaderProgram.shaderTypes           = shaderTypes;
+  watchedShaderProgram.shaderFilenames       = shaderFilenames;
+  watchedShaderProgram.absoluteShaderFilenames.clear();
+
+  // For each shader file
+  for (size_t i = 0; i < shaderFilenames.size(); ++i) {
+    QFileInfo         shaderFileInfo{QString{shaderFilenames[i].c_str()}};
+    const std::string absoluteShaderFilename{shaderFileInfo.absoluteFilePath().toStdString()};
+    watchedShaderProgram.absoluteShaderFilenames.push_back(absoluteShaderFilename);
+
+    // Remembering current modification time
+    _shaderLastModificationTimes[absoluteShaderFilename] =
+        shaderFileInfo.lastModified().toMSecsSinceEpoch();
+
+    // Watching directory of shader file
+    watchDirectory(shaderFileInfo.absolutePath().toStdString());
+  }
+
+  // Shader program is compiled for the first time on the next processing
+  _pendingShaderPrograms.insert(shaderProgram);
+}
+
+void ShaderWatcher::removeShaderProgram(GLuint shaderProgram) {
+  std::lock_guard lock{_mutex};
+
+  _watchedShaderPrograms.erase(shaderProgram);
+  _pendingShaderPrograms.erase(shaderProgram);
+}
+
+void ShaderWatcher::start() {
+  // If already running
+  if (_isRunning) return;
+
+  _isRunning = true;
+  _thread    = std::thread{&ShaderWatcher::watch, this};
+}
+
+void ShaderWatcher::stop() {
+  // If not running
+  if (!_isRunning) return;
+
+  // Waking up watcher thread and waiting for it to stop
+  {
+    std::lock_guard lock{_mutex};
+    _isRunning = false;
+  }
+  _stopCondition.notify_all();
+  _thread.join();
+}
+
+size_t ShaderWatcher::processPendingRecompiles() {
+  // Taking pending shader programs (render thread never waits for watcher thread)
+  std::vector<std::pair<GLuint, WatchedShaderProgram>> pendingShaderPrograms{};
+  {
+    std::unique_lock lock{_mutex, std::try_to_lock};
+    if (!lock.owns_lock()) return 0;
+
+    for (auto iter = _pendingShaderPrograms.begin(); iter != _pendingShaderPrograms.end();
+         ++iter) {
+      auto watchedShaderProgramIter = _watchedShaderPrograms.find(*iter);
+      if (watchedShaderProgramIter != _watchedShaderPrograms.end()) {
+        pendingShaderPrograms.emplace_back(*iter, watchedShaderProgramIter->second);
+      }
+    }
+    _pendingShaderPrograms.clear();
+  }
+
+  // For each pending shader program
+  size_t recompiledCount{};
+  for (size_t i = 0; i < pendingShaderPrograms.size(); ++i) {
+    const GLuint                shaderProgram        = pendingShaderPrograms[i].first;
+    const WatchedShaderProgram &watchedShaderProgram = pendingShaderPrograms[i].second;
+
+    // Reading shader sources and relinking shader program
+    std::vector<std::string> shaderSources{};
+    if (!readShaderSources(watchedShaderProgram.shaderFilenames, shaderSources)) continue;
+    linkShaderProgram(shaderProgram, watchedShaderProgram.shaderTypes, shaderSources,
+                      watchedShaderProgram.shaderFilenames);
+
+    ++recompiledCount;
+  }
+
+  return recompiledCount;
+}
+
+void ShaderWatcher::watch() {
+  // While thread is running
+  while (_isRunning) {
+    // If inotify is available
+    if (_inotifyFD >= 0) {
+#ifdef __linux__
+      // Waiting for file system events (with timeout to notice stop requests)
+      pollfd inotifyPollFD{_inotifyFD, POLLIN, 0};
+      if (poll(&inotifyPollFD, 1, kInotifyPollTimeoutMs) > 0) {
+        readInotifyEvents();
+      }
+#endif
+    }
+    // If inotify is not available
+    else {
+      pollModificationTimes();
+
+      // Waiting for the next poll or stop request
+      std::unique_lock lock{_mutex};
+      _stopCondition.wait_for(lock, kShaderWatcherInterval, [this]() { return !_isRunning; });
+    }
+  }
+}
+
+void ShaderWatcher::watchDirectory(const std::string &directory) {
+#ifdef __linux__
+  // If inotify is not available
+  if (_inotifyFD < 0) return;
+
+  // If directory is already watched
+  for (auto iter = _watchedDirectories.begin(); iter != _watchedDirectories.end(); ++iter) {
+    if (iter->second == directory) return;
+  }
+
+  // Watching for closed after writing and replaced files (editors often save by renaming)
+  int watchDescriptor =
+      inotify_add_watch(_inotifyFD, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+  if (watchDescriptor < 0) {
+    std::cout << "error: unable to watch " << directory << std::endl;
+    return;
+  }
+  _watchedDirectories[watchDescriptor] = directory;
+#endif
+}
+
+void ShaderWatcher::readInotifyEvents() {
+#ifdef __linux__
+  alignas(inotify_event) char buffer[kInotifyBufferSize];
+
+  // While there are events to read
+  while (true) {
+    ssize_t length = read(_inotifyFD, buffer, sizeof(buffer));
+    if (length <= 0) break;
+
+    std::lock_guard lock{_mutex};
+
+    // For each event
+    for (char *eventPtr = buffer; eventPtr < buffer + length;) {
+      const inotify_event *event = reinterpret_cast<const inotify_event *>(eventPtr);
+      eventPtr += sizeof(inotify_event) + event->len;
+
+      // If event has no file name or directory is not watched anymore
+      auto watchedDirectoryIter = _watchedDirectories.find(event->wd);
+      if (event->len == 0 || watchedDirectoryIter == _watchedDirectories.end()) continue;
+
+      markShaderFileModified(watchedDirectoryIter->second + "/" + event->name);
+    }
+  }
+#endif
+}
+
+void ShaderWatcher::pollModificationTimes() {
+  // Copying watched file names so that file system is accessed without holding mutex
+  std::vector<std::string> absoluteShaderFilenames{};
+  {
+    std::lock_guard lock{_mutex};
+    for (auto iter = _shaderLastModificationTimes.begin();
+         iter != _shaderLastModificationTimes.end(); ++iter) {
+      absoluteShaderFilenames.push_back(iter->first);
+    }
+  }
+
+  // Getting modification times
+  std::vector<qint64> modificationTimes{};
+  for (size_t i = 0; i < absoluteShaderFilenames.size(); ++i) {
+    modificationTimes.push_back(getModificationTime(absoluteShaderFilenames[i]));
+  }
+
+  std::lock_guard lock{_mutex};
+
+  // For each shader file
+  for (size_t i = 0; i < absoluteShaderFilenames.size(); ++i) {
+    // If shader file was modified
+    qint64 &lastModificationTime = _shaderLastModificationTimes[absoluteShaderFilenames[i]];
+    if (modificationTimes[i] > lastModificationTime) {
+      lastModificationTime = modificationTimes[i];
+      markShaderFileModified(absoluteShaderFilenames[i]);
+    }
+  }
+}
+
+void ShaderWatcher::markShaderFileModified(const std::string &absoluteShaderFilename) {
+  // For each watched shader program
+  for (auto iter = _watchedShaderPrograms.begin(); iter != _watchedShaderPrograms.end(); ++iter) {
+    const std::vector<std::string> &absoluteShaderFilenames = iter->second.absoluteShaderFilenames;
+
+    // If shader program uses modified file
+    for (size_t i = 0; i < absoluteShaderFilenames.size(); ++i) {
+      if (absoluteShaderFilenames[i] == absoluteShaderFilename) {
+        _pendingShaderPrograms.insert(iter->first);
+        break;
+      }
+    }
+  }
+}
+
+// Local function definitions
+
+qint64 getModificationTime(const std::string &absoluteShaderFilename) {
+  QFileInfo shaderFileInfo{QString{absoluteShaderFilename.c_str()}};
+  return shaderFileInfo.lastModified().toMSecsSinceEpoch();
+}
@@ -0,0 +1,77 @@
+#ifndef GLENGINE_SHADER_SHADERWATCHER_HPP
+#define GLENGINE_SHADER_SHADERWATCHER_HPP
+
+// STD
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Qt5
+#include <QtGlobal>
+
+// OpenGL
+#include <glad/glad.h>
+
+namespace glengine {
+
+// Shader hot-reload service class (a single thread detects modifications of all the watched
+// shader files without OpenGL context, while shader programs are recompiled on the render thread)
+class ShaderWatcher {
+ private:
+  // Watched shader program struct
+  struct WatchedShaderProgram {
+    std::vector<GLenum>      shaderTypes{};
+    std::vector<std::string> shaderFilenames{};
+    std::vector<std::string> absoluteShaderFilenames{};
+  };
+
+  std::unordered_map<GLuint, WatchedShaderProgram> _watchedShaderPrograms{};
+  std::unordered_set<GLuint>                       _pendingShaderPrograms{};
+  std::unordered_map<std::string, qint64>          _shaderLastModificationTimes{};
+  std::mutex                                       _mutex{};
+  std::condition_variable                          _stopCondition{};
+  std::atomic<bool>                                _isRunning{};
+  std::thread                                      _thread{};
+
+  // inotify instance and its watch descriptors of shader directories (Linux only)
+  int                                  _inotifyFD{-1};
+  std::unordered_map<int, std::string> _watchedDirectories{};
+
+ public:
+  // Constructors, assignment operators and destructor
+  ShaderWatcher() noexcept;
+  ShaderWatcher(const ShaderWatcher &shaderWatcher)            = delete;
+  ShaderWatcher &operator=(const ShaderWatcher &shaderWatcher) = delete;
+  ShaderWatcher(ShaderWatcher &&shaderWatcher)                 = delete;
+  ShaderWatcher &operator=(ShaderWatcher &&shaderWatcher)      = delete;
+  ~ShaderWatcher() noexcept;
+
+  // Getters
+  bool isUsingInotify() const noexcept;
+
+  // Other member functions
+  void addShaderProgram(GLuint shaderProgram, const std::vector<GLenum> &shaderTypes,
+                        const std::vector<std::string> &shaderFilenames);
+  void removeShaderProgram(GLuint shaderProgram);
+
+  void start();
+  void stop();
+
+  size_t processPendingRecompiles();
+
+ private:
+  void watch();
+  void watchDirectory(const std::string &directory);
+  void readInotifyEvents();
+  void pollModificationTimes();
+  void markShaderFileModified(const std::string &absoluteShaderFilename);
+};
+
+}  // namespace glengine
+
+#endif
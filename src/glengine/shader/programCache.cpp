@@ -0,0 +1,165 @@
+// Header file
+#include "./programCache.hpp"
+
+// STD
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+// Qt5
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QString>
+
+// "glengine" internal library
+#include "../filesystem/filesystem.hpp"
+
+// Global constants
+static const std::string kDefaultShaderProgramCacheDirectory{"shader_cache"};
+static const std::string kShaderProgramBinaryExtension{".bin"};
+
+// Local function headers
+static std::string                       &getMutableShaderProgramCacheDirectory();
+static glengine::ShaderProgramCacheStats &getMutableShaderProgramCacheStats();
+static std::string getShaderProgramBinaryFilename(const std::string &cacheKey);
+
+// Calculates cache key of shader program by its shader types, sources and driver strings
+std::string glengine::calculateShaderProgramCacheKey(
+    const std::vector<GLenum> &shaderTypes, const std::vector<std::string> &shaderSources) {
+  QCryptographicHash hash{QCryptographicHash::Sha256};
+
+  // Hashing driver strings (binaries are valid only for the same driver build)
+  const GLenum driverStringNames[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+  for (GLenum driverStringName : driverStringNames) {
+    const char *driverString = reinterpret_cast<const char *>(glGetString(driverStringName));
+    if (driverString != nullptr) {
+      hash.addData(QByteArray{driverString, static_cast<int>(std::strlen(driverString)) + 1});
+    }
+  }
+
+  // Hashing shader types and sources
+  for (size_t i = 0; i < shaderTypes.size() && i < shaderSources.size(); ++i) {
+    const std::string shaderType{std::to_string(shaderTypes[i]) + ":"};
+    hash.addData(QByteArray{shaderType.c_str(), static_cast<int>(shaderType.size())});
+    hash.addData(
+        QByteArray{shaderSources[i].c_str(), static_cast<int>(shaderSources[i].size()) + 1});
+  }
+
+  return hash.result().toHex().toStdString();
+}
+
+// Loads cached binary into shader program (returns false if there is no usable binary)
+bool glengine::loadShaderProgramBinary(GLuint shaderProgram, const std::string &cacheKey) {
+  // If cache is disabled
+  if (getShaderProgramCacheDirectory().empty()) return false;
+
+  const auto loadStartTime = std::chrono::steady_clock::now();
+
+  // Reading binary file (binary format followed by binary itself)
+  QFile binaryFile{QString{getShaderProgramBinaryFilename(cacheKey).c_str()}};
+  if (!binaryFile.open(QFile::ReadOnly)) return false;
+  QByteArray binaryFileData{binaryFile.readAll()};
+  if (binaryFileData.size() <= static_cast<int>(sizeof(GLenum))) return false;
+
+  GLenum binaryFormat{};
+  std::memcpy(&binaryFormat, binaryFileData.constData(), sizeof(GLenum));
+
+  // Loading binary into shader program
+  glProgramBinary(shaderProgram, binaryFormat, binaryFileData.constData() + sizeof(GLenum),
+                  binaryFileData.size() - static_cast<GLsizei>(sizeof(GLenum)));
+
+  // Getting linkage success code (driver may reject binary after update)
+  GLint success{};
+  glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+
+  ShaderProgramCacheStats &stats = getMutableShaderProgramCacheStats();
+  stats.loadMilliseconds += std::chrono::duration<double, std::milli>(
+                                std::chrono::steady_clock::now() - loadStartTime)
+                                .count();
+
+  // If binary is rejected
+  if (success == GL_FALSE) {
+    ++stats.rejectedCount;
+    binaryFile.close();
+    binaryFile.remove();
+    return false;
+  }
+
+  ++stats.hitCount;
+  return true;
+}
+
+// Saves binary of linked shader program to cache
+void glengine::saveShaderProgramBinary(GLuint shaderProgram, const std::string &cacheKey) {
+  // If cache is disabled
+  if (getShaderProgramCacheDirectory().empty()) return;
+
+  // Getting shader program binary
+  GLint binaryLength{};
+  glGetProgramiv(shaderProgram, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+  if (binaryLength <= 0) return;
+
+  QByteArray binaryFileData{};
+  binaryFileData.resize(static_cast<int>(sizeof(GLenum)) + binaryLength);
+  GLenum binaryFormat{};
+  glGetProgramBinary(shaderProgram, binaryLength, nullptr, &binaryFormat,
+                     binaryFileData.data() + sizeof(GLenum));
+  std::memcpy(binaryFileData.data(), &binaryFormat, sizeof(GLenum));
+
+  // Creating cache directory if there is no one
+  if (!QDir{}.mkpath(QString{getShaderProgramCacheDirectory().c_str()})) {
+    std::cout << "error: unable to create " << getShaderProgramCacheDirectory() << std::endl;
+    return;
+  }
+
+  // Writing binary file atomically (concurrent launches never read partial file)
+  const std::string binaryFilename{getShaderProgramBinaryFilename(cacheKey)};
+  QSaveFile         binaryFile{QString{binaryFilename.c_str()}};
+  if (!binaryFile.open(QFile::WriteOnly) || binaryFile.write(binaryFileData) < 0 ||
+      !binaryFile.commit()) {
+    std::cout << "error: unable to write " << binaryFilename << std::endl;
+  }
+}
+
+// Sets directory where shader program binaries are stored (empty string disables cache)
+void glengine::setShaderProgramCacheDirectory(const std::string &directory) {
+  getMutableShaderProgramCacheDirectory() = directory;
+}
+
+// Gets directory where shader program binaries are stored
+const std::string &glengine::getShaderProgramCacheDirectory() {
+  return getMutableShaderProgramCacheDirectory();
+}
+
+// Records shader program compiled from sources because there was no usable binary
+void glengine::recordShaderProgramCacheMiss(double compileMilliseconds) noexcept {
+  ShaderProgramCacheStats &stats = getMutableShaderProgramCacheStats();
+  ++stats.missCount;
+  stats.compileMilliseconds += compileMilliseconds;
+}
+
+// Gets shader program cache statistics gathered since the start
+const glengine::ShaderProgramCacheStats &glengine::getShaderProgramCacheStats() noexcept {
+  return getMutableShaderProgramCacheStats();
+}
+
+// Local function definitions
+
+static std::string &getMutableShaderProgramCacheDirectory() {
+  static std::string sShaderProgramCacheDirectory{
+      glengine::getAbsolutePathRelativeToExecutable(kDefaultShaderProgramCacheDirectory)};
+  return sShaderProgramCacheDirectory;
+}
+
+static glengine::ShaderProgramCacheStats &getMutableShaderProgramCacheStats() {
+  static glengine::ShaderProgramCacheStats sShaderProgramCacheStats{};
+  return sShaderProgramCacheStats;
+}
+
+static std::string getShaderProgramBinaryFilename(const std::string &cacheKey) {
+  return glengine::getShaderProgramCacheDirectory() + QDir::separator().toLatin1() + cacheKey +
+         kShaderProgramBinaryExtension;
+}
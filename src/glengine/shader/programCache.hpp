@@ -0,0 +1,47 @@
+#ifndef GLENGINE_SHADER_PROGRAMCACHE_HPP
+#define GLENGINE_SHADER_PROGRAMCACHE_HPP
+
+// STD
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// OpenGL
+#include <glad/glad.h>
+
+namespace glengine {
+
+// Shader program binary cache statistics struct
+struct ShaderProgramCacheStats {
+  size_t hitCount{};             // programs loaded with glProgramBinary
+  size_t missCount{};            // programs compiled from sources (no usable binary)
+  size_t rejectedCount{};        // binaries found on disk but rejected by driver
+  double loadMilliseconds{};     // total time spent loading binaries
+  double compileMilliseconds{};  // total time spent compiling and linking sources
+};
+
+// Calculates cache key of shader program by its shader types, sources and driver strings
+std::string calculateShaderProgramCacheKey(const std::vector<GLenum>      &shaderTypes,
+                                           const std::vector<std::string> &shaderSources);
+
+// Loads cached binary into shader program (returns false if there is no usable binary)
+bool loadShaderProgramBinary(GLuint shaderProgram, const std::string &cacheKey);
+
+// Saves binary of linked shader program to cache
+void saveShaderProgramBinary(GLuint shaderProgram, const std::string &cacheKey);
+
+// Sets directory where shader program binaries are stored (empty string disables cache)
+void setShaderProgramCacheDirectory(const std::string &directory);
+
+// Gets directory where shader program binaries are stored
+const std::string &getShaderProgramCacheDirectory();
+
+// Records shader program compiled from sources because there was no usable binary
+void recordShaderProgramCacheMiss(double compileMilliseconds) noexcept;
+
+// Gets shader program cache statistics gathered since the start
+const ShaderProgramCacheStats &getShaderProgramCacheStats() noexcept;
+
+}  // namespace glengine
+
+#endif
@@ -14,6 +14,10 @@
 #include <QString>
 #include <QTextStream>
 
+// "glengine" internal library
+#include "./programCache.hpp"
+#include "./uniformCache.hpp"
+
 // for "ms"
 using namespace std::chrono_literals;
 
@@ -53,20 +57,32 @@ void glengine::compileShader(GLuint shader, const std::string &source,
   }
 }
 
-// Creates shader program compiling and linking given shaders
-GLuint glengine::createShaderProgram(const std::vector<GLenum>      &shaderTypes,
-                                     const std::vector<std::string> &shaderSources,
-                                     const std::vector<std::string> &shaderFilenames) {
-  GLuint shaderProgram = glCreateProgram();
-
+// Compiles given shaders, attaches them to shader program and links it
+bool glengine::linkShaderProgram(GLuint shaderProgram, const std::vector<GLenum> &shaderTypes,
+                                 const std::vector<std::string> &shaderSources,
+                                 const std::vector<std::string> &shaderFilenames) {
   // Getting shader count
   size_t shaderCount = shaderTypes.size();
 
   // If sizes mismatch
-  if (shaderTypes.size() != shaderSources.size()) {
-    return 0;
+  if (shaderCount != shaderSources.size() || shaderCount != shaderFilenames.size()) {
+    return false;
+  }
+
+  // Loading shader program from binary cache if sources and driver have not changed
+  const std::string cacheKey{calculateShaderProgramCacheKey(shaderTypes, shaderSources)};
+  if (loadShaderProgramBinary(shaderProgram, cacheKey)) {
+    // Caching active uniform locations of loaded shader program
+    reflectShaderProgram(shaderProgram);
+
+    return true;
   }
 
+  const auto compileStartTime = std::chrono::steady_clock::now();
+
+  // Allowing driver to return shader program binary after linkage
+  glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
   // Creating shader list
   std::vector<GLuint> shaders{};
   shaders.assign(shaderCount, 0);
@@ -116,10 +132,36 @@ GLuint glengine::createShaderProgram(const std::vector<GLenum>      &shaderTypes
     glDeleteShader(shaders[i]);
   }
 
+  recordShaderProgramCacheMiss(std::chrono::duration<double, std::milli>(
+                                   std::chrono::steady_clock::now() - compileStartTime)
+                                   .count());
+
+  // Saving linked shader program binary for the next launches
+  if (success == GL_TRUE) {
+    saveShaderProgramBinary(shaderProgram, cacheKey);
+  }
+
+  // (Re)caching active uniform locations as they may change after relinkage
+  reflectShaderProgram(shaderProgram);
+
+  return success == GL_TRUE;
+}
+
+// Creates shader program compiling and linking given shaders
+GLuint glengine::createShaderProgram(const std::vector<GLenum>      &shaderTypes,
+                                     const std::vector<std::string> &shaderSources,
+                                     const std::vector<std::string> &shaderFilenames) {
+  // If sizes mismatch
+  if (shaderTypes.size() != shaderSources.size()) {
+    return 0;
+  }
+
+  GLuint shaderProgram = glCreateProgram();
+
   // If linkage have failed
-  if (success == GL_FALSE) {
+  if (!linkShaderProgram(shaderProgram, shaderTypes, shaderSources, shaderFilenames)) {
     // Deleting shader program
-    glDeleteProgram(shaderProgram);
+    deleteShaderProgram(shaderProgram);
 
     return 0;
   }
@@ -128,6 +170,32 @@ GLuint glengine::createShaderProgram(const std::vector<GLenum>      &shaderTypes
   return shaderProgram;
 }
 
+// Deletes shader program and forgets its cached uniform locations
+void glengine::deleteShaderProgram(GLuint shaderProgram) {
+  forgetShaderProgram(shaderProgram);
+  glDeleteProgram(shaderProgram);
+}
+
+// Reads sources of shader files
+bool glengine::readShaderSources(const std::vector<std::string> &shaderFilenames,
+                                 std::vector<std::string>       &shaderSources) {
+  shaderSources.clear();
+
+  // For each shader
+  for (size_t i = 0; i < shaderFilenames.size(); ++i) {
+    // Reading shader source code from file
+    QFile shaderFile{QString{shaderFilenames[i].c_str()}};
+    if (!shaderFile.open(QFile::ReadOnly | QFile::Text)) {
+      std::cout << "error: unable to find " << shaderFilenames[i] << std::endl;
+      return false;
+    }
+    QTextStream shaderFileTextStream{&shaderFile};
+    shaderSources.push_back(shaderFileTextStream.readAll().toStdString());
+  }
+
+  return true;
+}
+
 // Watches for modifications of shader files (must be run in thread)
 void glengine::shaderWatcher(const std::atomic<bool> &isRunning,
                              std::atomic<bool> &shadersAreRecompiled, GLFWwindow *window,
@@ -173,62 +241,10 @@ void glengine::shaderWatcher(const std::atomic<bool> &isRunning,
           // At least on shader is modified
           modified = true;
 
-          // Creating shader list
-          std::vector<GLuint> shaders{};
-          shaders.assign(shaderCount, 0);
-
-          // For each shader
-          for (size_t j = 0; j < shaderCount; ++j) {
-            // Reading shader source code from file
-            QFile innerShaderFile{QString{shaderFilenames[j].c_str()}};
-            if (!innerShaderFile.open(QFile::ReadOnly | QFile::Text)) {
-              std::cout << "error: unable to find " << shaderFilenames[j] << std::endl;
-              continue;
-            }
-            QTextStream innerShaderFileTextStream{&innerShaderFile};
-            QString     shaderSource{innerShaderFileTextStream.readAll()};
-
-            // Creating shader
-            shaders[j] = glCreateShader(shaderTypes[j]);
-            // Attaching shader to shader program
-            glAttachShader(shaderProgram, shaders[j]);
-            // Compiling shader
-            compileShader(shaders[j], shaderSource.toStdString(), shaderFilenames[j]);
-          }
-
-          // Linking shader program
-          glLinkProgram(shaderProgram);
-
-          // Getting linkage success code
-          GLint success{};
-          glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
-          // Getting linkage info log length
-          GLint infoLogLength{};
-          glGetProgramiv(shaderProgram, GL_INFO_LOG_LENGTH, &infoLogLength);
-          // Getting linkage info log
-          std::vector<char> infoLog{};
-          infoLog.resize(infoLogLength + 1);
-          glGetProgramInfoLog(shaderProgram, infoLogLength, nullptr, &infoLog[0]);
-          // If linkage have failed
-          if (success == GL_FALSE) {
-            std::cout << "error: unable to link shaders in program #" << shaderProgram << "\n";
-            // If there is an info log
-            if (infoLogLength > 0) {
-              std::cout << &infoLog[0];
-            }
-            // If there is no info log
-            else {
-              std::cout << "no error information";
-            }
-            std::cout << std::endl;
-          }
-
-          // For each shader
-          for (size_t j = 0; j < shaderCount; ++j) {
-            // Detaching shader to shader program
-            glDetachShader(shaderProgram, shaders[j]);
-            // Deleting shader
-            glDeleteShader(shaders[j]);
+          // Reading shader sources and relinking shader program
+          std::vector<std::string> shaderSources{};
+          if (readShaderSources(shaderFilenames, shaderSources)) {
+            linkShaderProgram(shaderProgram, shaderTypes, shaderSources, shaderFilenames);
           }
 
           // Notifying that shaders are recompiled
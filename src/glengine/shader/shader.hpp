@@ -4,6 +4,7 @@
 // STD
 #include <atomic>
 #include <mutex>
+#include <string>
 #include <vector>
 
 // Qt5
@@ -19,11 +20,24 @@ namespace glengine {
 // Compiles shader with source code
 void compileShader(GLuint shader, const std::string &source, const std::string &filename);
 
+// Compiles given shaders, attaches them to shader program and links it
+bool linkShaderProgram(GLuint shaderProgram, const std::vector<GLenum> &shaderTypes,
+                       const std::vector<std::string> &shaderSources,
+                       const std::vector<std::string> &shaderFilenames);
+
 // Creates shader program compiling and linking given shaders
 GLuint createShaderProgram(const std::vector<GLenum>      &shaderTypes,
                            const std::vector<std::string> &shaderSources,
                            const std::vector<std::string> &shaderFilenames);
 
+// Deletes shader program and forgets its cached uniform locations (so shader program
+// reusing its name does not get them)
+void deleteShaderProgram(GLuint shaderProgram);
+
+// Reads sources of shader files
+bool readShaderSources(const std::vector<std::string> &shaderFilenames,
+                       std::vector<std::string>       &shaderSources);
+
 // Watches for modifications of shader files (must be run in thread)
 void shaderWatcher(const std::atomic<bool> &isRunning, std::atomic<bool> &shadersAreRecompiled,
                    GLFWwindow *window, std::mutex &glfwContextMutex, GLuint shaderProgram,
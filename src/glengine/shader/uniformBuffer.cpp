@@ -0,0 +1,49 @@
+// Header file
+#include "./uniformBuffer.hpp"
+
+// Creates uniform buffer of given size and binds it to uniform block binding point
+GLuint glengine::createUniformBuffer(GLuint binding, GLsizeiptr size) {
+  // Creating uniform buffer and allocating its storage
+  GLuint uniformBuffer{};
+  glGenBuffers(1, &uniformBuffer);
+  glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer);
+  glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+  // Binding uniform buffer to binding point so every shader program can read it
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding, uniformBuffer);
+
+  return uniformBuffer;
+}
+
+// Overwrites uniform buffer data
+void glengine::updateUniformBuffer(GLuint uniformBuffer, const void *data, GLsizeiptr size) {
+  glBindBuffer(GL_UNIFORM_BUFFER, uniformBuffer);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+// Creates shader storage buffer of given size and binds it to shader storage block binding point
+GLuint glengine::createStorageBuffer(GLuint binding, GLsizeiptr size) {
+  // Creating shader storage buffer and allocating its storage
+  GLuint storageBuffer{};
+  glGenBuffers(1, &storageBuffer);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, storageBuffer);
+  glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+  // Binding shader storage buffer to binding point so every shader program can access it
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, storageBuffer);
+
+  return storageBuffer;
+}
+
+// Overwrites beginning of shader storage buffer data
+void glengine::updateStorageBuffer(GLuint storageBuffer, const void *data, GLsizeiptr size) {
+  // Skipping empty updates (arrays of no lights)
+  if (size <= 0) return;
+
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, storageBuffer);
+  glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, size, data);
+  glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
@@ -0,0 +1,34 @@
+#ifndef GLENGINE_SHADER_UNIFORMBUFFER_HPP
+#define GLENGINE_SHADER_UNIFORMBUFFER_HPP
+
+// OpenGL
+#include <glad/glad.h>
+
+namespace glengine {
+
+// Uniform block binding points shared by all shader programs
+constexpr GLuint kFrameDataUniformBufferBinding        = 0;
+constexpr GLuint kLightsUniformBufferBinding           = 1;
+constexpr GLuint kLightClusterDataUniformBufferBinding = 2;
+
+// Shader storage block binding points shared by all shader programs
+constexpr GLuint kPointLightsStorageBufferBinding   = 0;
+constexpr GLuint kSpotLightsStorageBufferBinding    = 1;
+constexpr GLuint kLightClustersStorageBufferBinding = 2;
+constexpr GLuint kLightIndicesStorageBufferBinding  = 3;
+
+// Creates uniform buffer of given size and binds it to uniform block binding point
+GLuint createUniformBuffer(GLuint binding, GLsizeiptr size);
+
+// Overwrites uniform buffer data
+void updateUniformBuffer(GLuint uniformBuffer, const void *data, GLsizeiptr size);
+
+// Creates shader storage buffer of given size and binds it to shader storage block binding point
+GLuint createStorageBuffer(GLuint binding, GLsizeiptr size);
+
+// Overwrites beginning of shader storage buffer data
+void updateStorageBuffer(GLuint storageBuffer, const void *data, GLsizeiptr size);
+
+}  // namespace glengine
+
+#endif
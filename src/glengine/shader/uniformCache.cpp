@@ -0,0 +1,161 @@
+// Header file
+#include "./uniformCache.hpp"
+
+// STD
+#include <unordered_map>
+#include <vector>
+
+// Global constants
+static constexpr GLint kUnresolvedUniformLocation = -2;
+
+// Shader program cached uniform locations struct
+struct ShaderProgramUniforms {
+  std::unordered_map<std::string, GLint> locationsByName{};
+  std::vector<GLint>                     locationsByHandle{};
+};
+
+// Local function headers
+static std::vector<std::string>                                 &getUniformNames();
+static std::unordered_map<std::string, glengine::UniformHandle> &getUniformHandles();
+static std::unordered_map<GLuint, ShaderProgramUniforms>        &getShaderProgramUniforms();
+static glengine::UniformCacheStats                              &getMutableUniformCacheStats();
+
+// Registers uniform name and returns its handle (the same name always gets the same handle)
+glengine::UniformHandle glengine::registerUniform(const std::string &name) {
+  std::vector<std::string>                       &uniformNames   = getUniformNames();
+  std::unordered_map<std::string, UniformHandle> &uniformHandles = getUniformHandles();
+
+  // If uniform is already registered
+  auto uniformHandleIter = uniformHandles.find(name);
+  if (uniformHandleIter != uniformHandles.end()) return uniformHandleIter->second;
+
+  // Registering new uniform
+  UniformHandle handle = uniformNames.size();
+  uniformNames.push_back(name);
+  uniformHandles.emplace(name, handle);
+
+  return handle;
+}
+
+// Queries active uniforms of linked shader program once and caches their locations
+void glengine::reflectShaderProgram(GLuint shaderProgram) {
+  ++getMutableUniformCacheStats().reflectedProgramCount;
+
+  // Resetting cached uniform locations (shader program may have been relinked)
+  ShaderProgramUniforms &programUniforms = getShaderProgramUniforms()[shaderProgram];
+  programUniforms.locationsByName.clear();
+  programUniforms.locationsByHandle.clear();
+
+  // If shader program is not linked successfully there is nothing to query
+  GLint success{};
+  glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+  if (success == GL_FALSE) return;
+
+  // Getting active uniform count and maximal name length
+  GLint activeUniformCount{};
+  glGetProgramiv(shaderProgram, GL_ACTIVE_UNIFORMS, &activeUniformCount);
+  GLint maxNameLength{};
+  glGetProgramiv(shaderProgram, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+  std::vector<char> nameBuffer{};
+  nameBuffer.resize(maxNameLength + 1);
+
+  // For each active uniform
+  for (GLint i = 0; i < activeUniformCount; ++i) {
+    // Getting uniform name and array size
+    GLsizei nameLength{};
+    GLint   arraySize{};
+    GLenum  type{};
+    glGetActiveUniform(shaderProgram, static_cast<GLuint>(i), maxNameLength, &nameLength,
+                       &arraySize, &type, &nameBuffer[0]);
+    std::string name{&nameBuffer[0], static_cast<size_t>(nameLength)};
+
+    // Getting uniform location (uniforms in uniform blocks have no location)
+    GLint location = glGetUniformLocation(shaderProgram, name.c_str());
+    if (location == -1) continue;
+    programUniforms.locationsByName[name] = location;
+
+    // If uniform is not an array
+    static const std::string kArraySuffix{"[0]"};
+    if (name.size() <= kArraySuffix.size() ||
+        name.compare(name.size() - kArraySuffix.size(), kArraySuffix.size(), kArraySuffix) != 0) {
+      continue;
+    }
+
+    // Caching the array name itself and each of its elements
+    std::string arrayName{name, 0, name.size() - kArraySuffix.size()};
+    programUniforms.locationsByName[arrayName] = location;
+    for (GLint j = 1; j < arraySize; ++j) {
+      std::string elementName = arrayName + "[" + std::to_string(j) + "]";
+      programUniforms.locationsByName[elementName] =
+          glGetUniformLocation(shaderProgram, elementName.c_str());
+    }
+  }
+}
+
+// Removes cached uniform locations of shader program
+void glengine::forgetShaderProgram(GLuint shaderProgram) {
+  getShaderProgramUniforms().erase(shaderProgram);
+}
+
+// Gets cached uniform location of shader program by uniform handle (-1 if uniform is not active)
+GLint glengine::getUniformLocation(GLuint shaderProgram, UniformHandle handle) {
+  std::unordered_map<GLuint, ShaderProgramUniforms> &shaderProgramUniforms =
+      getShaderProgramUniforms();
+
+  // If shader program was never reflected (it was linked outside of glengine)
+  auto programUniformsIter = shaderProgramUniforms.find(shaderProgram);
+  if (programUniformsIter == shaderProgramUniforms.end()) {
+    reflectShaderProgram(shaderProgram);
+    programUniformsIter = shaderProgramUniforms.find(shaderProgram);
+  }
+  ShaderProgramUniforms &programUniforms = programUniformsIter->second;
+
+  // Growing handle table if uniforms were registered after reflection
+  if (handle >= programUniforms.locationsByHandle.size()) {
+    programUniforms.locationsByHandle.resize(getUniformNames().size(), kUnresolvedUniformLocation);
+  }
+
+  // Resolving location by name only once per shader program and uniform
+  GLint &location = programUniforms.locationsByHandle[handle];
+  if (location == kUnresolvedUniformLocation) {
+    auto locationIter = programUniforms.locationsByName.find(getUniformNames()[handle]);
+    location = locationIter != programUniforms.locationsByName.end() ? locationIter->second : -1;
+  }
+
+  ++getMutableUniformCacheStats().skippedLookupCount;
+
+  return location;
+}
+
+// Gets uniform cache statistics gathered since the last reset
+const glengine::UniformCacheStats &glengine::getUniformCacheStats() noexcept {
+  return getMutableUniformCacheStats();
+}
+
+// Resets uniform cache statistics (must be called once per frame)
+void glengine::resetUniformCacheStats() noexcept {
+  getMutableUniformCacheStats() = UniformCacheStats{};
+}
+
+// Local function definitions
+
+static std::vector<std::string> &getUniformNames() {
+  static std::vector<std::string> sUniformNames{};
+  return sUniformNames;
+}
+
+static std::unordered_map<std::string, glengine::UniformHandle> &getUniformHandles() {
+  static std::unordered_map<std::string, glengine::UniformHandle> sUniformHandles{};
+  return sUniformHandles;
+}
+
+static std::unordered_map<GLuint, ShaderProgramUniforms> &getShaderProgramUniforms() {
+  static std::unordered_map<GLuint, ShaderProgramUniforms> sShaderProgramUniforms{};
+  return sShaderProgramUniforms;
+}
+
+static glengine::UniformCacheStats &getMutableUniformCacheStats() {
+  static glengine::UniformCacheStats sUniformCacheStats{};
+  return sUniformCacheStats;
+}
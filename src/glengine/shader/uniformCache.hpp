@@ -0,0 +1,42 @@
+#ifndef GLENGINE_SHADER_UNIFORMCACHE_HPP
+#define GLENGINE_SHADER_UNIFORMCACHE_HPP
+
+// STD
+#include <cstddef>
+#include <string>
+
+// OpenGL
+#include <glad/glad.h>
+
+namespace glengine {
+
+// Uniform handle (index of uniform name in the global uniform name registry)
+using UniformHandle = size_t;
+
+// Uniform cache statistics struct
+struct UniformCacheStats {
+  size_t skippedLookupCount{};     // glGetUniformLocation calls replaced by cached locations
+  size_t reflectedProgramCount{};  // shader programs (re)queried for active uniforms
+};
+
+// Registers uniform name and returns its handle (the same name always gets the same handle)
+UniformHandle registerUniform(const std::string &name);
+
+// Queries active uniforms of linked shader program once and caches their locations
+void reflectShaderProgram(GLuint shaderProgram);
+
+// Removes cached uniform locations of shader program
+void forgetShaderProgram(GLuint shaderProgram);
+
+// Gets cached uniform location of shader program by uniform handle (-1 if uniform is not active)
+GLint getUniformLocation(GLuint shaderProgram, UniformHandle handle);
+
+// Gets uniform cache statistics gathered since the last reset
+const UniformCacheStats &getUniformCacheStats() noexcept;
+
+// Resets uniform cache statistics (must be called once per frame)
+void resetUniformCacheStats() noexcept;
+
+}  // namespace glengine
+
+#endif